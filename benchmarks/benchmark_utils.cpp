@@ -0,0 +1,82 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "benchmark_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Each block starts with a header holding its size so that frees can be accounted for too
+namespace {
+std::atomic<uint64_t> allocation_count{0};
+std::atomic<int64_t> live_bytes{0};
+std::atomic<int64_t> peak_live_bytes{0};
+const size_t kHeaderSize = alignof(std::max_align_t);
+
+void *TrackedAlloc(size_t size) {
+    void *block = malloc(size + kHeaderSize);
+    if (!block) return nullptr;
+    *static_cast<size_t *>(block) = size;
+    ++allocation_count;
+    const int64_t live = live_bytes += static_cast<int64_t>(size);
+    int64_t peak = peak_live_bytes.load();
+    while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live)) {
+    }
+    return static_cast<char *>(block) + kHeaderSize;
+}
+
+void TrackedFree(void *ptr) {
+    if (!ptr) return;
+    void *block = static_cast<char *>(ptr) - kHeaderSize;
+    live_bytes -= static_cast<int64_t>(*static_cast<size_t *>(block));
+    free(block);
+}
+
+void *TrackedNew(size_t size) {
+    void *ptr = TrackedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+}  // namespace
+
+void *operator new(size_t size) { return TrackedNew(size); }
+void *operator new[](size_t size) { return TrackedNew(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return TrackedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return TrackedAlloc(size); }
+void operator delete(void *ptr) noexcept { TrackedFree(ptr); }
+void operator delete[](void *ptr) noexcept { TrackedFree(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { TrackedFree(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { TrackedFree(ptr); }
+
+uint64_t HeapAllocationCount() { return allocation_count; }
+int64_t HeapLiveBytes() { return live_bytes; }
+int64_t HeapPeakLiveBytes() { return peak_live_bytes; }
+
+void PrintBenchmarkPhases(const std::vector<const BenchmarkPhase *> &phases) {
+    printf("%-36s %10s %12s %12s %14s\n", "phase", "calls", "total ms", "us/call", "allocs/call");
+    for (const BenchmarkPhase *phase : phases) {
+        const double total_us = std::chrono::duration<double, std::micro>(phase->time).count();
+        const double calls = static_cast<double>(std::max<uint64_t>(phase->calls, 1));
+        printf("%-36s %10llu %12.3f %12.3f %14.1f\n", phase->name, static_cast<unsigned long long>(phase->calls),
+               total_us / 1000.0, total_us / calls, phase->allocations / calls);
+    }
+}
@@ -0,0 +1,52 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Heap accounting shared by the benchmarks. benchmark_utils.cpp replaces the global operator new and delete, so every
+// allocation of the process is counted, including those made by the layer code and SPIRV-Tools.
+uint64_t HeapAllocationCount();
+int64_t HeapLiveBytes();
+int64_t HeapPeakLiveBytes();
+
+// Time and allocations of one part of a benchmark, accumulated over all the calls measured
+struct BenchmarkPhase {
+    using Clock = std::chrono::high_resolution_clock;
+
+    const char *name;
+    Clock::duration time{};
+    uint64_t calls = 0;
+    uint64_t allocations = 0;
+
+    explicit BenchmarkPhase(const char *name) : name(name) {}
+
+    template <typename Func>
+    void Measure(Func &&func) {
+        const uint64_t allocations_before = HeapAllocationCount();
+        const auto start = Clock::now();
+        func();
+        time += Clock::now() - start;
+        allocations += HeapAllocationCount() - allocations_before;
+        ++calls;
+    }
+};
+
+void PrintBenchmarkPhases(const std::vector<const BenchmarkPhase *> &phases);
@@ -0,0 +1,165 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures core validation of command buffers recorded from several threads at once, each thread recording its own command
+// buffer from its own pool, with the validation object lock and with VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING. The hooks
+// are called the way the chassis calls them: vkBegin/EndCommandBuffer under the object lock, and the dynamic state vkCmd*
+// calls recorded in between under cb_read_lock and cb_write_lock.
+//
+// Usage: vk_command_buffer_recording_benchmark [recordings per thread] [commands per recording]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "core_validation.h"
+
+namespace {
+// The PostCallRecord hooks of the recorded commands are empty in core validation, but the chassis still takes the lock for them
+template <typename Validate, typename Record>
+bool RecordCmd(CoreChecks &core, VkCommandBuffer command_buffer, const Validate &validate, const Record &record) {
+    bool skip = false;
+    {
+        auto lock = core.cb_read_lock(command_buffer);
+        skip = validate(static_cast<const CoreChecks &>(core));
+    }
+    if (skip) return true;
+    {
+        auto lock = core.cb_write_lock(command_buffer);
+        record(core);
+    }
+    {
+        auto lock = core.cb_write_lock(command_buffer);
+    }
+    return false;
+}
+
+uint64_t RecordCommandBuffer(CoreChecks &core, VkCommandBuffer cb, uint32_t command_count) {
+    const VkCommandBufferBeginInfo begin_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    const VkViewport viewport = {0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f};
+    const VkRect2D scissor = {{0, 0}, {64, 64}};
+    const float blend_constants[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    uint64_t skips = 0;
+    {
+        auto lock = core.read_lock();
+        skips += core.PreCallValidateBeginCommandBuffer(cb, &begin_info);
+    }
+    {
+        auto lock = core.write_lock();
+        core.PreCallRecordBeginCommandBuffer(cb, &begin_info);
+    }
+    {
+        auto lock = core.write_lock();
+        core.PostCallRecordBeginCommandBuffer(cb, &begin_info, VK_SUCCESS);
+    }
+    for (uint32_t i = 0; i < command_count; i += 4) {
+        skips += RecordCmd(core, cb, [&](const CoreChecks &c) { return c.PreCallValidateCmdSetViewport(cb, 0, 1, &viewport); },
+                           [&](CoreChecks &c) { c.PreCallRecordCmdSetViewport(cb, 0, 1, &viewport); });
+        skips += RecordCmd(core, cb, [&](const CoreChecks &c) { return c.PreCallValidateCmdSetScissor(cb, 0, 1, &scissor); },
+                           [&](CoreChecks &c) { c.PreCallRecordCmdSetScissor(cb, 0, 1, &scissor); });
+        skips += RecordCmd(core, cb, [&](const CoreChecks &c) { return c.PreCallValidateCmdSetLineWidth(cb, 1.0f); },
+                           [&](CoreChecks &c) { c.PreCallRecordCmdSetLineWidth(cb, 1.0f); });
+        skips += RecordCmd(
+            core, cb, [&](const CoreChecks &c) { return c.PreCallValidateCmdSetBlendConstants(cb, blend_constants); },
+            [&](CoreChecks &c) { c.PreCallRecordCmdSetBlendConstants(cb, blend_constants); });
+    }
+    {
+        auto lock = core.read_lock();
+        skips += core.PreCallValidateEndCommandBuffer(cb);
+    }
+    {
+        auto lock = core.write_lock();
+        core.PreCallRecordEndCommandBuffer(cb);
+    }
+    {
+        auto lock = core.write_lock();
+        core.PostCallRecordEndCommandBuffer(cb, VK_SUCCESS);
+    }
+    return skips;
+}
+
+void Run(bool use_fine_grained_locking, uint32_t thread_count, uint32_t recordings_per_thread, uint32_t command_count) {
+    debug_report_data report_data;
+    PHYSICAL_DEVICE_STATE physical_device_state;
+    physical_device_state.queue_family_properties.push_back({VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 1, 0, {1, 1, 1}});
+
+    CoreChecks core;
+    core.report_data = &report_data;
+    core.device = reinterpret_cast<VkDevice>(static_cast<uintptr_t>(0x1000));
+    core.physical_device_state = &physical_device_state;
+    core.physical_device_count = 1;
+    core.enabled[fine_grained_locking] = use_fine_grained_locking;
+
+    // Each thread gets a pool of its own, as pools are externally synchronized
+    std::vector<VkCommandBuffer> command_buffers;
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        const VkCommandPoolCreateInfo pool_ci = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr,
+                                                 VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, 0};
+        VkCommandPool pool = reinterpret_cast<VkCommandPool>(static_cast<uintptr_t>(0x10000 + t));
+        core.PostCallRecordCreateCommandPool(core.device, &pool_ci, nullptr, &pool, VK_SUCCESS);
+        const VkCommandBufferAllocateInfo alloc_info = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, nullptr, pool,
+                                                        VK_COMMAND_BUFFER_LEVEL_PRIMARY, 1};
+        VkCommandBuffer command_buffer = reinterpret_cast<VkCommandBuffer>(static_cast<uintptr_t>(0x20000 + t));
+        core.PostCallRecordAllocateCommandBuffers(core.device, &alloc_info, &command_buffer, VK_SUCCESS);
+        command_buffers.push_back(command_buffer);
+    }
+
+    std::vector<uint64_t> skips(thread_count, 0);
+    BenchmarkPhase phase{"recording"};
+    phase.Measure([&]() {
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t recording = 0; recording < recordings_per_thread; ++recording) {
+                    skips[t] += RecordCommandBuffer(core, command_buffers[t], command_count);
+                }
+            });
+        }
+        for (auto &thread : threads) thread.join();
+    });
+
+    uint64_t skip_count = 0;
+    for (auto skip : skips) skip_count += skip;
+    const uint64_t commands = static_cast<uint64_t>(thread_count) * recordings_per_thread * (command_count + 2);
+    const double seconds = std::chrono::duration<double>(phase.time).count();
+    printf("%-13s %2u threads: %8.3f us per command, %6.2f M commands/s, %llu skipped\n",
+           use_fine_grained_locking ? "fine grained" : "object lock", thread_count, seconds * 1e6 / commands,
+           commands / seconds / 1e6, static_cast<unsigned long long>(skip_count));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const uint32_t recordings_per_thread = argc > 1 ? std::max(atoi(argv[1]), 1) : 200;
+    // Recorded four commands at a time
+    const uint32_t command_count = argc > 2 ? (std::max(atoi(argv[2]), 4) + 3) / 4 * 4 : 1000;
+    printf("%u recordings per thread, %u commands per recording\n\n", recordings_per_thread, command_count);
+
+    std::vector<uint32_t> thread_counts = {1, 2, 4, 8};
+    if (std::thread::hardware_concurrency() > 8) thread_counts.push_back(std::thread::hardware_concurrency());
+    for (bool use_fine_grained_locking : {false, true}) {
+        for (uint32_t thread_count : thread_counts) {
+            Run(use_fine_grained_locking, thread_count, recordings_per_thread, command_count);
+        }
+        printf("\n");
+    }
+    return 0;
+}
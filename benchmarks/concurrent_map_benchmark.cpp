@@ -0,0 +1,89 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Compares vl_concurrent_flat_map against vl_concurrent_unordered_map for the way dispatch unwraps handles: each thread
+// owns a range of handles that it creates and destroys, while looking up handles from a shared, long lived set. Mostly
+// lookups, with some object churn.
+//
+// Usage: vk_concurrent_map_benchmark [operations per thread]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "vk_layer_utils.h"
+
+namespace {
+const uint64_t kSharedCount = 10000;
+
+template <typename Map>
+uint64_t RunThreads(uint32_t thread_count, uint64_t ops_per_thread) {
+    Map map;
+    for (uint64_t key = 1; key <= kSharedCount; ++key) {
+        map.insert_or_assign(key, key);
+    }
+    std::atomic<uint64_t> misses(0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&map, &misses, t, ops_per_thread]() {
+            const uint64_t own_base = (uint64_t(t) + 1) << 32;
+            uint64_t created = 0;
+            uint64_t destroyed = 0;
+            for (uint64_t op = 0; op < ops_per_thread; ++op) {
+                const uint32_t kind = op % 20;
+                if (kind == 0) {
+                    ++created;
+                    map.insert(own_base + created, created);
+                } else if (kind == 1 && destroyed < created) {
+                    ++destroyed;
+                    map.erase(own_base + destroyed);
+                } else if (map.find((op * 7919) % kSharedCount + 1) == map.end()) {
+                    misses.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    return misses;
+}
+
+template <typename Map>
+void Run(const char *name, uint32_t thread_count, uint64_t ops_per_thread) {
+    BenchmarkPhase phase{name};
+    uint64_t misses = 0;
+    phase.Measure([&]() { misses = RunThreads<Map>(thread_count, ops_per_thread); });
+    const double seconds = std::chrono::duration<double>(phase.time).count();
+    printf("%-28s %2u threads: %8.1f Mops/s, %llu allocations, %llu misses\n", name, thread_count,
+           thread_count * ops_per_thread / seconds / 1e6, static_cast<unsigned long long>(phase.allocations),
+           static_cast<unsigned long long>(misses));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const uint64_t ops_per_thread = argc > 1 ? std::max(atoi(argv[1]), 1) : 400000;
+    printf("%llu operations per thread\n\n", static_cast<unsigned long long>(ops_per_thread));
+    for (uint32_t thread_count : {1u, 4u, 16u}) {
+        Run<vl_concurrent_unordered_map<uint64_t, uint64_t, 4>>("vl_concurrent_unordered_map", thread_count, ops_per_thread);
+        Run<vl_concurrent_flat_map<uint64_t, uint64_t>>("vl_concurrent_flat_map", thread_count, ops_per_thread);
+    }
+    return 0;
+}
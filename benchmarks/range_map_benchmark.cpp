@@ -0,0 +1,174 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Compares the std::map and flat_btree_map backends of sparse_container::range_map, holding ResourceAccessStates the way
+// synchronization validation does. Each access walks the entries of its range as hazard detection does, then splits and
+// infills them as UpdateMemoryAccessState does; every few accesses all entries are visited, as when global barriers are
+// applied, and the map is copied once at the end, as AccessContexts are for subpasses.
+//
+// The accesses are read from a trace file with one "begin end" address range per line, or, without one, generated the same
+// way as the draws of vk_sync_validation_benchmark.
+//
+// Usage: vk_range_map_benchmark [trace file | accesses [buffers]]
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "synchronization_validation.h"
+
+namespace {
+const VkDeviceSize kBufferSize = 64 * 1024;
+const VkDeviceSize kSliceSize = 256;
+const uint32_t kAccessesPerFullWalk = 64;
+
+using StdAccessMap = sparse_container::range_map<VkDeviceSize, ResourceAccessState>;
+using FlatAccessMap = sparse_container::flat_range_map<VkDeviceSize, ResourceAccessState>;
+
+bool ReadTrace(const char *path, std::vector<ResourceAccessRange> *trace) {
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+    unsigned long long begin = 0;
+    unsigned long long end = 0;
+    while (fscanf(file, "%llu %llu", &begin, &end) == 2) {
+        if (begin < end) trace->emplace_back(begin, end);
+    }
+    fclose(file);
+    return true;
+}
+
+// Vertex, index and uniform slices as the synthetic frame of vk_sync_validation_benchmark accesses them
+std::vector<ResourceAccessRange> SyntheticTrace(uint32_t access_count, uint32_t buffer_count) {
+    std::vector<ResourceAccessRange> trace;
+    trace.reserve(access_count);
+    const uint32_t geometry_buffer_count = buffer_count - 1;
+    for (uint32_t draw = 0; trace.size() < access_count; ++draw) {
+        const VkDeviceSize slice_offset = (draw * kSliceSize) % kBufferSize;
+        const VkDeviceSize buffers[] = {(2 * draw) % geometry_buffer_count, (2 * draw + 1) % geometry_buffer_count,
+                                        geometry_buffer_count};
+        for (const auto buffer : buffers) {
+            const VkDeviceSize begin = buffer * kBufferSize + slice_offset;
+            trace.emplace_back(begin, begin + kSliceSize);
+        }
+    }
+    trace.resize(access_count);
+    return trace;
+}
+
+template <typename Map>
+HazardResult DetectRange(const Map &accesses, const ResourceAccessRange &range, SyncStageAccessIndex usage) {
+    HazardResult hazard;
+    const auto to = accesses.upper_bound(range);
+    for (auto pos = accesses.lower_bound(range); pos != to && !hazard.hazard; ++pos) {
+        hazard = pos->second.DetectHazard(usage);
+    }
+    return hazard;
+}
+
+template <typename Map>
+void UpdateRange(Map *accesses, const ResourceAccessRange &range, SyncStageAccessIndex usage, const ResourceUsageTag &tag) {
+    auto pos = accesses->lower_bound(range);
+    if (pos != accesses->end() && pos->first.begin < range.begin) {
+        pos = accesses->split(pos, range.begin, sparse_container::split_op_keep_both());
+        ++pos;
+    }
+    VkDeviceSize begin = range.begin;
+    while (begin < range.end) {
+        if (pos == accesses->end() || pos->first.begin > begin) {
+            // Infill the gap up to the next entry, or the end of the range
+            const VkDeviceSize gap_end = (pos == accesses->end()) ? range.end : std::min(range.end, pos->first.begin);
+            pos = accesses->insert(pos, std::make_pair(ResourceAccessRange(begin, gap_end), ResourceAccessState()));
+        } else if (pos->first.end > range.end) {
+            pos = accesses->split(pos, range.end, sparse_container::split_op_keep_both());
+        }
+        pos->second.Update(usage, tag);
+        begin = pos->first.end;
+        ++pos;
+    }
+}
+
+struct MapResults {
+    BenchmarkPhase accesses{"accesses"};
+    BenchmarkPhase full_walks{"full walks"};
+    BenchmarkPhase copies{"copies"};
+    size_t entries = 0;
+    int64_t bytes = 0;
+    uint64_t hazards = 0;
+};
+
+template <typename Map>
+void Replay(const std::vector<ResourceAccessRange> &trace, MapResults *results) {
+    const int64_t live_bytes_before = HeapLiveBytes();
+    Map map;
+    ResourceUsageTag tag(0, CMD_DRAWINDEXED);
+    for (size_t index = 0; index < trace.size(); ++index) {
+        const auto &range = trace[index];
+        // Mostly reads, with the occasional transfer write, as in a frame of draws
+        const auto usage = (index % 16 == 0) ? SYNC_TRANSFER_TRANSFER_WRITE : SYNC_VERTEX_INPUT_VERTEX_ATTRIBUTE_READ;
+        results->accesses.Measure([&]() {
+            results->hazards += DetectRange(map, range, usage).hazard != NONE;
+            UpdateRange(&map, range, usage, ++tag);
+        });
+        if ((index + 1) % kAccessesPerFullWalk == 0) {
+            results->full_walks.Measure([&]() {
+                for (auto &entry : map) {
+                    entry.second.ApplyExecutionBarrier(~VkPipelineStageFlags(0), ~VkPipelineStageFlags(0));
+                }
+            });
+        }
+    }
+    results->entries = map.size();
+    results->bytes = HeapLiveBytes() - live_bytes_before;
+    results->copies.Measure([&]() { Map copy(map); });
+}
+
+void PrintResults(const char *name, const MapResults &results) {
+    printf("%s: %zu entries, %.1f KiB, %llu hazards\n", name, results.entries, results.bytes / 1024.0,
+           static_cast<unsigned long long>(results.hazards));
+    PrintBenchmarkPhases({&results.accesses, &results.full_walks, &results.copies});
+    printf("\n");
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    std::vector<ResourceAccessRange> trace;
+    if (argc > 1 && !isdigit(static_cast<unsigned char>(argv[1][0]))) {
+        if (!ReadTrace(argv[1], &trace) || trace.empty()) {
+            printf("No accesses read from %s\n", argv[1]);
+            return 1;
+        }
+        printf("%zu accesses from %s\n\n", trace.size(), argv[1]);
+    } else {
+        const uint32_t access_count = argc > 1 ? std::max(atoi(argv[1]), 1) : 150000;
+        const uint32_t buffer_count = argc > 2 ? std::max(atoi(argv[2]), 3) : 1024;
+        trace = SyntheticTrace(access_count, buffer_count);
+        printf("%u synthetic accesses over %u buffers\n\n", access_count, buffer_count);
+    }
+
+    MapResults std_results;
+    Replay<StdAccessMap>(trace, &std_results);
+    PrintResults("std::map", std_results);
+
+    MapResults flat_results;
+    Replay<FlatAccessMap>(trace, &flat_results);
+    PrintResults("flat_btree_map", flat_results);
+    return 0;
+}
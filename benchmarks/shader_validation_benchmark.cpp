@@ -0,0 +1,186 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures the CPU cost of the shader handling in shader_validation.cpp over a directory of SPIR-V files, without a loader or
+// a Vulkan device: spirv-val as run at vkCreateShaderModule, SHADER_MODULE_STATE creation, the per-entrypoint analyses done at
+// pipeline creation and the validation cache. Each phase reports its time and heap allocations, and the run reports the peak
+// heap size.
+//
+// Usage: vk_shader_validation_benchmark <directory of .spv files> [iterations]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
+#include "benchmark_utils.h"
+#include "cast_utils.h"
+#include "shader_validation.h"
+#include "spirv-tools/libspirv.h"
+
+namespace {
+std::vector<std::string> ListSpirvFiles(const std::string &directory) {
+    std::vector<std::string> files;
+    auto is_spirv_file = [](const std::string &name) { return name.size() > 4 && name.compare(name.size() - 4, 4, ".spv") == 0; };
+#ifdef _WIN32
+    WIN32_FIND_DATAA find_data;
+    HANDLE find = FindFirstFileA((directory + "\\*.spv").c_str(), &find_data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (is_spirv_file(find_data.cFileName)) files.push_back(directory + "\\" + find_data.cFileName);
+        } while (FindNextFileA(find, &find_data));
+        FindClose(find);
+    }
+#else
+    DIR *dir = opendir(directory.c_str());
+    if (dir) {
+        while (const dirent *entry = readdir(dir)) {
+            if (is_spirv_file(entry->d_name)) files.push_back(directory + "/" + entry->d_name);
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+bool ReadSpirvFile(const std::string &path, std::vector<uint32_t> *words) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    const auto size = static_cast<size_t>(file.tellg());
+    if (size < 5 * sizeof(uint32_t) || size % sizeof(uint32_t) != 0) return false;
+    words->resize(size / sizeof(uint32_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(words->data()), size);
+    return (*words)[0] == spv::MagicNumber;
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("Usage: %s <directory of .spv files> [iterations]\n", argv[0]);
+        return 1;
+    }
+    const uint32_t iterations = argc > 2 ? std::max(atoi(argv[2]), 1) : 1;
+
+    std::vector<std::vector<uint32_t>> corpus;
+    for (const auto &path : ListSpirvFiles(argv[1])) {
+        std::vector<uint32_t> words;
+        if (ReadSpirvFile(path, &words)) {
+            corpus.emplace_back(std::move(words));
+        } else {
+            printf("Skipping %s, not a SPIR-V module\n", path.c_str());
+        }
+    }
+    if (corpus.empty()) {
+        printf("No SPIR-V modules found in %s\n", argv[1]);
+        return 1;
+    }
+
+    const spv_target_env spirv_environment = PickSpirvEnv(VK_API_VERSION_1_2, true);
+    spv_context ctx = spvContextCreate(spirv_environment);
+    spv_validator_options options = spvValidatorOptionsCreate();
+
+    VkValidationCacheCreateInfoEXT cache_ci = {VK_STRUCTURE_TYPE_VALIDATION_CACHE_CREATE_INFO_EXT};
+    std::unique_ptr<ValidationCache> validation_cache(CastFromHandle<ValidationCache *>(ValidationCache::Create(&cache_ci)));
+
+    BenchmarkPhase spirv_val("spirv-val");
+    BenchmarkPhase module_state("SHADER_MODULE_STATE");
+    BenchmarkPhase mark_accessible_ids("MarkAccessibleIds");
+    BenchmarkPhase descriptor_slots("CollectInterfaceByDescriptorSlot");
+    BenchmarkPhase reflection_build("GetEntryPointReflection, first");
+    BenchmarkPhase reflection_lookup("GetEntryPointReflection, cached");
+    BenchmarkPhase cache_lookup("ValidationCache lookup");
+    BenchmarkPhase cache_round_trip("ValidationCache write and load");
+    uint32_t invalid_modules = 0;
+    int64_t module_bytes = 0;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        std::vector<std::shared_ptr<SHADER_MODULE_STATE>> modules;
+        const int64_t live_bytes_before = HeapLiveBytes();
+        for (const auto &words : corpus) {
+            VkShaderModuleCreateInfo module_ci = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, nullptr, 0,
+                                                  words.size() * sizeof(uint32_t), words.data()};
+
+            bool cached = false;
+            cache_lookup.Measure([&]() { cached = validation_cache->Contains(ValidationCache::MakeShaderHash(&module_ci)); });
+
+            spv_result_t result = SPV_SUCCESS;
+            if (!cached) {
+                spirv_val.Measure([&]() {
+                    spv_const_binary_t binary{words.data(), words.size()};
+                    spv_diagnostic diag = nullptr;
+                    result = spvValidateWithOptions(ctx, options, &binary, &diag);
+                    spvDiagnosticDestroy(diag);
+                });
+                if (result != SPV_SUCCESS) {
+                    if (iteration == 0) ++invalid_modules;
+                    continue;
+                }
+                validation_cache->Insert(ValidationCache::MakeShaderHash(&module_ci));
+            }
+
+            std::shared_ptr<SHADER_MODULE_STATE> module;
+            module_state.Measure(
+                [&]() { module = std::make_shared<SHADER_MODULE_STATE>(&module_ci, VK_NULL_HANDLE, spirv_environment, 0); });
+
+            for (const auto &entry_point : module->entry_points) {
+                const auto entrypoint = module->at(entry_point.second.offset);
+                std::unordered_set<uint32_t> accessible_ids;
+                mark_accessible_ids.Measure([&]() { accessible_ids = MarkAccessibleIds(module.get(), entrypoint); });
+                descriptor_slots.Measure([&]() {
+                    bool has_writable_descriptor = false;
+                    CollectInterfaceByDescriptorSlot(module.get(), accessible_ids, &has_writable_descriptor);
+                });
+                reflection_build.Measure([&]() { module->GetEntryPointReflection(entrypoint); });
+                reflection_lookup.Measure([&]() { module->GetEntryPointReflection(entrypoint); });
+            }
+            modules.emplace_back(std::move(module));
+        }
+        module_bytes = HeapLiveBytes() - live_bytes_before;
+
+        cache_round_trip.Measure([&]() {
+            size_t size = 0;
+            validation_cache->Write(&size, nullptr);
+            std::vector<uint8_t> data(size);
+            validation_cache->Write(&size, data.data());
+            VkValidationCacheCreateInfoEXT load_ci = {VK_STRUCTURE_TYPE_VALIDATION_CACHE_CREATE_INFO_EXT, nullptr, 0, size,
+                                                      data.data()};
+            delete CastFromHandle<ValidationCache *>(ValidationCache::Create(&load_ci));
+        });
+    }
+
+    spvValidatorOptionsDestroy(options);
+    spvContextDestroy(ctx);
+
+    printf("%zu modules (%u invalid), %u iteration(s)\n\n", corpus.size(), invalid_modules, iterations);
+    PrintBenchmarkPhases({&cache_lookup, &spirv_val, &module_state, &mark_accessible_ids, &descriptor_slots, &reflection_build,
+                          &reflection_lookup, &cache_round_trip});
+    printf("\nHeap held by the modules of one iteration: %.1f KiB\n", module_bytes / 1024.0);
+    printf("Peak heap: %.1f KiB\n", HeapPeakLiveBytes() / 1024.0);
+    return 0;
+}
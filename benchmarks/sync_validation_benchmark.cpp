@@ -0,0 +1,150 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures the time and memory of synchronization validation's access tracking for a synthetic frame, without a loader or a
+// Vulkan device. Each draw reads a slice of a vertex and an index buffer and a uniform ring buffer slot from two stages, the
+// way SyncValidator records draws; every few draws a transfer rewrites a uniform slot and every few more a full memory
+// barrier is recorded. Now and then a transfer rewrites a whole geometry buffer, as uploads do. Global barriers are applied
+// lazily, so their cost shows up in the accesses that follow them. All accesses go through AccessContext, so the cost of
+// ResourceAccessRangeMap splits and ResourceAccessState copies is what is measured.
+//
+// Usage: vk_sync_validation_benchmark [draws per frame] [buffers] [frames]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "synchronization_validation.h"
+
+namespace {
+const VkDeviceSize kBufferSize = 64 * 1024;
+const VkDeviceSize kSliceSize = 256;
+const uint32_t kDrawsPerUniformUpdate = 8;
+const uint32_t kDrawsPerBarrier = 64;
+const uint32_t kDrawsPerUpload = 256;
+
+// A full memory barrier, as SyncValidator records vkCmdPipelineBarrier with every stage and access in both scopes
+SyncGlobalBarrier FullBarrier() {
+    SyncBarrier memory_barrier;
+    memory_barrier.src_exec_scope = ~VkPipelineStageFlags(0);
+    memory_barrier.src_access_scope = ~SyncStageAccessFlags(0);
+    memory_barrier.dst_exec_scope = ~VkPipelineStageFlags(0);
+    memory_barrier.dst_access_scope = ~SyncStageAccessFlags(0);
+    return SyncGlobalBarrier{memory_barrier.src_exec_scope, memory_barrier.dst_exec_scope, {memory_barrier}};
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const uint32_t draw_count = argc > 1 ? std::max(atoi(argv[1]), 1) : 50000;
+    const uint32_t buffer_count = argc > 2 ? std::max(atoi(argv[2]), 3) : 1024;
+    const uint32_t frame_count = argc > 3 ? std::max(atoi(argv[3]), 1) : 1;
+
+    // All buffers are bound back to back to a single allocation, so their ranges are adjacent in the linear address map
+    VkMemoryAllocateInfo alloc_info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, buffer_count * kBufferSize, 0};
+    auto memory = std::make_shared<DEVICE_MEMORY_STATE>(nullptr, VK_NULL_HANDLE, &alloc_info, 0);
+    VkBufferCreateInfo buffer_ci = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    buffer_ci.size = kBufferSize;
+    std::vector<std::unique_ptr<BUFFER_STATE>> buffers;
+    for (uint32_t i = 0; i < buffer_count; ++i) {
+        buffers.emplace_back(new BUFFER_STATE(VK_NULL_HANDLE, &buffer_ci));
+        buffers.back()->binding = {memory, i * kBufferSize, kBufferSize};
+    }
+    // The last buffer is the uniform ring, the others are split between vertex and index data
+    const BUFFER_STATE &uniforms = *buffers.back();
+    const uint32_t geometry_buffer_count = buffer_count - 1;
+
+    BenchmarkPhase draws("draws");
+    BenchmarkPhase uniform_updates("uniform updates");
+    BenchmarkPhase barriers("full barriers");
+    BenchmarkPhase uploads("full buffer uploads");
+    BenchmarkPhase frame_copies("AccessContext copies");
+    BenchmarkPhase proxy_copies("copy-on-write proxies");
+    uint64_t hazard_count = 0;
+    size_t map_entries = 0;
+    int64_t context_bytes = 0;
+    ResourceUsageTag tag(0, CMD_DRAWINDEXED);
+
+    for (uint32_t frame = 0; frame < frame_count; ++frame) {
+        const int64_t live_bytes_before = HeapLiveBytes();
+        std::unique_ptr<AccessContext> context(new AccessContext());
+        for (uint32_t draw = 0; draw < draw_count; ++draw) {
+            const BUFFER_STATE &vertices = *buffers[(2 * draw) % geometry_buffer_count];
+            const BUFFER_STATE &indices = *buffers[(2 * draw + 1) % geometry_buffer_count];
+            const VkDeviceSize slice_offset = (draw * kSliceSize) % kBufferSize;
+            const ResourceAccessRange slice(slice_offset, slice_offset + kSliceSize);
+
+            if (draw % kDrawsPerUniformUpdate == 0) {
+                uniform_updates.Measure([&]() {
+                    hazard_count += context->DetectHazard(uniforms, SYNC_TRANSFER_TRANSFER_WRITE, slice).hazard != NONE;
+                    context->UpdateAccessState(uniforms, SYNC_TRANSFER_TRANSFER_WRITE, slice, ++tag);
+                });
+            }
+
+            draws.Measure([&]() {
+                const std::pair<const BUFFER_STATE *, SyncStageAccessIndex> accesses[] = {
+                    {&vertices, SYNC_VERTEX_INPUT_VERTEX_ATTRIBUTE_READ},
+                    {&indices, SYNC_VERTEX_INPUT_INDEX_READ},
+                    {&uniforms, SYNC_VERTEX_SHADER_UNIFORM_READ},
+                    {&uniforms, SYNC_FRAGMENT_SHADER_UNIFORM_READ}};
+                ++tag;
+                for (const auto &access : accesses) {
+                    hazard_count += context->DetectHazard(*access.first, access.second, slice).hazard != NONE;
+                }
+                for (const auto &access : accesses) {
+                    context->UpdateAccessState(*access.first, access.second, slice, tag);
+                }
+            });
+
+            if ((draw + 1) % kDrawsPerBarrier == 0) {
+                barriers.Measure([&]() { context->ApplyGlobalBarrier(FullBarrier()); });
+            }
+
+            if ((draw + 1) % kDrawsPerUpload == 0) {
+                // Overwrites every slice the draws have split the buffer into
+                const ResourceAccessRange whole_buffer(0, kBufferSize);
+                uploads.Measure([&]() {
+                    hazard_count += context->DetectHazard(vertices, SYNC_TRANSFER_TRANSFER_WRITE, whole_buffer).hazard != NONE;
+                    context->UpdateAccessState(vertices, SYNC_TRANSFER_TRANSFER_WRITE, whole_buffer, ++tag);
+                });
+            }
+        }
+        map_entries = context->GetLinearMap().size();
+        context_bytes = HeapLiveBytes() - live_bytes_before;
+
+        // Contexts are copied wholesale, e.g. for render pass subpasses
+        frame_copies.Measure([&]() { AccessContext copy(*context); });
+
+        // Store and resolve validation proxies only copy in the ranges they update
+        proxy_copies.Measure([&]() {
+            AccessContext proxy(*context, AccessContext::CopyOnWrite());
+            proxy.UpdateAccessState(uniforms, SYNC_TRANSFER_TRANSFER_WRITE, ResourceAccessRange(0, kSliceSize), ++tag);
+        });
+    }
+
+    printf("%u draws per frame over %u buffers, %u frame(s), %llu hazards\n\n", draw_count, buffer_count, frame_count,
+           static_cast<unsigned long long>(hazard_count));
+    PrintBenchmarkPhases({&draws, &uniform_updates, &barriers, &uploads, &frame_copies, &proxy_copies});
+    printf("\nsizeof(ResourceAccessState): %zu bytes\n", sizeof(ResourceAccessState));
+    printf("Linear map entries at the end of a frame: %zu\n", map_entries);
+    printf("Heap held by the access context of a frame: %.1f KiB\n", context_bytes / 1024.0);
+    printf("Peak heap: %.1f KiB\n", HeapPeakLiveBytes() / 1024.0);
+    return 0;
+}
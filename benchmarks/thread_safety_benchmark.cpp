@@ -0,0 +1,95 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Measures the thread safety layer's handling of a contended object: threads call StartWrite/FinishWrite on the same VkQueue,
+// the way the layer wraps vkQueueWaitIdle, with a little work in between. A debug utils callback skips every threading error,
+// so each collision makes the colliding thread wait for the object to become idle.
+//
+// Usage: vk_thread_safety_benchmark [calls per thread] [work iterations per call]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "benchmark_utils.h"
+#include "chassis.h"
+#include "thread_safety.h"
+
+namespace {
+VKAPI_ATTR VkBool32 VKAPI_CALL SkipThreadingErrors(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+                                                   VkDebugUtilsMessageTypeFlagsEXT messageTypes,
+                                                   const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData, void *pUserData) {
+    if (strstr(pCallbackData->pMessage, "THREADING ERROR") == nullptr) return VK_FALSE;
+    reinterpret_cast<std::atomic<uint64_t> *>(pUserData)->fetch_add(1);
+    return VK_TRUE;
+}
+
+void Run(uint32_t thread_count, uint32_t calls_per_thread, uint32_t work_iterations) {
+    std::atomic<uint64_t> collisions(0);
+    debug_report_data report_data;
+    auto messenger_create_info = lvl_init_struct<VkDebugUtilsMessengerCreateInfoEXT>();
+    messenger_create_info.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    messenger_create_info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT;
+    messenger_create_info.pfnUserCallback = SkipThreadingErrors;
+    messenger_create_info.pUserData = &collisions;
+    VkDebugUtilsMessengerEXT messenger = VK_NULL_HANDLE;
+    layer_create_messenger_callback(&report_data, false, &messenger_create_info, nullptr, &messenger);
+
+    ValidationObject validation_object;
+    validation_object.report_data = &report_data;
+    counter<VkQueue> queues("VkQueue", kVulkanObjectTypeQueue, &validation_object);
+    const VkQueue queue = reinterpret_cast<VkQueue>(static_cast<uintptr_t>(0x1000));
+    queues.CreateObject(queue);
+
+    BenchmarkPhase phase{"vkQueueWaitIdle"};
+    phase.Measure([&]() {
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&queues, queue, calls_per_thread, work_iterations]() {
+                volatile uint32_t work = 0;
+                for (uint32_t call = 0; call < calls_per_thread; ++call) {
+                    queues.StartWrite(queue, "vkQueueWaitIdle");
+                    for (uint32_t i = 0; i < work_iterations; ++i) work = work + 1;
+                    queues.FinishWrite(queue, "vkQueueWaitIdle");
+                }
+            });
+        }
+        for (auto &thread : threads) thread.join();
+    });
+    queues.DestroyObject(queue);
+
+    const uint64_t calls = static_cast<uint64_t>(thread_count) * calls_per_thread;
+    const double seconds = std::chrono::duration<double>(phase.time).count();
+    printf("%2u threads: %8.3f us per call, %llu collisions, %llu allocations\n", thread_count, seconds * 1e6 / calls,
+           static_cast<unsigned long long>(collisions.load()), static_cast<unsigned long long>(phase.allocations));
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+    const uint32_t calls_per_thread = argc > 1 ? std::max(atoi(argv[1]), 1) : 10000;
+    const uint32_t work_iterations = argc > 2 ? std::max(atoi(argv[2]), 0) : 1000;
+    printf("%u calls per thread, %u work iterations per call\n\n", calls_per_thread, work_iterations);
+    for (uint32_t thread_count : {1u, 2u, 4u, 8u}) {
+        Run(thread_count, calls_per_thread, work_iterations);
+    }
+    return 0;
+}
@@ -24,6 +24,7 @@ class CommandCounter : public ValidationObject {
     virtual ~CommandCounter() {}
 
     virtual write_lock_guard_t write_lock() { return coreChecks->write_lock(); }
+    virtual write_lock_guard_t cb_write_lock(VkCommandBuffer command_buffer) { return coreChecks->cb_write_lock(command_buffer); }
 
 #include "command_counter_helper.h"
 
@@ -1034,18 +1034,23 @@ bool CoreChecks::ValidateCmdBufDrawState(const CMD_BUFFER_STATE *cb_node, CMD_TY
                                                 binding_req_map.begin(), binding_req_map.end());
 
             if (need_validate) {
+                BindingReqMap delta_reqs;
+                const BindingReqMap *reqs = &binding_req_map;
                 if (!descriptor_set_changed && reduced_map.IsManyDescriptors()) {
                     // Only validate the bindings that haven't already been validated
-                    BindingReqMap delta_reqs;
                     std::set_difference(binding_req_map.begin(), binding_req_map.end(),
                                         state.per_set[setIndex].validated_set_binding_req_map.begin(),
                                         state.per_set[setIndex].validated_set_binding_req_map.end(),
                                         std::inserter(delta_reqs, delta_reqs.begin()));
-                    result |= ValidateDrawState(descriptor_set, delta_reqs, state.per_set[setIndex].dynamicOffsets, cb_node,
-                                                setIndex, function, vuid);
+                    reqs = &delta_reqs;
+                }
+                // Push descriptor sets are rewritten in place by later vkCmdPushDescriptorSet calls, so they can't wait
+                if (deferred_validation_pool && !descriptor_set->IsPushDescriptor()) {
+                    result |= DeferDrawState(descriptor_set, *reqs, state.per_set[setIndex].dynamicOffsets, cb_node, setIndex,
+                                             cmd_type, function);
                 } else {
-                    result |= ValidateDrawState(descriptor_set, binding_req_map, state.per_set[setIndex].dynamicOffsets, cb_node,
-                                                setIndex, function, vuid);
+                    result |= ValidateDrawState(descriptor_set, *reqs, state.per_set[setIndex].dynamicOffsets, cb_node, setIndex,
+                                                function, vuid);
                 }
             }
         }
@@ -1058,6 +1063,64 @@ bool CoreChecks::ValidateCmdBufDrawState(const CMD_BUFFER_STATE *cb_node, CMD_TY
     return result;
 }
 
+// Validate the bindings that depend on the command buffer's current image layouts now, and queue the rest. Queued checks
+// are validated on deferred_validation_pool a batch at a time, or at vkEndCommandBuffer for the final partial batch.
+// Errors they find are still reported against the draw that captured them, but can no longer skip that draw.
+bool CoreChecks::DeferDrawState(const cvdescriptorset::DescriptorSet *descriptor_set, const BindingReqMap &bindings,
+                                const std::vector<uint32_t> &dynamic_offsets, const CMD_BUFFER_STATE *cb_node, uint32_t setIndex,
+                                CMD_TYPE cmd_type, const char *function) const {
+    static const size_t kDeferredBatchSize = 64;
+
+    BindingReqMap immediate_bindings;
+    CMD_BUFFER_STATE::DeferredDrawValidation deferred = {descriptor_set, {}, dynamic_offsets, setIndex, cmd_type, function};
+    for (const auto &binding_pair : bindings) {
+        bool layout_dependent = false;
+        if (!disabled[image_layout_validation]) {
+            switch (descriptor_set->GetTypeFromBinding(binding_pair.first)) {
+                case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                    layout_dependent = true;
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (layout_dependent) {
+            immediate_bindings.emplace(binding_pair);
+        } else {
+            deferred.bindings.emplace(binding_pair);
+        }
+    }
+
+    bool skip = false;
+    if (!immediate_bindings.empty()) {
+        skip |= ValidateDrawState(descriptor_set, immediate_bindings, dynamic_offsets, cb_node, setIndex, function,
+                                  GetDrawDispatchVuid(cmd_type));
+    }
+    if (!deferred.bindings.empty()) {
+        auto &queued = cb_node->deferred_draw_validation;
+        queued.emplace_back(std::move(deferred));
+        if (queued.size() >= kDeferredBatchSize) {
+            auto batch = std::make_shared<std::vector<CMD_BUFFER_STATE::DeferredDrawValidation>>(std::move(queued));
+            queued.clear();
+            deferred_validation_pool->Submit([this, cb_node, batch]() { ValidateDeferredDrawState(cb_node, *batch); });
+        }
+    }
+    return skip;
+}
+
+bool CoreChecks::ValidateDeferredDrawState(const CMD_BUFFER_STATE *cb_node,
+                                           const std::vector<CMD_BUFFER_STATE::DeferredDrawValidation> &deferred) const {
+    bool skip = false;
+    for (const auto &draw : deferred) {
+        skip |= ValidateDrawState(draw.descriptor_set, draw.bindings, draw.dynamic_offsets, cb_node, draw.set_index,
+                                  draw.function, GetDrawDispatchVuid(draw.cmd_type));
+    }
+    return skip;
+}
+
 bool CoreChecks::ValidatePipelineLocked(std::vector<std::shared_ptr<PIPELINE_STATE>> const &pPipelines, int pipelineIndex) const {
     bool skip = false;
 
@@ -2080,11 +2143,47 @@ void CoreChecks::PostCallRecordCreateDevice(VkPhysicalDevice gpu, const VkDevice
         [core_checks](CMD_BUFFER_STATE *cb_node, const IMAGE_VIEW_STATE &iv_state, VkImageLayout layout) -> void {
             core_checks->SetImageViewInitialLayout(cb_node, iv_state, layout);
         });
+
+    if (core_checks->enabled[deferred_draw_validation] && core_checks->enabled[fine_grained_locking]) {
+        // The queued checks read descriptor set, buffer and image state, and are only drained by entry points taking the
+        // object lock. vkCmd* calls skip that lock with fine grained locking, so other threads could destroy or update the
+        // state while the checks run.
+        core_checks->enabled[deferred_draw_validation] = false;
+        core_checks->LogWarning(*pDevice, "UNASSIGNED-CoreValidation-DeferredDrawValidation-FineGrainedLocking",
+                                "VALIDATION_CHECK_ENABLE_DEFERRED_DRAW_VALIDATION can't be used with "
+                                "VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING. Draw-time descriptor checks are not deferred.");
+    }
+    if (core_checks->enabled[deferred_draw_validation]) {
+        core_checks->deferred_validation_pool.reset(new WorkerPool());
+    }
+    if (core_checks->enabled[parallel_pipeline_validation]) {
+        core_checks->pipeline_validation_pool.reset(new WorkerPool());
+    }
+    if (core_checks->enabled[background_shader_validation] && !core_checks->disabled[shader_validation]) {
+        core_checks->shader_module_validation_pool.reset(new WorkerPool());
+    }
+
+    // The environment variable takes precedence over the settings file
+    std::string validation_cache_path = GetLayerEnvVar("VK_LAYER_VALIDATION_CACHE_PATH");
+    if (validation_cache_path.empty()) validation_cache_path = getLayerOption("khronos_validation.validation_cache_path");
+    if (!validation_cache_path.empty() && !core_checks->disabled[shader_validation]) {
+        core_checks->layer_validation_cache_path = validation_cache_path;
+        core_checks->shader_device_state_hash = core_checks->MakeShaderDeviceStateHash();
+        core_checks->LoadLayerValidationCache();
+    }
 }
 
 void CoreChecks::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
     if (!device) return;
     imageLayoutMap.clear();
+    // Report what is left of the background shader module validation, which also lets it reach the cache before it is saved.
+    // Nothing can block the destruction of the device, so this is done here rather than in a validate hook, and is report only.
+    if (shader_module_validation_pool) {
+        for (const auto &entry : shaderModuleMap.snapshot()) {
+            ValidateDeferredShaderModule(entry.second.get());
+        }
+    }
+    if (layer_validation_cache) SaveLayerValidationCache();
 
     StateTracker::PreCallRecordDestroyDevice(device, pAllocator);
 }
@@ -2320,6 +2419,8 @@ bool CoreChecks::ValidatePrimaryCommandBufferState(const CMD_BUFFER_STATE *pCB,
     } else {
         for (auto pSubCB : pCB->linkedCommandBuffers) {
             skip |= ValidateQueuedQFOTransfers(pSubCB, qfo_image_scoreboards, qfo_buffer_scoreboards);
+            // Other primaries may be recording vkCmdExecuteCommands with this secondary
+            auto sub_cb_lock = cb_state_lock(pSubCB);
             // TODO: replace with InvalidateCommandBuffers() at recording.
             if ((pSubCB->primaryCommandBuffer != pCB->commandBuffer) &&
                 !(pSubCB->beginInfo.flags & VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT)) {
@@ -4236,6 +4337,33 @@ bool CoreChecks::PreCallValidateCreatePipelineCache(VkDevice device, const VkPip
     return skip;
 }
 
+// Run validate(i) for each pipeline of a batch on pipeline_validation_pool. Messages are captured per pipeline and reported
+// afterwards in pipeline order, so the output is the same as validating the batch serially.
+bool CoreChecks::ValidatePipelinesInParallel(uint32_t count, const std::function<bool(uint32_t)> &validate) const {
+    std::vector<std::vector<CapturedLogMessage>> messages(count);
+    pipeline_validation_pool->ParallelFor(count, [&](uint32_t i) {
+        ThreadLogMessageCapture() = &messages[i];
+        validate(i);
+        ThreadLogMessageCapture() = nullptr;
+    });
+
+    bool skip = false;
+    for (uint32_t i = 0; i < count; i++) {
+        ReportedLogMessages reported;
+        reported.results = ReplayCapturedLogMessages(report_data, messages[i]);
+        for (const bool result : reported.results) skip |= result;
+        // The captured messages were produced as if every callback returned VK_FALSE. One that asked to skip can make checks
+        // like "if (skip) return true;" stop early, changing the messages after it, so the rest of the pipeline is validated
+        // again here, reporting only what follows the messages already reported.
+        if (reported.results.size() < messages[i].size()) {
+            ThreadReportedLogMessages() = &reported;
+            skip |= validate(i);
+            ThreadReportedLogMessages() = nullptr;
+        }
+    }
+    return skip;
+}
+
 bool CoreChecks::PreCallValidateCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                                                         const VkGraphicsPipelineCreateInfo *pCreateInfos,
                                                         const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
@@ -4244,12 +4372,21 @@ bool CoreChecks::PreCallValidateCreateGraphicsPipelines(VkDevice device, VkPipel
                                                                      pPipelines, cgpl_state_data);
     create_graphics_pipeline_api_state *cgpl_state = reinterpret_cast<create_graphics_pipeline_api_state *>(cgpl_state_data);
 
+    std::unordered_set<const SHADER_MODULE_STATE *> deferred_modules;
+    for (uint32_t i = 0; i < count; i++) {
+        skip |= ValidateDeferredShaderModules(pCreateInfos[i].pStages, pCreateInfos[i].stageCount, &deferred_modules);
+    }
     for (uint32_t i = 0; i < count; i++) {
         skip |= ValidatePipelineLocked(cgpl_state->pipe_state, i);
     }
 
-    for (uint32_t i = 0; i < count; i++) {
-        skip |= ValidatePipelineUnlocked(cgpl_state->pipe_state[i].get(), i);
+    if (pipeline_validation_pool && count > 1) {
+        skip |= ValidatePipelinesInParallel(
+            count, [this, cgpl_state](uint32_t i) { return ValidatePipelineUnlocked(cgpl_state->pipe_state[i].get(), i); });
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            skip |= ValidatePipelineUnlocked(cgpl_state->pipe_state[i].get(), i);
+        }
     }
 
     if (device_extensions.vk_ext_vertex_attribute_divisor) {
@@ -4259,6 +4396,17 @@ bool CoreChecks::PreCallValidateCreateGraphicsPipelines(VkDevice device, VkPipel
     return skip;
 }
 
+void CoreChecks::PostCallRecordCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                                       const VkGraphicsPipelineCreateInfo *pCreateInfos,
+                                                       const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
+                                                       VkResult result, void *cgpl_state_data) {
+    for (uint32_t i = 0; i < count; i++) {
+        RecordDeferredShaderModulesReported(pCreateInfos[i].pStages, pCreateInfos[i].stageCount);
+    }
+    StateTracker::PostCallRecordCreateGraphicsPipelines(device, pipelineCache, count, pCreateInfos, pAllocator, pPipelines, result,
+                                                        cgpl_state_data);
+}
+
 bool CoreChecks::PreCallValidateCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                                                        const VkComputePipelineCreateInfo *pCreateInfos,
                                                        const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
@@ -4267,15 +4415,38 @@ bool CoreChecks::PreCallValidateCreateComputePipelines(VkDevice device, VkPipeli
                                                                     pPipelines, ccpl_state_data);
 
     auto *ccpl_state = reinterpret_cast<create_compute_pipeline_api_state *>(ccpl_state_data);
+    std::unordered_set<const SHADER_MODULE_STATE *> deferred_modules;
     for (uint32_t i = 0; i < count; i++) {
+        skip |= ValidateDeferredShaderModules(&pCreateInfos[i].stage, 1, &deferred_modules);
+    }
+    auto validate_pipeline = [this, ccpl_state, pCreateInfos](uint32_t i) {
         // TODO: Add Compute Pipeline Verification
-        skip |= ValidateComputePipelineShaderState(ccpl_state->pipe_state[i].get());
+        bool skip = ValidateComputePipelineShaderState(ccpl_state->pipe_state[i].get());
         skip |= ValidatePipelineCacheControlFlags(pCreateInfos->flags, i, "vkCreateComputePipelines",
                                                   "VUID-VkComputePipelineCreateInfo-pipelineCreationCacheControl-02875");
+        return skip;
+    };
+    if (pipeline_validation_pool && count > 1) {
+        skip |= ValidatePipelinesInParallel(count, validate_pipeline);
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            skip |= validate_pipeline(i);
+        }
     }
     return skip;
 }
 
+void CoreChecks::PostCallRecordCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                                      const VkComputePipelineCreateInfo *pCreateInfos,
+                                                      const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
+                                                      VkResult result, void *ccpl_state_data) {
+    for (uint32_t i = 0; i < count; i++) {
+        RecordDeferredShaderModulesReported(&pCreateInfos[i].stage, 1);
+    }
+    StateTracker::PostCallRecordCreateComputePipelines(device, pipelineCache, count, pCreateInfos, pAllocator, pPipelines, result,
+                                                       ccpl_state_data);
+}
+
 bool CoreChecks::PreCallValidateCreateRayTracingPipelinesNV(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                                                             const VkRayTracingPipelineCreateInfoNV *pCreateInfos,
                                                             const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
@@ -4284,6 +4455,10 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesNV(VkDevice device, VkP
                                                                          pPipelines, crtpl_state_data);
 
     auto *crtpl_state = reinterpret_cast<create_ray_tracing_pipeline_api_state *>(crtpl_state_data);
+    std::unordered_set<const SHADER_MODULE_STATE *> deferred_modules;
+    for (uint32_t i = 0; i < count; i++) {
+        skip |= ValidateDeferredShaderModules(pCreateInfos[i].pStages, pCreateInfos[i].stageCount, &deferred_modules);
+    }
     for (uint32_t i = 0; i < count; i++) {
         PIPELINE_STATE *pipeline = crtpl_state->pipe_state[i].get();
         if (pipeline->raytracingPipelineCI.flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) {
@@ -4308,6 +4483,17 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesNV(VkDevice device, VkP
     return skip;
 }
 
+void CoreChecks::PostCallRecordCreateRayTracingPipelinesNV(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                                           const VkRayTracingPipelineCreateInfoNV *pCreateInfos,
+                                                           const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
+                                                           VkResult result, void *crtpl_state_data) {
+    for (uint32_t i = 0; i < count; i++) {
+        RecordDeferredShaderModulesReported(pCreateInfos[i].pStages, pCreateInfos[i].stageCount);
+    }
+    StateTracker::PostCallRecordCreateRayTracingPipelinesNV(device, pipelineCache, count, pCreateInfos, pAllocator, pPipelines,
+                                                            result, crtpl_state_data);
+}
+
 bool CoreChecks::PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                                                              const VkRayTracingPipelineCreateInfoKHR *pCreateInfos,
                                                              const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
@@ -4316,6 +4502,10 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, Vk
                                                                           pPipelines, crtpl_state_data);
 
     auto *crtpl_state = reinterpret_cast<create_ray_tracing_pipeline_khr_api_state *>(crtpl_state_data);
+    std::unordered_set<const SHADER_MODULE_STATE *> deferred_modules;
+    for (uint32_t i = 0; i < count; i++) {
+        skip |= ValidateDeferredShaderModules(pCreateInfos[i].pStages, pCreateInfos[i].stageCount, &deferred_modules);
+    }
     for (uint32_t i = 0; i < count; i++) {
         PIPELINE_STATE *pipeline = crtpl_state->pipe_state[i].get();
         if (pipeline->raytracingPipelineCI.flags & VK_PIPELINE_CREATE_DERIVATIVE_BIT) {
@@ -4340,6 +4530,17 @@ bool CoreChecks::PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, Vk
     return skip;
 }
 
+void CoreChecks::PostCallRecordCreateRayTracingPipelinesKHR(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                                            const VkRayTracingPipelineCreateInfoKHR *pCreateInfos,
+                                                            const VkAllocationCallbacks *pAllocator, VkPipeline *pPipelines,
+                                                            VkResult result, void *crtpl_state_data) {
+    for (uint32_t i = 0; i < count; i++) {
+        RecordDeferredShaderModulesReported(pCreateInfos[i].pStages, pCreateInfos[i].stageCount);
+    }
+    StateTracker::PostCallRecordCreateRayTracingPipelinesKHR(device, pipelineCache, count, pCreateInfos, pAllocator, pPipelines,
+                                                             result, crtpl_state_data);
+}
+
 bool CoreChecks::PreCallValidateGetPipelineExecutablePropertiesKHR(VkDevice device, const VkPipelineInfoKHR *pPipelineInfo,
                                                                    uint32_t *pExecutableCount,
                                                                    VkPipelineExecutablePropertiesKHR *pProperties) const {
@@ -5233,6 +5434,11 @@ bool CoreChecks::PreCallValidateEndCommandBuffer(VkCommandBuffer commandBuffer)
     }
 
     skip |= ValidateCmd(cb_state, CMD_ENDCOMMANDBUFFER, "vkEndCommandBuffer()");
+    if (!cb_state->deferred_draw_validation.empty()) {
+        // Earlier batches were drained when this call took the object lock; validate the partial batch left over
+        skip |= ValidateDeferredDrawState(cb_state, cb_state->deferred_draw_validation);
+        cb_state->deferred_draw_validation.clear();
+    }
     for (auto query : cb_state->activeQueries) {
         skip |= LogError(commandBuffer, "VUID-vkEndCommandBuffer-commandBuffer-00061",
                          "vkEndCommandBuffer(): Ending command buffer with in progress query: %s, query %d.",
@@ -9879,6 +10085,8 @@ bool CoreChecks::PreCallValidateCmdExecuteCommands(VkCommandBuffer commandBuffer
     for (uint32_t i = 0; i < commandBuffersCount; i++) {
         sub_cb_state = GetCBState(pCommandBuffers[i]);
         assert(sub_cb_state);
+        // The secondary's state can be invalidated, or linked to other primaries, from other threads
+        auto sub_cb_lock = cb_state_lock(sub_cb_state != cb_state ? sub_cb_state : nullptr);
         if (VK_COMMAND_BUFFER_LEVEL_PRIMARY == sub_cb_state->createInfo.level) {
             skip |= LogError(pCommandBuffers[i], "VUID-vkCmdExecuteCommands-pCommandBuffers-00088",
                              "vkCmdExecuteCommands() called w/ Primary %s in element %u of pCommandBuffers array. All "
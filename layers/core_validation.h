@@ -29,6 +29,7 @@
 #include "image_layout_map.h"
 #include "gpu_validation.h"
 #include "shader_validation.h"
+#include "worker_pool.h"
 
 // Set of VUID that need to go between core_validation.cpp and drawdispatch.cpp
 struct DrawDispatchVuid {
@@ -71,6 +72,20 @@ class CoreChecks : public ValidationStateTracker {
     GlobalQFOTransferBarrierMap<VkImageMemoryBarrier> qfo_release_image_barrier_map;
     GlobalQFOTransferBarrierMap<VkBufferMemoryBarrier> qfo_release_buffer_barrier_map;
     GlobalImageLayoutMap imageLayoutMap;
+    // Only created when deferred_draw_validation is enabled
+    std::unique_ptr<WorkerPool> deferred_validation_pool;
+    // Only created when parallel_pipeline_validation is enabled
+    std::unique_ptr<WorkerPool> pipeline_validation_pool;
+    // Only created when khronos_validation.validation_cache_path is set. Used for shader modules created without a
+    // VkShaderModuleValidationCacheCreateInfoEXT and for pipeline shader stages, and written back at device destruction.
+    std::unique_ptr<ValidationCache> layer_validation_cache;
+    std::string layer_validation_cache_path;
+    // Hash of the device state that pipeline shader stage validation depends on, see MakeShaderDeviceStateHash
+    uint64_t shader_device_state_hash = 0;
+    mutable SpecializationValidationCache specialization_validation_cache;
+    // Only created when background_shader_validation is enabled. Declared after layer_validation_cache, which its tasks
+    // insert into, so that it is destroyed first.
+    std::unique_ptr<WorkerPool> shader_module_validation_pool;
 
     CoreChecks() { container_type = LayerObjectTypeCoreValidation; }
 
@@ -79,6 +94,38 @@ class CoreChecks : public ValidationStateTracker {
 
     void IncrementCommandCount(VkCommandBuffer commandBuffer);
 
+    // With fine_grained_locking, vkCmd* calls serialize on the command buffer's own lock instead of the object lock
+    virtual read_lock_guard_t cb_read_lock(VkCommandBuffer command_buffer) {
+        if (enabled[fine_grained_locking]) {
+            auto cb_state = GetCBState(command_buffer);
+            if (cb_state) return read_lock_guard_t(cb_state->lock);
+        }
+        return ValidationObject::read_lock();
+    }
+    virtual write_lock_guard_t cb_write_lock(VkCommandBuffer command_buffer) {
+        if (enabled[fine_grained_locking]) {
+            auto cb_state = GetCBState(command_buffer);
+            if (cb_state) return write_lock_guard_t(cb_state->lock);
+        }
+        return ValidationObject::write_lock();
+    }
+
+    // Deferred draw validation reads device state without holding the object lock, so every entry point other than vkCmd*
+    // waits for it to finish before touching that state. vkCmd* calls don't, which lets the checks overlap with recording.
+    virtual read_lock_guard_t read_lock() {
+        auto lock = ValidationObject::read_lock();
+        WaitForDeferredDrawValidation();
+        return lock;
+    }
+    virtual write_lock_guard_t write_lock() {
+        auto lock = ValidationObject::write_lock();
+        WaitForDeferredDrawValidation();
+        return lock;
+    }
+    void WaitForDeferredDrawValidation() const {
+        if (deferred_validation_pool) deferred_validation_pool->WaitIdle();
+    }
+
     bool VerifyQueueStateToSeq(const QUEUE_STATE* initial_queue, uint64_t initial_seq) const;
     bool ValidateSetMemBinding(VkDeviceMemory mem, const VulkanTypedHandle& typed_handle, const char* apiName) const;
     bool ValidateDeviceQueueFamily(uint32_t queue_family, const char* cmd_name, const char* parameter_name, const char* error_code,
@@ -94,6 +141,7 @@ class CoreChecks : public ValidationStateTracker {
     bool SemaphoreWasSignaled(VkSemaphore semaphore) const;
     bool ValidatePipelineLocked(std::vector<std::shared_ptr<PIPELINE_STATE>> const& pPipelines, int pipelineIndex) const;
     bool ValidatePipelineUnlocked(const PIPELINE_STATE* pPipeline, uint32_t pipelineIndex) const;
+    bool ValidatePipelinesInParallel(uint32_t count, const std::function<bool(uint32_t)>& validate) const;
     bool ValidImageBufferQueue(const CMD_BUFFER_STATE* cb_node, const VulkanTypedHandle& object, uint32_t queueFamilyIndex,
                                uint32_t count, const uint32_t* indices) const;
     bool ValidateFenceForSubmit(const FENCE_STATE* pFence) const;
@@ -333,6 +381,11 @@ class CoreChecks : public ValidationStateTracker {
                                        const PIPELINE_STATE* pPipeline, const char* caller) const;
     bool ValidateCmdBufDrawState(const CMD_BUFFER_STATE* cb_node, CMD_TYPE cmd_type, const bool indexed,
                                  const VkPipelineBindPoint bind_point, const char* function) const;
+    bool DeferDrawState(const cvdescriptorset::DescriptorSet* descriptor_set, const BindingReqMap& bindings,
+                        const std::vector<uint32_t>& dynamic_offsets, const CMD_BUFFER_STATE* cb_node, uint32_t setIndex,
+                        CMD_TYPE cmd_type, const char* function) const;
+    bool ValidateDeferredDrawState(const CMD_BUFFER_STATE* cb_node,
+                                   const std::vector<CMD_BUFFER_STATE::DeferredDrawValidation>& deferred) const;
     static bool ValidateEventStageMask(const ValidationStateTracker* state_data, const CMD_BUFFER_STATE* pCB, size_t eventCount,
                                        size_t firstEventIndex, VkPipelineStageFlags sourceStageMask,
                                        EventToStageMap* localEventToStageMap);
@@ -392,9 +445,24 @@ class CoreChecks : public ValidationStateTracker {
     bool ValidateRayTracingPipeline(PIPELINE_STATE* pipeline, bool isKHR) const;
     bool PreCallValidateCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo,
                                            const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule) const;
+    void PostCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo,
+                                          const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule, VkResult result,
+                                          void* csm_state_data);
+    void PreCallRecordDestroyShaderModule(VkDevice device, VkShaderModule shaderModule, const VkAllocationCallbacks* pAllocator);
+    SpirvValidatorSettings GetSpirvValidatorSettings() const;
+    bool DeferShaderModuleValidation(const VkShaderModuleCreateInfo* pCreateInfo) const;
+    bool ValidateDeferredShaderModule(const SHADER_MODULE_STATE* module) const;
+    bool ValidateDeferredShaderModules(const VkPipelineShaderStageCreateInfo* stages, uint32_t stage_count,
+                                       std::unordered_set<const SHADER_MODULE_STATE*>* checked) const;
+    void RecordDeferredShaderModulesReported(const VkPipelineShaderStageCreateInfo* stages, uint32_t stage_count);
     bool ValidatePipelineShaderStage(VkPipelineShaderStageCreateInfo const* pStage, const PIPELINE_STATE* pipeline,
                                      const PIPELINE_STATE::StageState& stage_state, const SHADER_MODULE_STATE* module,
                                      const spirv_inst_iter& entrypoint, bool check_point_size) const;
+    uint64_t MakeShaderDeviceStateHash() const;
+    uint64_t MakePipelineStageHash(VkPipelineShaderStageCreateInfo const* pStage, const PIPELINE_STATE* pipeline,
+                                   const SHADER_MODULE_STATE* module, bool check_point_size) const;
+    void LoadLayerValidationCache();
+    void SaveLayerValidationCache();
     bool ValidatePointListShaderState(const PIPELINE_STATE* pipeline, SHADER_MODULE_STATE const* src, spirv_inst_iter entrypoint,
                                       VkShaderStageFlagBits stage) const;
     bool ValidateShaderCapabilities(SHADER_MODULE_STATE const* src, VkShaderStageFlagBits stage) const;
@@ -412,7 +480,7 @@ class CoreChecks : public ValidationStateTracker {
     bool ValidateFsOutputsAgainstRenderPass(SHADER_MODULE_STATE const* fs, spirv_inst_iter entrypoint,
                                             PIPELINE_STATE const* pipeline, uint32_t subpass_index) const;
     bool ValidatePushConstantUsage(std::vector<VkPushConstantRange> const* push_constant_ranges, SHADER_MODULE_STATE const* src,
-                                   std::unordered_set<uint32_t> accessible_ids, VkShaderStageFlagBits stage) const;
+                                   std::vector<uint32_t> const& push_constant_variables, VkShaderStageFlagBits stage) const;
     bool ValidatePushConstantBlockAgainstPipeline(std::vector<VkPushConstantRange> const* push_constant_ranges,
                                                   SHADER_MODULE_STATE const* src, spirv_inst_iter type,
                                                   VkShaderStageFlagBits stage) const;
@@ -715,10 +783,18 @@ class CoreChecks : public ValidationStateTracker {
                                                 const VkGraphicsPipelineCreateInfo* pCreateInfos,
                                                 const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
                                                 void* cgpl_state) const;
+    void PostCallRecordCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                               const VkGraphicsPipelineCreateInfo* pCreateInfos,
+                                               const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines, VkResult result,
+                                               void* cgpl_state);
     bool PreCallValidateCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                                                const VkComputePipelineCreateInfo* pCreateInfos,
                                                const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
                                                void* pipe_state) const;
+    void PostCallRecordCreateComputePipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                              const VkComputePipelineCreateInfo* pCreateInfos,
+                                              const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines, VkResult result,
+                                              void* pipe_state);
     bool PreCallValidateGetPipelineExecutablePropertiesKHR(VkDevice device, const VkPipelineInfoKHR* pPipelineInfo,
                                                            uint32_t* pExecutableCount,
                                                            VkPipelineExecutablePropertiesKHR* pProperties) const;
@@ -737,10 +813,18 @@ class CoreChecks : public ValidationStateTracker {
                                                     const VkRayTracingPipelineCreateInfoNV* pCreateInfos,
                                                     const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
                                                     void* pipe_state) const;
+    void PostCallRecordCreateRayTracingPipelinesNV(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                                   const VkRayTracingPipelineCreateInfoNV* pCreateInfos,
+                                                   const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines, VkResult result,
+                                                   void* pipe_state);
     bool PreCallValidateCreateRayTracingPipelinesKHR(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
                                                      const VkRayTracingPipelineCreateInfoKHR* pCreateInfos,
                                                      const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
                                                      void* pipe_state) const;
+    void PostCallRecordCreateRayTracingPipelinesKHR(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
+                                                    const VkRayTracingPipelineCreateInfoKHR* pCreateInfos,
+                                                    const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines,
+                                                    VkResult result, void* pipe_state);
     bool PreCallValidateCmdTraceRaysNV(VkCommandBuffer commandBuffer, VkBuffer raygenShaderBindingTableBuffer,
                                        VkDeviceSize raygenShaderBindingOffset, VkBuffer missShaderBindingTableBuffer,
                                        VkDeviceSize missShaderBindingOffset, VkDeviceSize missShaderBindingStride,
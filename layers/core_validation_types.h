@@ -68,6 +68,7 @@ constexpr static auto kInvalidLayout = image_layout_map::kInvalidLayout;
 using ImageSubresourceLayoutMap = image_layout_map::ImageSubresourceLayoutMap;
 
 struct CMD_BUFFER_STATE;
+struct EntryPointReflection;
 class CoreChecks;
 class ValidationStateTracker;
 
@@ -858,9 +859,8 @@ class safe_VkRayTracingPipelineCreateInfoCommon : public safe_VkRayTracingPipeli
 class PIPELINE_STATE : public BASE_NODE {
   public:
     struct StageState {
-        std::unordered_set<uint32_t> accessible_ids;
-        std::vector<std::pair<descriptor_slot_t, interface_var>> descriptor_uses;
-        bool has_writable_descriptor;
+        // Shared with the other pipelines using the same entrypoint. Null if the module or entrypoint is not valid.
+        std::shared_ptr<const EntryPointReflection> reflection;
         VkShaderStageFlagBits stage_flag;
     };
 
@@ -1152,6 +1152,8 @@ typedef std::unordered_map<VkImage, std::unique_ptr<ImageSubresourceLayoutMap>>
 class FRAMEBUFFER_STATE;
 // Cmd Buffer Wrapper Struct - TODO : This desperately needs its own class
 struct CMD_BUFFER_STATE : public BASE_NODE {
+    // Guards the recording state when fine_grained_locking lets vkCmd* calls skip the validation object lock
+    mutable ReadWriteLock lock;
     VkCommandBuffer commandBuffer;
     VkCommandBufferAllocateInfo createInfo = {};
     VkCommandBufferBeginInfo beginInfo;
@@ -1232,6 +1234,19 @@ struct CMD_BUFFER_STATE : public BASE_NODE {
                                    uint32_t perfQueryPass, QueryMap *localQueryToStateMap)>>
         queryUpdates;
     std::unordered_set<cvdescriptorset::DescriptorSet *> validated_descriptor_sets;
+    // Descriptor checks captured at draw time when deferred_draw_validation is enabled. Full batches are validated on
+    // CoreChecks' worker pool while recording continues, and the remainder at vkEndCommandBuffer. The remainder is dropped
+    // when the command buffer is invalidated, as descriptor_set and the resources it refers to may be freed right after.
+    struct DeferredDrawValidation {
+        const cvdescriptorset::DescriptorSet *descriptor_set;
+        BindingReqMap bindings;
+        std::vector<uint32_t> dynamic_offsets;
+        uint32_t set_index;
+        CMD_TYPE cmd_type;
+        const char *function;
+    };
+    // Only appended to from draw time validation, which already holds this command buffer's lock
+    mutable std::vector<DeferredDrawValidation> deferred_draw_validation;
     // Contents valid only after an index buffer is bound (CBSTATUS_INDEX_BUFFER_BOUND set)
     IndexBufferBinding index_buffer_binding;
     bool performance_lock_acquired = false;
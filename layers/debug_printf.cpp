@@ -126,7 +126,15 @@ void DebugPrintf::PostCallRecordCreatePipelineLayout(VkDevice device, const VkPi
     if (result != VK_SUCCESS) {
         ReportSetupProblem(device, "Unable to create pipeline layout.  Device could become unstable.");
         aborted = true;
+        return;
     }
+    UtilPostCallRecordCreatePipelineLayout(this, pCreateInfo, *pPipelineLayout);
+}
+
+void DebugPrintf::PreCallRecordDestroyPipelineLayout(VkDevice device, VkPipelineLayout pipelineLayout,
+                                                     const VkAllocationCallbacks *pAllocator) {
+    dynamic_output_pipeline_layouts.erase(pipelineLayout);
+    ValidationStateTracker::PreCallRecordDestroyPipelineLayout(device, pipelineLayout, pAllocator);
 }
 
 // Free the device memory and descriptor set associated with a command buffer.
@@ -136,7 +144,7 @@ void DebugPrintf::ResetCommandBuffer(VkCommandBuffer commandBuffer) {
     }
     auto debug_printf_buffer_list = GetBufferInfo(commandBuffer);
     for (auto buffer_info : debug_printf_buffer_list) {
-        vmaDestroyBuffer(vmaAllocator, buffer_info.output_mem_block.buffer, buffer_info.output_mem_block.allocation);
+        output_region_allocator->Release(buffer_info.output_region);
         if (buffer_info.desc_set != VK_NULL_HANDLE) {
             desc_set_manager->PutBackDescriptorSet(buffer_info.desc_pool, buffer_info.desc_set);
         }
@@ -400,16 +408,14 @@ std::vector<DPFSubstring> DebugPrintf::ParseFormatString(const std::string forma
     return parsed_strings;
 }
 
-std::string DebugPrintf::FindFormatString(std::vector<unsigned int> pgm, uint32_t string_id) {
+std::string DebugPrintf::FindFormatString(const SpirvBlob &pgm, uint32_t string_id) {
     std::string format_string;
-    SHADER_MODULE_STATE shader;
-    shader.words = pgm;
+    SHADER_MODULE_STATE shader(pgm);
     if (shader.words.size() > 0) {
         for (auto insn : shader) {
             if (insn.opcode() == spv::OpString) {
-                uint32_t offset = insn.offset();
-                if (pgm[offset + 1] == string_id) {
-                    format_string = reinterpret_cast<char *>(&pgm[offset + 2]);
+                if (insn.word(1) == string_id) {
+                    format_string = reinterpret_cast<char const *>(&insn.word(2));
                     break;
                 }
             }
@@ -472,7 +478,7 @@ void DebugPrintf::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
         std::stringstream shader_message;
         VkShaderModule shader_module_handle = VK_NULL_HANDLE;
         VkPipeline pipeline_handle = VK_NULL_HANDLE;
-        std::vector<unsigned int> pgm;
+        SpirvBlob pgm;
 
         DPFOutputRecord *debug_record = reinterpret_cast<DPFOutputRecord *>(&debug_output_buffer[index]);
         // Lookup the VkShaderModule handle and SPIR-V code used to create the shader, using the unique shader ID value returned
@@ -699,19 +705,6 @@ void DebugPrintf::AllocateDebugPrintfResources(const VkCommandBuffer cmd_buffer,
 
     if (aborted) return;
 
-    std::vector<VkDescriptorSet> desc_sets;
-    VkDescriptorPool desc_pool = VK_NULL_HANDLE;
-    result = desc_set_manager->GetDescriptorSets(1, &desc_pool, debug_desc_layout, &desc_sets);
-    assert(result == VK_SUCCESS);
-    if (result != VK_SUCCESS) {
-        ReportSetupProblem(device, "Unable to allocate descriptor sets.  Device could become unstable.");
-        aborted = true;
-        return;
-    }
-
-    VkDescriptorBufferInfo output_desc_buffer_info = {};
-    output_desc_buffer_info.range = output_buffer_size;
-
     auto cb_node = GetCBState(cmd_buffer);
     if (!cb_node) {
         ReportSetupProblem(device, "Unrecognized command buffer");
@@ -719,55 +712,48 @@ void DebugPrintf::AllocateDebugPrintfResources(const VkCommandBuffer cmd_buffer,
         return;
     }
 
-    // Allocate memory for the output block that the gpu will use to return values for printf
-    DPFDeviceMemoryBlock output_block = {};
-    VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    bufferInfo.size = output_buffer_size;
-    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-    VmaAllocationCreateInfo allocInfo = {};
-    allocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
-    result = vmaCreateBuffer(vmaAllocator, &bufferInfo, &allocInfo, &output_block.buffer, &output_block.allocation, nullptr);
+    // Get a zeroed output region that the gpu will use to return values for printf. The output buffer is the only
+    // binding in the debug set, so the set belonging to the region's block is bound with the region as dynamic offset.
+    UtilOutputRegion output_region;
+    result = output_region_allocator->Allocate(&output_region);
     if (result != VK_SUCCESS) {
         ReportSetupProblem(device, "Unable to allocate device memory.  Device could become unstable.");
         aborted = true;
         return;
     }
-
-    // Clear the output block to zeros so that only printf values from the gpu will be present
-    uint32_t *pData;
-    result = vmaMapMemory(vmaAllocator, output_block.allocation, (void **)&pData);
-    if (result == VK_SUCCESS) {
-        memset(pData, 0, output_buffer_size);
-        vmaUnmapMemory(vmaAllocator, output_block.allocation);
-    }
-
-    VkWriteDescriptorSet desc_writes[1] = {};
-    const uint32_t desc_count = 1;
-
-    // Write the descriptor
-    output_desc_buffer_info.buffer = output_block.buffer;
-    output_desc_buffer_info.offset = 0;
-
-    desc_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    desc_writes[0].descriptorCount = 1;
-    desc_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    desc_writes[0].pBufferInfo = &output_desc_buffer_info;
-    desc_writes[0].dstSet = desc_sets[0];
-    desc_writes[0].dstBinding = 3;
-    DispatchUpdateDescriptorSets(device, desc_count, desc_writes, 0, NULL);
+    VkDescriptorSet desc_set = output_region_allocator->GetDescriptorSet(output_region);
+    VkDescriptorPool desc_pool = VK_NULL_HANDLE;
 
     auto iter = cb_node->lastBound.find(bind_point);  // find() allows read-only access to cb_state
     if (iter != cb_node->lastBound.end()) {
         auto pipeline_state = iter->second.pipeline_state;
+        const bool dynamic_output =
+            pipeline_state && dynamic_output_pipeline_layouts.count(pipeline_state->pipeline_layout->layout) != 0;
+        if (!dynamic_output) {
+            // The pipeline layout had no room for the dynamic output binding, so the command needs its own set
+            result = desc_set_manager->GetDescriptorSet(&desc_pool, debug_desc_layout, &desc_set);
+            assert(result == VK_SUCCESS);
+            if (result != VK_SUCCESS) {
+                ReportSetupProblem(device, "Unable to allocate descriptor sets.  Device could become unstable.");
+                output_region_allocator->Release(output_region);
+                aborted = true;
+                return;
+            }
+            VkDescriptorBufferInfo output_desc_buffer_info = {};
+            VkWriteDescriptorSet desc_write = {};
+            output_region_allocator->WriteDescriptor(desc_set, output_region, false, &output_desc_buffer_info, &desc_write);
+            DispatchUpdateDescriptorSets(device, 1, &desc_write, 0, NULL);
+        }
         if (pipeline_state && (pipeline_state->pipeline_layout->set_layouts.size() <= desc_set_bind_index)) {
             DispatchCmdBindDescriptorSets(cmd_buffer, bind_point, pipeline_state->pipeline_layout->layout, desc_set_bind_index, 1,
-                                          desc_sets.data(), 0, nullptr);
+                                          &desc_set, dynamic_output ? 1 : 0, dynamic_output ? &output_region.offset : nullptr);
         }
-        // Record buffer and memory info in CB state tracking
-        GetBufferInfo(cmd_buffer).emplace_back(output_block, desc_sets[0], desc_pool, bind_point);
+        // Record buffer and memory info in CB state tracking. A shared descriptor set isn't ours to give back.
+        GetBufferInfo(cmd_buffer)
+            .emplace_back(output_region, desc_pool != VK_NULL_HANDLE ? desc_set : VK_NULL_HANDLE, desc_pool, bind_point);
     } else {
         ReportSetupProblem(device, "Unable to find pipeline state");
-        vmaDestroyBuffer(vmaAllocator, output_block.buffer, output_block.allocation);
+        output_region_allocator->Release(output_region);
         aborted = true;
         return;
     }
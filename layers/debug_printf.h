@@ -26,25 +26,20 @@
 #include <map>
 class DebugPrintf;
 
-struct DPFDeviceMemoryBlock {
-    VkBuffer buffer;
-    VmaAllocation allocation;
-};
-
 struct DPFBufferInfo {
-    DPFDeviceMemoryBlock output_mem_block;
+    UtilOutputRegion output_region;
     VkDescriptorSet desc_set;
     VkDescriptorPool desc_pool;
     VkPipelineBindPoint pipeline_bind_point;
-    DPFBufferInfo(DPFDeviceMemoryBlock output_mem_block, VkDescriptorSet desc_set, VkDescriptorPool desc_pool,
+    DPFBufferInfo(UtilOutputRegion output_region, VkDescriptorSet desc_set, VkDescriptorPool desc_pool,
                   VkPipelineBindPoint pipeline_bind_point)
-        : output_mem_block(output_mem_block), desc_set(desc_set), desc_pool(desc_pool), pipeline_bind_point(pipeline_bind_point){};
+        : output_region(output_region), desc_set(desc_set), desc_pool(desc_pool), pipeline_bind_point(pipeline_bind_point){};
 };
 
 struct DPFShaderTracker {
     VkPipeline pipeline;
     VkShaderModule shader_module;
-    std::vector<unsigned int> pgm;
+    SpirvBlob pgm;
 };
 
 enum vartype { varsigned, varunsigned, varfloat };
@@ -72,7 +67,6 @@ class DebugPrintf : public ValidationStateTracker {
 
     uint32_t unique_shader_module_id = 0;
     std::unordered_map<VkCommandBuffer, std::vector<DPFBufferInfo>> command_buffer_map;
-    uint32_t output_buffer_size;
 
   public:
     DebugPrintf() { container_type = LayerObjectTypeDebugPrintf; }
@@ -85,8 +79,12 @@ class DebugPrintf : public ValidationStateTracker {
     uint32_t adjusted_max_desc_sets;
     uint32_t desc_set_bind_index;
     VkDescriptorSetLayout debug_desc_layout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout dynamic_debug_desc_layout = VK_NULL_HANDLE;
     VkDescriptorSetLayout dummy_desc_layout = VK_NULL_HANDLE;
+    std::unordered_set<VkPipelineLayout> dynamic_output_pipeline_layouts;
     std::unique_ptr<UtilDescriptorSetManager> desc_set_manager;
+    std::unique_ptr<UtilOutputRegionAllocator> output_region_allocator;
+    uint32_t output_buffer_size;
     std::unordered_map<uint32_t, DPFShaderTracker> shader_map;
     PFN_vkSetDeviceLoaderData vkSetDeviceLoaderData;
     VmaAllocator vmaAllocator = {};
@@ -115,6 +113,8 @@ class DebugPrintf : public ValidationStateTracker {
     void PostCallRecordCreatePipelineLayout(VkDevice device, const VkPipelineLayoutCreateInfo* pCreateInfo,
                                             const VkAllocationCallbacks* pAllocator, VkPipelineLayout* pPipelineLayout,
                                             VkResult result);
+    void PreCallRecordDestroyPipelineLayout(VkDevice device, VkPipelineLayout pipelineLayout,
+                                            const VkAllocationCallbacks* pAllocator);
     void ResetCommandBuffer(VkCommandBuffer commandBuffer);
     bool PreCallValidateCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount, const VkEvent* pEvents,
                                       VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask,
@@ -156,7 +156,7 @@ class DebugPrintf : public ValidationStateTracker {
                                          const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule,
                                          void* csm_state_data);
     std::vector<DPFSubstring> ParseFormatString(std::string format_string);
-    std::string FindFormatString(std::vector<unsigned int> pgm, uint32_t string_id);
+    std::string FindFormatString(const SpirvBlob &pgm, uint32_t string_id);
     void AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQueue queue, VkPipelineBindPoint pipeline_bind_point,
                                     uint32_t operation_index, uint32_t* const debug_output_buffer);
     void PreCallRecordCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex,
@@ -1431,6 +1431,7 @@ void cvdescriptorset::DescriptorSet::FilterOneBindingReq(const BindingReqMap::va
 
 void cvdescriptorset::DescriptorSet::FilterBindingReqs(const CMD_BUFFER_STATE &cb_state, const PIPELINE_STATE &pipeline,
                                                        const BindingReqMap &in_req, BindingReqMap *out_req) const {
+    read_lock_guard_t lock(cached_validation_lock_);
     // For const cleanliness we have to find in the maps...
     const auto validated_it = cached_validation_.find(&cb_state);
     if (validated_it == cached_validation_.cend()) {
@@ -1483,6 +1484,7 @@ void cvdescriptorset::DescriptorSet::FilterBindingReqs(const CMD_BUFFER_STATE &c
 
 void cvdescriptorset::DescriptorSet::UpdateValidationCache(const CMD_BUFFER_STATE &cb_state, const PIPELINE_STATE &pipeline,
                                                            const BindingReqMap &updated_bindings) {
+    write_lock_guard_t lock(cached_validation_lock_);
     // For const cleanliness we have to find in the maps...
     auto &validated = cached_validation_[&cb_state];
 
@@ -641,9 +641,13 @@ class DescriptorSet : public BASE_NODE {
     void UpdateValidationCache(const CMD_BUFFER_STATE &cb_state, const PIPELINE_STATE &pipeline,
                                const BindingReqMap &updated_bindings);
     void ClearCachedDynamicDescriptorValidation(CMD_BUFFER_STATE *cb_state) {
+        write_lock_guard_t lock(cached_validation_lock_);
         cached_validation_[cb_state].dynamic_buffers.clear();
     }
-    void ClearCachedValidation(CMD_BUFFER_STATE *cb_state) { cached_validation_.erase(cb_state); }
+    void ClearCachedValidation(CMD_BUFFER_STATE *cb_state) {
+        write_lock_guard_t lock(cached_validation_lock_);
+        cached_validation_.erase(cb_state);
+    }
     VkSampler const *GetImmutableSamplerPtrFromBinding(const uint32_t index) const {
         return p_layout_->GetImmutableSamplerPtrFromBinding(index);
     };
@@ -711,6 +715,8 @@ class DescriptorSet : public BASE_NODE {
     typedef std::unordered_map<const CMD_BUFFER_STATE *, CachedValidation> CachedValidationMap;
     // Image and ImageView bindings are validated per pipeline and not invalidate by repeated binding
     CachedValidationMap cached_validation_;
+    // A set may be bound to several command buffers recording concurrently
+    mutable ReadWriteLock cached_validation_lock_;
 };
 // For the "bindless" style resource usage with many descriptors, need to optimize binding and validation
 class PrefilterBindRequestMap {
@@ -68,7 +68,25 @@ struct HashedUint64 {
     }
 };
 
-extern vl_concurrent_unordered_map<uint64_t, uint64_t, 4, HashedUint64> unique_id_mapping;
+extern vl_concurrent_flat_map<uint64_t, uint64_t, HashedUint64> unique_id_mapping;
+
+// Per-thread, direct mapped cache of where unique_id_mapping keeps wrapped handles. A hint only checks that its own map
+// slot still holds the handle, so repeated unwraps of long lived handles skip the probe, destroying other handles leaves
+// them alone, and a destroyed handle is never unwrapped from a stale hint.
+struct UnwrapCache {
+    static const uint32_t kSize = 256;
+    vl_concurrent_flat_map<uint64_t, uint64_t, HashedUint64>::FindHint hints[kSize];
+
+    static UnwrapCache &Get() {
+        static thread_local UnwrapCache cache;
+        return cache;
+    }
+
+    uint64_t Unwrap(uint64_t wrapped_id) {
+        auto iter = unique_id_mapping.find(wrapped_id, &hints[HashedUint64()(wrapped_id) & (kSize - 1)]);
+        return (iter == unique_id_mapping.end()) ? 0 : iter->second;
+    }
+};
 
 
 VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(
@@ -2805,6 +2823,11 @@ typedef enum ValidationCheckDisables {
 typedef enum ValidationCheckEnables {
     VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ARM,
     VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ALL,
+    VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING,
+    VALIDATION_CHECK_ENABLE_DEFERRED_DRAW_VALIDATION,
+    VALIDATION_CHECK_ENABLE_GPU_ASSISTED_ASYNC_READBACK,
+    VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION,
+    VALIDATION_CHECK_ENABLE_BACKGROUND_SHADER_VALIDATION,
 } ValidationCheckEnables;
 
 typedef enum VkValidationFeatureEnable {
@@ -2839,6 +2862,11 @@ typedef enum EnableFlags {
     vendor_specific_arm,
     debug_printf,
     sync_validation,
+    fine_grained_locking,
+    deferred_draw_validation,
+    gpu_validation_async_readback,
+    parallel_pipeline_validation,
+    background_shader_validation,
     // Insert new enables above this line
     kMaxEnableFlags,
 } EnableFlags;
@@ -2882,6 +2910,15 @@ class ValidationObject {
         virtual write_lock_guard_t write_lock() {
             return write_lock_guard_t(validation_object_mutex);
         }
+        // Command buffer (vkCmd*) entry points lock through these. The application must externally synchronize the command
+        // buffer, so a validation object whose command buffer state is only touched by the recording thread, and which
+        // protects any device level state itself, may elide the object-wide lock when fine_grained_locking is enabled.
+        virtual read_lock_guard_t cb_read_lock(VkCommandBuffer command_buffer) {
+            return read_lock();
+        }
+        virtual write_lock_guard_t cb_write_lock(VkCommandBuffer command_buffer) {
+            return write_lock();
+        }
 
         void RegisterValidationObject(bool vo_enabled, uint32_t instance_api_version,
             debug_report_data* instance_report_data, std::vector<ValidationObject*> &dispatch_list) {
@@ -2927,6 +2964,7 @@ class ValidationObject {
         // Debug Logging Helpers
         bool LogError(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -2945,6 +2983,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogError(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -2964,6 +3003,7 @@ class ValidationObject {
 
         bool LogWarning(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -2982,6 +3022,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogWarning(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -3000,6 +3041,7 @@ class ValidationObject {
 
         bool LogPerformanceWarning(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT)) {
@@ -3018,6 +3060,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogPerformanceWarning(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT)) {
@@ -3036,6 +3079,7 @@ class ValidationObject {
 
         bool LogInfo(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -3054,6 +3098,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogInfo(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -3091,10 +3136,7 @@ class ValidationObject {
         // Unwrap a handle.
         template <typename HandleType>
         HandleType Unwrap(HandleType wrappedHandle) {
-            auto iter = unique_id_mapping.find(reinterpret_cast<uint64_t const &>(wrappedHandle));
-            if (iter == unique_id_mapping.end())
-                return (HandleType)0;
-            return (HandleType)iter->second;
+            return (HandleType)UnwrapCache::Get().Unwrap(reinterpret_cast<uint64_t const &>(wrappedHandle));
         }
 
         // Wrap a newly created handle with a new unique ID, and return the new ID.
@@ -26,6 +26,8 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -77,7 +79,7 @@ public:
         int64_t count;
     };
 
-    ObjectUseData() : thread(0), writer_reader_count(0) {
+    ObjectUseData() : thread(0), writer_reader_count(0), waiter_count(0) {
         // silence -Wunused-private-field warning
         padding[0] = 0;
     }
@@ -91,33 +93,104 @@ public:
         return WriteReadCount(prev);
     }
     WriteReadCount RemoveWriter() {
-        int64_t prev = writer_reader_count.fetch_add(-(1LL << 32));
-        return WriteReadCount(prev);
+        return Release(1LL << 32);
     }
     WriteReadCount RemoveReader() {
-        int64_t prev = writer_reader_count.fetch_add(-1LL);
-        return WriteReadCount(prev);
+        return Release(1LL);
     }
     WriteReadCount GetCount() {
         return WriteReadCount(writer_reader_count);
     }
 
+    void Reset() {
+        thread = 0;
+        writer_reader_count = 0;
+    }
+
     void WaitForObjectIdle(bool is_writer)  {
         // Wait for thread-safe access to object instead of skipping call.
-        while (GetCount().GetReadCount() > (int)(!is_writer) || GetCount().GetWriteCount() > (int)is_writer) {
-            std::this_thread::sleep_for(std::chrono::microseconds(1));
-        }
+        // Back out this thread's own use while parked, so that several colliding threads don't wait on each other,
+        // then reclaim the object once it has no readers or writers left.
+        const int64_t own_count = is_writer ? (1LL << 32) : 1LL;
+        Release(own_count);
+        ParkingSlot &slot = GetParkingSlot(this);
+        std::unique_lock<std::mutex> lock(slot.mutex);
+        waiter_count.fetch_add(1);
+        slot.idle.wait(lock, [this, own_count]() {
+            int64_t idle = 0;
+            return writer_reader_count.compare_exchange_strong(idle, own_count);
+        });
+        waiter_count.fetch_sub(1);
     }
 
     std::atomic<loader_platform_thread_id> thread;
 
 private:
+    // Threads waiting for an object to go idle block on a condition variable shared by all objects hashing to the same slot
+    struct ParkingSlot {
+        std::mutex mutex;
+        std::condition_variable idle;
+    };
+    static ParkingSlot &GetParkingSlot(const ObjectUseData *use_data) {
+        static ParkingSlot slots[64];
+        return slots[(reinterpret_cast<uintptr_t>(use_data) >> 6) & 63];
+    }
+
+    WriteReadCount Release(int64_t count) {
+        int64_t prev = writer_reader_count.fetch_sub(count);
+        // Only collisions park a thread, so the common path is a single load of waiter_count
+        if (prev == count && waiter_count.load() > 0) {
+            ParkingSlot &slot = GetParkingSlot(this);
+            { std::lock_guard<std::mutex> lock(slot.mutex); }
+            slot.idle.notify_all();
+        }
+        return WriteReadCount(prev);
+    }
+
     // need to update write and read counts atomically. Writer in high
     // 32 bits, reader in low 32 bits.
     std::atomic<int64_t> writer_reader_count;
+    std::atomic<int32_t> waiter_count;
 
     // Put each lock on its own cache line to avoid false cache line sharing.
-    char padding[(-int(sizeof(std::atomic<loader_platform_thread_id>) + sizeof(std::atomic<int64_t>))) & 63];
+    char padding[(-int(sizeof(std::atomic<loader_platform_thread_id>) + sizeof(std::atomic<int64_t>) +
+                       sizeof(std::atomic<int32_t>))) & 63];
+};
+
+// Slab of ObjectUseData handed out as raw pointers, so that lookups don't pay for shared_ptr reference counting.
+// A destroyed object's entry is quarantined for the next kQuarantineSize destroys before it is reused, which keeps
+// an (invalid) use of the handle racing with its destruction on memory that is still an ObjectUseData.
+class ObjectUseDataPool
+{
+public:
+    ObjectUseData *Allocate() {
+        std::lock_guard<std::mutex> lock(pool_lock);
+        if (free_list.empty()) {
+            slab.emplace_back();
+            return &slab.back();
+        }
+        ObjectUseData *use_data = free_list.back();
+        free_list.pop_back();
+        use_data->Reset();
+        return use_data;
+    }
+
+    void Retire(ObjectUseData *use_data) {
+        std::lock_guard<std::mutex> lock(pool_lock);
+        retired.push_back(use_data);
+        if (retired.size() > kQuarantineSize) {
+            free_list.push_back(retired.front());
+            retired.pop_front();
+        }
+    }
+
+private:
+    static const size_t kQuarantineSize = 1024;
+
+    std::mutex pool_lock;
+    std::deque<ObjectUseData> slab;
+    std::vector<ObjectUseData *> free_list;
+    std::deque<ObjectUseData *> retired;
 };
 
 
@@ -128,23 +201,30 @@ public:
     VulkanObjectType object_type;
     ValidationObject *object_data;
 
-    vl_concurrent_unordered_map<T, std::shared_ptr<ObjectUseData>, 6> object_table;
+    vl_concurrent_flat_map<T, ObjectUseData *> object_table;
+    ObjectUseDataPool use_data_pool;
 
     void CreateObject(T object) {
-        object_table.insert(object, std::make_shared<ObjectUseData>());
+        ObjectUseData *use_data = use_data_pool.Allocate();
+        if (!object_table.insert(object, use_data)) {
+            use_data_pool.Retire(use_data);
+        }
     }
 
     void DestroyObject(T object) {
         if (object) {
-            object_table.erase(object);
+            auto iter = object_table.pop(object);
+            if (iter != object_table.end()) {
+                use_data_pool.Retire(iter->second);
+            }
         }
     }
 
-    std::shared_ptr<ObjectUseData> FindObject(T object) {
+    ObjectUseData *FindObject(T object) {
         assert(object_table.contains(object));
-        auto iter = std::move(object_table.find(object));
+        auto iter = object_table.find(object);
         if (iter != object_table.end()) {
-            return std::move(iter->second);
+            return iter->second;
         } else {
             object_data->LogError(object, kVUID_Threading_Info,
                     "Couldn't find %s Object 0x%" PRIxLEAST64
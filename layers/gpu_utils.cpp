@@ -98,17 +98,18 @@ VkResult UtilDescriptorSetManager::GetDescriptorSets(uint32_t count, VkDescripto
         if (count > default_pool_size) {
             pool_count = count;
         }
-        const VkDescriptorPoolSize size_counts = {
-            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-            pool_count * numBindingsInSet,
+        // The output binding of each set is either a storage buffer or a dynamic one, see UtilOutputRegionAllocator
+        const VkDescriptorPoolSize size_counts[2] = {
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, pool_count * numBindingsInSet},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, pool_count},
         };
         VkDescriptorPoolCreateInfo desc_pool_info = {};
         desc_pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         desc_pool_info.pNext = NULL;
         desc_pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
         desc_pool_info.maxSets = pool_count;
-        desc_pool_info.poolSizeCount = 1;
-        desc_pool_info.pPoolSizes = &size_counts;
+        desc_pool_info.poolSizeCount = 2;
+        desc_pool_info.pPoolSizes = size_counts;
         result = DispatchCreateDescriptorPool(device, &desc_pool_info, NULL, &pool_to_use);
         assert(result == VK_SUCCESS);
         if (result != VK_SUCCESS) {
@@ -478,13 +479,12 @@ bool GetLineAndFilename(const std::string string, uint32_t *linenumber, std::str
 
 // Extract the filename, line number, and column number from the correct OpLine and build a message string from it.
 // Scan the source (from OpSource) to find the line of source at the reported line number and place it in another message string.
-void UtilGenerateSourceMessages(const std::vector<unsigned int> &pgm, const uint32_t *debug_record, bool from_printf,
-                                std::string &filename_msg, std::string &source_msg) {
+void UtilGenerateSourceMessages(const SpirvBlob &pgm, const uint32_t *debug_record, bool from_printf, std::string &filename_msg,
+                                std::string &source_msg) {
     using namespace spvtools;
     std::ostringstream filename_stream;
     std::ostringstream source_stream;
-    SHADER_MODULE_STATE shader;
-    shader.words = pgm;
+    SHADER_MODULE_STATE shader(pgm);
     // Find the OpLine just before the failing instruction indicated by the debug info.
     // SPIR-V can only be iterated in the forward direction due to its opcode/length encoding.
     uint32_t instruction_index = 0;
@@ -43,6 +43,152 @@ struct UtilQueueBarrierCommandInfo {
     VkCommandPool barrier_command_pool = VK_NULL_HANDLE;
     VkCommandBuffer barrier_command_buffer = VK_NULL_HANDLE;
 };
+
+// Where an instrumented draw, dispatch or trace rays writes its output
+struct UtilOutputRegion {
+    uint32_t block = UINT32_MAX;
+    uint32_t offset = 0;  // Offset of the region within its block
+    uint32_t *data = nullptr;
+};
+
+// Carves fixed size output regions out of large, persistently mapped blocks instead of creating a buffer per command.
+// Each block has one descriptor set, using the layout whose output binding is a dynamic storage buffer, so a command only
+// needs a dynamic offset to select its region. Pipeline layouts without room for the dynamic binding get a set per command
+// with a static output binding instead, see UtilUseDynamicOutputBinding. A block is reused once every region handed out
+// from it has been released.
+class UtilOutputRegionAllocator {
+  public:
+    UtilOutputRegionAllocator(VkDevice device, VmaAllocator vma_allocator, UtilDescriptorSetManager *desc_set_manager,
+                              VkDescriptorSetLayout dynamic_desc_layout, uint32_t output_binding, uint32_t region_size,
+                              VkDeviceSize offset_alignment)
+        : device_(device),
+          vma_allocator_(vma_allocator),
+          desc_set_manager_(desc_set_manager),
+          dynamic_desc_layout_(dynamic_desc_layout),
+          output_binding_(output_binding),
+          region_size_(region_size),
+          region_stride_(static_cast<uint32_t>(((region_size + offset_alignment - 1) / offset_alignment) * offset_alignment)) {}
+
+    ~UtilOutputRegionAllocator() {
+        for (auto &block : blocks_) {
+            desc_set_manager_->PutBackDescriptorSet(block.desc_pool, block.desc_set);
+            vmaUnmapMemory(vma_allocator_, block.allocation);
+            vmaDestroyBuffer(vma_allocator_, block.buffer, block.allocation);
+        }
+    }
+
+    // Returns a zeroed region, or VK_ERROR_OUT_OF_DEVICE_MEMORY if a new block couldn't be created
+    VkResult Allocate(UtilOutputRegion *region) {
+        if (current_block_ == UINT32_MAX || blocks_[current_block_].next_region == kRegionsPerBlock) {
+            VkResult result = NextBlock();
+            if (result != VK_SUCCESS) return result;
+        }
+        Block &block = blocks_[current_block_];
+        region->block = current_block_;
+        region->offset = block.next_region++ * region_stride_;
+        region->data = reinterpret_cast<uint32_t *>(block.data + region->offset);
+        memset(region->data, 0, region_size_);
+        block.live_regions++;
+        return VK_SUCCESS;
+    }
+
+    void Release(const UtilOutputRegion &region) {
+        Block &block = blocks_[region.block];
+        if (--block.live_regions == 0 && region.block != current_block_) {
+            block.next_region = 0;
+            free_blocks_.push_back(region.block);
+        }
+    }
+
+    VkBuffer GetBuffer(const UtilOutputRegion &region) const { return blocks_[region.block].buffer; }
+    VkDescriptorSet GetDescriptorSet(const UtilOutputRegion &region) const { return blocks_[region.block].desc_set; }
+    uint32_t GetRegionSize() const { return region_size_; }
+
+    // Point the output binding of a per command desc_set at region. A dynamic binding covers the start of the region's
+    // block and is bound with the region's offset as dynamic offset, a static binding covers the region itself.
+    void WriteDescriptor(VkDescriptorSet desc_set, const UtilOutputRegion &region, bool dynamic,
+                         VkDescriptorBufferInfo *buffer_info, VkWriteDescriptorSet *desc_write) const {
+        buffer_info->buffer = blocks_[region.block].buffer;
+        buffer_info->offset = dynamic ? 0 : region.offset;
+        buffer_info->range = region_size_;
+        *desc_write = {};
+        desc_write->sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        desc_write->dstSet = desc_set;
+        desc_write->dstBinding = output_binding_;
+        desc_write->descriptorCount = 1;
+        desc_write->descriptorType = dynamic ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        desc_write->pBufferInfo = buffer_info;
+    }
+
+  private:
+    static const uint32_t kRegionsPerBlock = 1024;
+    struct Block {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        uint8_t *data = nullptr;
+        VkDescriptorPool desc_pool = VK_NULL_HANDLE;
+        VkDescriptorSet desc_set = VK_NULL_HANDLE;
+        uint32_t next_region = 0;
+        uint32_t live_regions = 0;
+    };
+
+    VkResult NextBlock() {
+        // Keep filling the current block if everything handed out from it has already been released
+        if (current_block_ != UINT32_MAX) {
+            Block &current = blocks_[current_block_];
+            if (current.live_regions == 0) {
+                current.next_region = 0;
+                return VK_SUCCESS;
+            }
+        }
+        if (!free_blocks_.empty()) {
+            current_block_ = free_blocks_.back();
+            free_blocks_.pop_back();
+            return VK_SUCCESS;
+        }
+
+        Block block;
+        VkBufferCreateInfo buffer_info = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        buffer_info.size = static_cast<VkDeviceSize>(region_stride_) * kRegionsPerBlock;
+        buffer_info.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        VmaAllocationCreateInfo alloc_info = {};
+        alloc_info.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+        // Coherent so that regions can be cleared and read through the persistent mapping without flushes
+        alloc_info.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        VkResult result = vmaCreateBuffer(vma_allocator_, &buffer_info, &alloc_info, &block.buffer, &block.allocation, nullptr);
+        if (result != VK_SUCCESS) return result;
+        result = vmaMapMemory(vma_allocator_, block.allocation, reinterpret_cast<void **>(&block.data));
+        if (result == VK_SUCCESS) {
+            result = desc_set_manager_->GetDescriptorSet(&block.desc_pool, dynamic_desc_layout_, &block.desc_set);
+            if (result != VK_SUCCESS) vmaUnmapMemory(vma_allocator_, block.allocation);
+        }
+        if (result != VK_SUCCESS) {
+            vmaDestroyBuffer(vma_allocator_, block.buffer, block.allocation);
+            return result;
+        }
+
+        current_block_ = static_cast<uint32_t>(blocks_.size());
+        blocks_.push_back(block);
+        UtilOutputRegion first_region;
+        first_region.block = current_block_;
+        VkDescriptorBufferInfo desc_buffer_info = {};
+        VkWriteDescriptorSet desc_write = {};
+        WriteDescriptor(block.desc_set, first_region, true, &desc_buffer_info, &desc_write);
+        DispatchUpdateDescriptorSets(device_, 1, &desc_write, 0, nullptr);
+        return VK_SUCCESS;
+    }
+
+    VkDevice device_;
+    VmaAllocator vma_allocator_;
+    UtilDescriptorSetManager *desc_set_manager_;
+    VkDescriptorSetLayout dynamic_desc_layout_;
+    uint32_t output_binding_;
+    uint32_t region_size_;
+    uint32_t region_stride_;
+    std::vector<Block> blocks_;
+    std::vector<uint32_t> free_blocks_;
+    uint32_t current_block_ = UINT32_MAX;
+};
 VkResult UtilInitializeVma(VkPhysicalDevice physical_device, VkDevice device, VmaAllocator *pAllocator);
 void UtilPreCallRecordCreateDevice(VkPhysicalDevice gpu, safe_VkDeviceCreateInfo *modified_create_info,
                                    VkPhysicalDeviceFeatures supported_features, VkPhysicalDeviceFeatures desired_features);
@@ -76,6 +222,13 @@ void UtilPostCallRecordCreateDevice(const VkDeviceCreateInfo *pCreateInfo, std::
     const VkDescriptorSetLayoutCreateInfo debug_desc_layout_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, NULL, 0,
                                                                     static_cast<uint32_t>(bindings.size()), bindings.data()};
 
+    // The same layout with a dynamic output binding (the first binding), see UtilOutputRegionAllocator
+    std::vector<VkDescriptorSetLayoutBinding> dynamic_bindings = bindings;
+    dynamic_bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    const VkDescriptorSetLayoutCreateInfo dynamic_debug_desc_layout_info = {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, NULL, 0, static_cast<uint32_t>(dynamic_bindings.size()),
+        dynamic_bindings.data()};
+
     const VkDescriptorSetLayoutCreateInfo dummy_desc_layout_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, NULL, 0, 0,
                                                                     NULL};
 
@@ -85,8 +238,11 @@ void UtilPostCallRecordCreateDevice(const VkDeviceCreateInfo *pCreateInfo, std::
     VkResult result2 =
         DispatchCreateDescriptorSetLayout(object_ptr->device, &dummy_desc_layout_info, NULL, &object_ptr->dummy_desc_layout);
 
-    assert((result1 == VK_SUCCESS) && (result2 == VK_SUCCESS));
-    if ((result1 != VK_SUCCESS) || (result2 != VK_SUCCESS)) {
+    VkResult result3 = DispatchCreateDescriptorSetLayout(object_ptr->device, &dynamic_debug_desc_layout_info, NULL,
+                                                         &object_ptr->dynamic_debug_desc_layout);
+
+    assert((result1 == VK_SUCCESS) && (result2 == VK_SUCCESS) && (result3 == VK_SUCCESS));
+    if ((result1 != VK_SUCCESS) || (result2 != VK_SUCCESS) || (result3 != VK_SUCCESS)) {
         object_ptr->ReportSetupProblem(object_ptr->device, "Unable to create descriptor set layout.");
         if (result1 == VK_SUCCESS) {
             DispatchDestroyDescriptorSetLayout(object_ptr->device, object_ptr->debug_desc_layout, NULL);
@@ -94,12 +250,19 @@ void UtilPostCallRecordCreateDevice(const VkDeviceCreateInfo *pCreateInfo, std::
         if (result2 == VK_SUCCESS) {
             DispatchDestroyDescriptorSetLayout(object_ptr->device, object_ptr->dummy_desc_layout, NULL);
         }
+        if (result3 == VK_SUCCESS) {
+            DispatchDestroyDescriptorSetLayout(object_ptr->device, object_ptr->dynamic_debug_desc_layout, NULL);
+        }
         object_ptr->debug_desc_layout = VK_NULL_HANDLE;
         object_ptr->dummy_desc_layout = VK_NULL_HANDLE;
+        object_ptr->dynamic_debug_desc_layout = VK_NULL_HANDLE;
         object_ptr->aborted = true;
         return;
     }
     object_ptr->desc_set_manager = std::move(desc_set_manager);
+    object_ptr->output_region_allocator.reset(new UtilOutputRegionAllocator(
+        object_ptr->device, object_ptr->vmaAllocator, object_ptr->desc_set_manager.get(), object_ptr->dynamic_debug_desc_layout,
+        bindings[0].binding, object_ptr->output_buffer_size, physical_device_properties.limits.minStorageBufferOffsetAlignment));
 
     // Register callback to be called at any ResetCommandBuffer time
     object_ptr->SetCommandBufferResetCallback(
@@ -126,6 +289,11 @@ void UtilPreCallRecordDestroyDevice(ObjectType *object_ptr) {
         DispatchDestroyDescriptorSetLayout(object_ptr->device, object_ptr->dummy_desc_layout, NULL);
         object_ptr->dummy_desc_layout = VK_NULL_HANDLE;
     }
+    if (object_ptr->dynamic_debug_desc_layout) {
+        DispatchDestroyDescriptorSetLayout(object_ptr->device, object_ptr->dynamic_debug_desc_layout, NULL);
+        object_ptr->dynamic_debug_desc_layout = VK_NULL_HANDLE;
+    }
+    object_ptr->output_region_allocator.reset();
     object_ptr->desc_set_manager.reset();
 
     if (object_ptr->vmaAllocator) {
@@ -133,24 +301,55 @@ void UtilPreCallRecordDestroyDevice(ObjectType *object_ptr) {
     }
 }
 
+// The dynamic output binding counts against maxDescriptorSetStorageBuffersDynamic together with the application's own
+// dynamic storage buffers, so pipeline layouts that already use all of them get the static output binding instead.
+// Either binding counts the same against maxPerStageDescriptorStorageBuffers.
+template <typename ObjectType>
+bool UtilUseDynamicOutputBinding(const ObjectType *object_ptr, const VkPipelineLayoutCreateInfo *pCreateInfo) {
+    uint32_t dynamic_storage_buffers = 0;
+    for (uint32_t i = 0; i < pCreateInfo->setLayoutCount; ++i) {
+        const auto set_layout = object_ptr->GetDescriptorSetLayoutShared(pCreateInfo->pSetLayouts[i]);
+        if (!set_layout) continue;
+        for (uint32_t index = 0; index < set_layout->GetBindingCount(); ++index) {
+            const auto *binding = set_layout->GetDescriptorSetLayoutBindingPtrFromIndex(index);
+            if (binding->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC) {
+                dynamic_storage_buffers += binding->descriptorCount;
+            }
+        }
+    }
+    return dynamic_storage_buffers < object_ptr->phys_dev_props.limits.maxDescriptorSetStorageBuffersDynamic;
+}
+
 template <typename ObjectType>
 void UtilPreCallRecordCreatePipelineLayout(create_pipeline_layout_api_state *cpl_state, ObjectType *object_ptr,
                                            const VkPipelineLayoutCreateInfo *pCreateInfo) {
     // Modify the pipeline layout by:
     // 1. Copying the caller's descriptor set desc_layouts
     // 2. Fill in dummy descriptor layouts up to the max binding
-    // 3. Fill in with the debug descriptor layout at the max binding slot
+    // 3. Fill in with the debug descriptor layout at the max binding slot, with a dynamic output binding if there is room
     cpl_state->new_layouts.reserve(object_ptr->adjusted_max_desc_sets);
     cpl_state->new_layouts.insert(cpl_state->new_layouts.end(), &pCreateInfo->pSetLayouts[0],
                                   &pCreateInfo->pSetLayouts[pCreateInfo->setLayoutCount]);
     for (uint32_t i = pCreateInfo->setLayoutCount; i < object_ptr->adjusted_max_desc_sets - 1; ++i) {
         cpl_state->new_layouts.push_back(object_ptr->dummy_desc_layout);
     }
-    cpl_state->new_layouts.push_back(object_ptr->debug_desc_layout);
+    cpl_state->new_layouts.push_back(UtilUseDynamicOutputBinding(object_ptr, pCreateInfo) ? object_ptr->dynamic_debug_desc_layout
+                                                                                          : object_ptr->debug_desc_layout);
     cpl_state->modified_create_info.pSetLayouts = cpl_state->new_layouts.data();
     cpl_state->modified_create_info.setLayoutCount = object_ptr->adjusted_max_desc_sets;
 }
 
+template <typename ObjectType>
+void UtilPostCallRecordCreatePipelineLayout(ObjectType *object_ptr, const VkPipelineLayoutCreateInfo *pCreateInfo,
+                                            VkPipelineLayout pipeline_layout) {
+    // Remember which layouts got the dynamic output binding, so that commands know how to bind their output region
+    if (UtilUseDynamicOutputBinding(object_ptr, pCreateInfo)) {
+        object_ptr->dynamic_output_pipeline_layouts.insert(pipeline_layout);
+    } else {
+        object_ptr->dynamic_output_pipeline_layouts.erase(pipeline_layout);
+    }
+}
+
 template <typename CreateInfo>
 struct CreatePipelineTraits {};
 template <>
@@ -306,12 +505,12 @@ void UtilPostCallRecordPipelineCreations(const uint32_t count, const CreateInfo
                 assert(false);
             }
 
-            std::vector<unsigned int> code;
+            SpirvBlob code;
             // Save the shader binary
             // The core_validation ShaderModule tracker saves the binary too, but discards it when the ShaderModule
             // is destroyed.  Applications may destroy ShaderModules after they are placed in a pipeline and before
-            // the pipeline is used, so we have to keep another copy.
-            if (shader_state && shader_state->has_valid_spirv) code = shader_state->words;
+            // the pipeline is used, so we have to keep another reference.
+            if (shader_state && shader_state->has_valid_spirv) code = shader_state->spirv;
 
             object_ptr->shader_map[shader_state->gpu_validation_shader_id].pipeline = pipeline_state->pipeline;
             // Be careful to use the originally bound (instrumented) shader here, even if PreCallRecord had to back it
@@ -336,14 +535,12 @@ template <typename ObjectType>
 // For the given command buffer, map its debug data buffers and read their contents for analysis.
 void UtilProcessInstrumentationBuffer(VkQueue queue, CMD_BUFFER_STATE *cb_node, ObjectType *object_ptr) {
     if (cb_node && (cb_node->hasDrawCmd || cb_node->hasTraceRaysCmd || cb_node->hasDispatchCmd)) {
-        auto gpu_buffer_list = object_ptr->GetBufferInfo(cb_node->commandBuffer);
+        const auto &gpu_buffer_list = object_ptr->GetBufferInfo(cb_node->commandBuffer);
         uint32_t draw_index = 0;
         uint32_t compute_index = 0;
         uint32_t ray_trace_index = 0;
 
         for (auto &buffer_info : gpu_buffer_list) {
-            char *pData;
-
             uint32_t operation_index = 0;
             if (buffer_info.pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
                 operation_index = draw_index;
@@ -355,12 +552,8 @@ void UtilProcessInstrumentationBuffer(VkQueue queue, CMD_BUFFER_STATE *cb_node,
                 assert(false);
             }
 
-            VkResult result = vmaMapMemory(object_ptr->vmaAllocator, buffer_info.output_mem_block.allocation, (void **)&pData);
-            if (result == VK_SUCCESS) {
-                object_ptr->AnalyzeAndGenerateMessages(cb_node->commandBuffer, queue, buffer_info.pipeline_bind_point,
-                                                       operation_index, (uint32_t *)pData);
-                vmaUnmapMemory(object_ptr->vmaAllocator, buffer_info.output_mem_block.allocation);
-            }
+            object_ptr->AnalyzeAndGenerateMessages(cb_node->commandBuffer, queue, buffer_info.pipeline_bind_point, operation_index,
+                                                   buffer_info.output_region.data);
 
             if (buffer_info.pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS) {
                 draw_index++;
@@ -377,7 +570,8 @@ void UtilProcessInstrumentationBuffer(VkQueue queue, CMD_BUFFER_STATE *cb_node,
 template <typename ObjectType>
 // Submit a memory barrier on graphics queues.
 // Lazy-create and record the needed command buffer.
-void UtilSubmitBarrier(VkQueue queue, ObjectType *object_ptr) {
+// If a fence is given, it is signaled once the barrier (and so all earlier work on the queue) has completed.
+void UtilSubmitBarrier(VkQueue queue, ObjectType *object_ptr, VkFence fence = VK_NULL_HANDLE) {
     auto queue_barrier_command_info_it = object_ptr->queue_barrier_command_infos.emplace(queue, UtilQueueBarrierCommandInfo{});
     if (queue_barrier_command_info_it.second) {
         UtilQueueBarrierCommandInfo &queue_barrier_command_info = queue_barrier_command_info_it.first->second;
@@ -421,8 +615,10 @@ void UtilSubmitBarrier(VkQueue queue, ObjectType *object_ptr) {
         object_ptr->vkSetDeviceLoaderData(object_ptr->device, queue_barrier_command_info.barrier_command_buffer);
 
         // Record a global memory barrier to force availability of device memory operations to the host domain.
+        // Readback with a fence doesn't wait for the previous barrier submission, so the command buffer may still be pending.
         VkCommandBufferBeginInfo command_buffer_begin_info = {};
         command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
         result = DispatchBeginCommandBuffer(queue_barrier_command_info.barrier_command_buffer, &command_buffer_begin_info);
         if (result == VK_SUCCESS) {
             VkMemoryBarrier memory_barrier = {};
@@ -442,7 +638,9 @@ void UtilSubmitBarrier(VkQueue queue, ObjectType *object_ptr) {
         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submit_info.commandBufferCount = 1;
         submit_info.pCommandBuffers = &queue_barrier_command_info.barrier_command_buffer;
-        DispatchQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
+        DispatchQueueSubmit(queue, 1, &submit_info, fence);
+    } else if (fence != VK_NULL_HANDLE) {
+        DispatchQueueSubmit(queue, 0, nullptr, fence);
     }
 }
 void UtilGenerateStageMessage(const uint32_t *debug_record, std::string &msg);
@@ -450,5 +648,5 @@ void UtilGenerateCommonMessage(const debug_report_data *report_data, const VkCom
                                const uint32_t *debug_record, const VkShaderModule shader_module_handle,
                                const VkPipeline pipeline_handle, const VkPipelineBindPoint pipeline_bind_point,
                                const uint32_t operation_index, std::string &msg);
-void UtilGenerateSourceMessages(const std::vector<unsigned int> &pgm, const uint32_t *debug_record, bool from_printf,
-                                std::string &filename_msg, std::string &source_msg);
+void UtilGenerateSourceMessages(const SpirvBlob &pgm, const uint32_t *debug_record, bool from_printf, std::string &filename_msg,
+                                std::string &source_msg);
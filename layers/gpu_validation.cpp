@@ -18,10 +18,20 @@
  * Author: Tony Barbour <tony@lunarg.com>
  */
 
+#include <algorithm>
+#include <fstream>
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "gpu_validation.h"
 #include "spirv-tools/optimizer.hpp"
 #include "spirv-tools/instrument.hpp"
 #include "layer_chassis_dispatch.h"
+#include "xxhash.h"
+#include <generated/spirv_tools_commit_id.h>
 
 static const VkShaderStageFlags kShaderStageAllRayTracing =
     VK_SHADER_STAGE_ANY_HIT_BIT_NV | VK_SHADER_STAGE_CALLABLE_BIT_NV | VK_SHADER_STAGE_CLOSEST_HIT_BIT_NV |
@@ -263,6 +273,16 @@ void GpuAssisted::PostCallRecordCreateDevice(VkPhysicalDevice physicalDevice, co
     device_gpu_assisted->device = *pDevice;
     device_gpu_assisted->output_buffer_size = sizeof(uint32_t) * (spvtools::kInstMaxOutCnt + 1);
     device_gpu_assisted->descriptor_indexing = CheckForDescriptorIndexing(device_gpu_assisted->enabled_features);
+    // The environment variables take precedence over the settings file
+    std::string cache_path = GetLayerEnvVar("VK_LAYER_GPU_VALIDATION_SHADER_CACHE_PATH");
+    if (cache_path.empty()) cache_path = getLayerOption("khronos_validation.gpu_validation_shader_cache_path");
+    if (!cache_path.empty()) {
+        std::string cache_size_string = GetLayerEnvVar("VK_LAYER_GPU_VALIDATION_SHADER_CACHE_SIZE");
+        if (cache_size_string.empty()) cache_size_string = getLayerOption("khronos_validation.gpu_validation_shader_cache_size");
+        const size_t cache_size_mb = cache_size_string.empty() ? 256 : atoi(cache_size_string.c_str());
+        device_gpu_assisted->shader_cache.reset(new GpuAssistedShaderCache());
+        device_gpu_assisted->shader_cache->Load(cache_path, cache_size_mb * 1024 * 1024);
+    }
     std::vector<VkDescriptorSetLayoutBinding> bindings;
     VkDescriptorSetLayoutBinding binding = {0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1,
                                             VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT | kShaderStageAllRayTracing,
@@ -304,6 +324,12 @@ void GpuAssisted::PreCallRecordDestroyBuffer(VkDevice device, VkBuffer buffer, c
 
 // Clean up device-related resources
 void GpuAssisted::PreCallRecordDestroyDevice(VkDevice device, const VkAllocationCallbacks *pAllocator) {
+    ProcessPendingReadbacks(true);
+    for (auto fence : readback_fence_pool) {
+        DispatchDestroyFence(device, fence, nullptr);
+    }
+    readback_fence_pool.clear();
+    if (shader_cache) shader_cache->Save();
     DestroyAccelerationStructureBuildValidationState();
     UtilPreCallRecordDestroyDevice(this);
     ValidationStateTracker::PreCallRecordDestroyDevice(device, pAllocator);
@@ -763,7 +789,7 @@ void GpuAssisted::PreCallRecordCmdBuildAccelerationStructureNV(VkCommandBuffer c
     assert(cb_state != nullptr);
 
     std::vector<uint64_t> current_valid_handles;
-    for (const auto &as_state_kv : accelerationStructureMap) {
+    for (const auto &as_state_kv : accelerationStructureMap.snapshot()) {
         const ACCELERATION_STRUCTURE_STATE &as_state = *as_state_kv.second;
         if (as_state.built && as_state.create_infoNV.info.type == VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_NV) {
             current_valid_handles.push_back(as_state.opaque_handle);
@@ -980,7 +1006,15 @@ void GpuAssisted::PostCallRecordCreatePipelineLayout(VkDevice device, const VkPi
     if (result != VK_SUCCESS) {
         ReportSetupProblem(device, "Unable to create pipeline layout.  Device could become unstable.");
         aborted = true;
+        return;
     }
+    UtilPostCallRecordCreatePipelineLayout(this, pCreateInfo, *pPipelineLayout);
+}
+
+void GpuAssisted::PreCallRecordDestroyPipelineLayout(VkDevice device, VkPipelineLayout pipelineLayout,
+                                                     const VkAllocationCallbacks *pAllocator) {
+    dynamic_output_pipeline_layouts.erase(pipelineLayout);
+    ValidationStateTracker::PreCallRecordDestroyPipelineLayout(device, pipelineLayout, pAllocator);
 }
 
 // Free the device memory and descriptor set associated with a command buffer.
@@ -988,9 +1022,11 @@ void GpuAssisted::ResetCommandBuffer(VkCommandBuffer commandBuffer) {
     if (aborted) {
         return;
     }
+    // Results still in flight have to be read before the buffers they are written to go away
+    WaitForPendingReadback(commandBuffer);
     auto gpuav_buffer_list = GetBufferInfo(commandBuffer);
     for (auto buffer_info : gpuav_buffer_list) {
-        vmaDestroyBuffer(vmaAllocator, buffer_info.output_mem_block.buffer, buffer_info.output_mem_block.allocation);
+        output_region_allocator->Release(buffer_info.output_region);
         if (buffer_info.di_input_mem_block.buffer) {
             vmaDestroyBuffer(vmaAllocator, buffer_info.di_input_mem_block.buffer, buffer_info.di_input_mem_block.allocation);
         }
@@ -1154,12 +1190,166 @@ void GpuAssisted::PreCallRecordDestroyPipeline(VkDevice device, VkPipeline pipel
     ValidationStateTracker::PreCallRecordDestroyPipeline(device, pipeline, pAllocator);
 }
 
-// Call the SPIR-V Optimizer to run the instrumentation pass on the shader.
+static const uint32_t kShaderCacheMagic = 0x43534147;  // "GASC"
+static const uint32_t kShaderCacheVersion = 1;
+
+static uint64_t ProcessId() {
+#if defined(_WIN32)
+    return _getpid();
+#else
+    return getpid();
+#endif
+}
+
+static uint64_t SpirvToolsHash() { return XXH64(SPIRV_TOOLS_COMMIT_ID, strlen(SPIRV_TOOLS_COMMIT_ID), 0); }
+
+// The file holds a header followed by entries of {key, word count, words}, most recently used first
+void GpuAssistedShaderCache::Load(const std::string &path, size_t max_size) {
+    path_ = path;
+    max_size_ = max_size;
+    std::ifstream file(path_, std::ios::binary);
+    if (!file) return;
+
+    uint32_t header[2] = {};
+    uint64_t tools_hash = 0;
+    uint32_t entry_count = 0;
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    file.read(reinterpret_cast<char *>(&tools_hash), sizeof(tools_hash));
+    file.read(reinterpret_cast<char *>(&entry_count), sizeof(entry_count));
+    // Entries made with another SPIRV-Tools can never be hit again, so drop the whole file
+    if (!file || header[0] != kShaderCacheMagic || header[1] != kShaderCacheVersion || tools_hash != SpirvToolsHash()) return;
+
+    use_count_ = entry_count;
+    for (uint32_t i = 0; i < entry_count; i++) {
+        uint64_t key = 0;
+        uint32_t word_count = 0;
+        file.read(reinterpret_cast<char *>(&key), sizeof(key));
+        file.read(reinterpret_cast<char *>(&word_count), sizeof(word_count));
+        if (!file || word_count > max_size_ / sizeof(unsigned int)) break;
+        Entry entry;
+        entry.pgm.resize(word_count);
+        entry.last_use = entry_count - i;
+        file.read(reinterpret_cast<char *>(entry.pgm.data()), word_count * sizeof(unsigned int));
+        if (!file) break;
+        entries_.emplace(key, std::move(entry));
+    }
+}
+
+void GpuAssistedShaderCache::Save() {
+    // Only hits since the last load would change, not worth rewriting the file for
+    if (!dirty_) return;
+
+    typedef std::pair<uint64_t, const Entry *> KeyedEntry;
+    std::vector<KeyedEntry> order;
+    order.reserve(entries_.size());
+    for (const auto &entry : entries_) {
+        order.emplace_back(entry.first, &entry.second);
+    }
+    std::sort(order.begin(), order.end(),
+              [](const KeyedEntry &a, const KeyedEntry &b) { return a.second->last_use > b.second->last_use; });
+    const size_t header_size = 3 * sizeof(uint32_t) + sizeof(uint64_t);
+    size_t size = header_size;
+    uint32_t entry_count = 0;
+    for (const auto &entry : order) {
+        const size_t entry_size = sizeof(uint64_t) + sizeof(uint32_t) + entry.second->pgm.size() * sizeof(unsigned int);
+        if (size + entry_size > max_size_) break;
+        size += entry_size;
+        entry_count++;
+    }
+
+    // Write to a temporary file and swap it in once complete, so that a crash never leaves a truncated cache behind. The
+    // name is unique to this process and device, as others may be saving to the same cache at the same time.
+    const std::string temp_path = path_ + "." + std::to_string(ProcessId()) + "." +
+                                  std::to_string(reinterpret_cast<uintptr_t>(this)) + ".tmp";
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    if (!file) return;
+    const uint32_t header[2] = {kShaderCacheMagic, kShaderCacheVersion};
+    const uint64_t tools_hash = SpirvToolsHash();
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(&tools_hash), sizeof(tools_hash));
+    file.write(reinterpret_cast<const char *>(&entry_count), sizeof(entry_count));
+    for (uint32_t i = 0; i < entry_count; i++) {
+        const auto &pgm = order[i].second->pgm;
+        const uint32_t word_count = static_cast<uint32_t>(pgm.size());
+        file.write(reinterpret_cast<const char *>(&order[i].first), sizeof(order[i].first));
+        file.write(reinterpret_cast<const char *>(&word_count), sizeof(word_count));
+        file.write(reinterpret_cast<const char *>(pgm.data()), word_count * sizeof(unsigned int));
+    }
+    file.close();
+    if (!file) {
+        std::remove(temp_path.c_str());
+        return;
+    }
+#if defined(_WIN32)
+    // Only POSIX rename replaces an existing file
+    std::remove(path_.c_str());
+#endif
+    if (std::rename(temp_path.c_str(), path_.c_str()) == 0) {
+        dirty_ = false;
+    } else {
+        std::remove(temp_path.c_str());
+    }
+}
+
+bool GpuAssistedShaderCache::Get(uint64_t key, std::vector<unsigned int> &pgm) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    pgm = it->second.pgm;
+    it->second.last_use = ++use_count_;
+    return true;
+}
+
+void GpuAssistedShaderCache::Put(uint64_t key, const std::vector<unsigned int> &pgm) {
+    auto &entry = entries_[key];
+    entry.pgm = pgm;
+    entry.last_use = ++use_count_;
+    dirty_ = true;
+}
+
+// Hand out a shader id for the module, reusing an instrumented binary from the shader cache when there is one.
 bool GpuAssisted::InstrumentShader(const VkShaderModuleCreateInfo *pCreateInfo, std::vector<unsigned int> &new_pgm,
                                    uint32_t *unique_shader_id) {
     if (aborted) return false;
     if (pCreateInfo->pCode[0] != spv::MagicNumber) return false;
 
+    if (!shader_cache) {
+        bool pass = RunInstrumentation(pCreateInfo, unique_shader_module_id, new_pgm);
+        *unique_shader_id = unique_shader_module_id++;
+        return pass;
+    }
+
+    // The key covers the SPIR-V and every option that changes the instrumentation. The shader id is taken from the key,
+    // so it is covered as well, and identical modules share an id just like one module used by several pipelines.
+    const bool buffer_device_address =
+        (device_extensions.vk_ext_buffer_device_address || device_extensions.vk_khr_buffer_device_address) && shaderInt64 &&
+        enabled_features.core12.bufferDeviceAddress;
+    const spv_target_env target_env = PickSpirvEnv(api_version, (device_extensions.vk_khr_spirv_1_4 != kNotEnabled));
+    const uint32_t options[] = {kShaderCacheVersion, static_cast<uint32_t>(target_env), desc_set_bind_index, descriptor_indexing,
+                                buffer_device_address};
+    const uint64_t key = XXH64(pCreateInfo->pCode, pCreateInfo->codeSize, XXH64(options, sizeof(options), SpirvToolsHash()));
+    const uint32_t shader_id = static_cast<uint32_t>(key);
+    auto id_it = cached_shader_ids.find(shader_id);
+    if (shader_id != UINT32_MAX && (id_it == cached_shader_ids.end() || id_it->second == key)) {
+        cached_shader_ids[shader_id] = key;
+        *unique_shader_id = shader_id;
+        if (shader_cache->Get(key, new_pgm)) return true;
+        bool pass = RunInstrumentation(pCreateInfo, shader_id, new_pgm);
+        if (pass) shader_cache->Put(key, new_pgm);
+        return pass;
+    }
+
+    // Another shader already owns the id derived from this one's key, so instrument it uncached with an unused id
+    while (unique_shader_module_id == UINT32_MAX || cached_shader_ids.count(unique_shader_module_id)) {
+        unique_shader_module_id++;
+    }
+    cached_shader_ids[unique_shader_module_id] = 0;
+    *unique_shader_id = unique_shader_module_id++;
+    return RunInstrumentation(pCreateInfo, *unique_shader_id, new_pgm);
+}
+
+// Call the SPIR-V Optimizer to run the instrumentation pass on the shader.
+bool GpuAssisted::RunInstrumentation(const VkShaderModuleCreateInfo *pCreateInfo, uint32_t shader_id,
+                                     std::vector<unsigned int> &new_pgm) {
     const spvtools::MessageConsumer GpuConsoleMessageConsumer =
         [this](spv_message_level_t level, const char *, const spv_position_t &position, const char *message) -> void {
         switch (level) {
@@ -1181,23 +1371,22 @@ bool GpuAssisted::InstrumentShader(const VkShaderModuleCreateInfo *pCreateInfo,
     new_pgm.insert(new_pgm.end(), &pCreateInfo->pCode[0], &pCreateInfo->pCode[num_words]);
 
     // Call the optimizer to instrument the shader.
-    // Use the unique_shader_module_id as a shader ID so we can look up its handle later in the shader_map.
+    // Use the shader_id as a shader ID so we can look up its handle later in the shader_map.
     // If descriptor indexing is enabled, enable length checks and updated descriptor checks
     using namespace spvtools;
     spv_target_env target_env = PickSpirvEnv(api_version, (device_extensions.vk_khr_spirv_1_4 != kNotEnabled));
     Optimizer optimizer(target_env);
     optimizer.SetMessageConsumer(GpuConsoleMessageConsumer);
     optimizer.RegisterPass(
-        CreateInstBindlessCheckPass(desc_set_bind_index, unique_shader_module_id, descriptor_indexing, descriptor_indexing));
+        CreateInstBindlessCheckPass(desc_set_bind_index, shader_id, descriptor_indexing, descriptor_indexing));
     optimizer.RegisterPass(CreateAggressiveDCEPass());
     if ((device_extensions.vk_ext_buffer_device_address || device_extensions.vk_khr_buffer_device_address) && shaderInt64 &&
         enabled_features.core12.bufferDeviceAddress)
-        optimizer.RegisterPass(CreateInstBuffAddrCheckPass(desc_set_bind_index, unique_shader_module_id));
+        optimizer.RegisterPass(CreateInstBuffAddrCheckPass(desc_set_bind_index, shader_id));
     bool pass = optimizer.Run(new_pgm.data(), new_pgm.size(), &new_pgm);
     if (!pass) {
         ReportSetupProblem(device, "Failure to instrument shader.  Proceeding with non-instrumented shader.");
     }
-    *unique_shader_id = unique_shader_module_id++;
     return pass;
 }
 // Create the instrumented shader data to provide to the driver.
@@ -1273,7 +1462,7 @@ void GpuAssisted::AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQ
     std::string vuid_msg;
     VkShaderModule shader_module_handle = VK_NULL_HANDLE;
     VkPipeline pipeline_handle = VK_NULL_HANDLE;
-    std::vector<unsigned int> pgm;
+    SpirvBlob pgm;
     // The first record starts at this offset after the total_words.
     const uint32_t *debug_record = &debug_output_buffer[kDebugOutputDataOffset];
     // Lookup the VkShaderModule handle and SPIR-V code used to create the shader, using the unique shader ID value returned
@@ -1315,10 +1504,16 @@ void GpuAssisted::UpdateInstrumentationBuffer(CMD_BUFFER_STATE *cb_node) {
 }
 
 void GpuAssisted::PreCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence) {
+    ProcessPendingReadbacks(false);
     for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
         const VkSubmitInfo *submit = &pSubmits[submit_idx];
         for (uint32_t i = 0; i < submit->commandBufferCount; i++) {
             auto cb_node = GetCBState(submit->pCommandBuffers[i]);
+            // A simultaneous use resubmission writes to the same output buffers, so the previous results must be read first
+            WaitForPendingReadback(cb_node->commandBuffer);
+            for (auto secondaryCmdBuffer : cb_node->linkedCommandBuffers) {
+                WaitForPendingReadback(secondaryCmdBuffer->commandBuffer);
+            }
             UpdateInstrumentationBuffer(cb_node);
             for (auto secondaryCmdBuffer : cb_node->linkedCommandBuffers) {
                 UpdateInstrumentationBuffer(secondaryCmdBuffer);
@@ -1350,6 +1545,11 @@ void GpuAssisted::PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount,
     }
     if (!buffers_present) return;
 
+    if (enabled[gpu_validation_async_readback]) {
+        QueueReadback(queue, submitCount, pSubmits);
+        return;
+    }
+
     UtilSubmitBarrier(queue, this);
 
     DispatchQueueWaitIdle(queue);
@@ -1368,6 +1568,107 @@ void GpuAssisted::PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount,
     }
 }
 
+// Follow the submission with the host barrier and a layer owned fence, and read the results back once that fence signals.
+// The command buffer handles and the order of their output buffers are unchanged by then, so errors are reported against
+// the same command buffer and draw index as a synchronous readback would.
+void GpuAssisted::QueueReadback(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits) {
+    VkFence fence = VK_NULL_HANDLE;
+    if (!readback_fence_pool.empty()) {
+        fence = readback_fence_pool.back();
+        readback_fence_pool.pop_back();
+    } else {
+        VkFenceCreateInfo fence_create_info = {};
+        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (DispatchCreateFence(device, &fence_create_info, nullptr, &fence) != VK_SUCCESS) {
+            ReportSetupProblem(device, "Unable to create readback fence.  Device could become unstable.");
+            aborted = true;
+            return;
+        }
+    }
+
+    GpuAssistedPendingReadback readback = {queue, fence, {}};
+    for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
+        const VkSubmitInfo *submit = &pSubmits[submit_idx];
+        for (uint32_t i = 0; i < submit->commandBufferCount; i++) {
+            auto cb_node = GetCBState(submit->pCommandBuffers[i]);
+            readback.command_buffers.push_back(cb_node->commandBuffer);
+            for (auto secondaryCmdBuffer : cb_node->linkedCommandBuffers) {
+                readback.command_buffers.push_back(secondaryCmdBuffer->commandBuffer);
+            }
+        }
+    }
+    UtilSubmitBarrier(queue, this, fence);
+    pending_readbacks.emplace_back(std::move(readback));
+}
+
+void GpuAssisted::ProcessCommandBufferReadback(VkQueue queue, CMD_BUFFER_STATE *cb_node) {
+    UtilProcessInstrumentationBuffer(queue, cb_node, this);
+    ProcessAccelerationStructureBuildValidationBuffer(queue, cb_node);
+}
+
+// Report the results of every pending submission that has completed, or wait for all of them if wait_all is set
+void GpuAssisted::ProcessPendingReadbacks(bool wait_all) {
+    for (auto it = pending_readbacks.begin(); it != pending_readbacks.end();) {
+        VkResult result = wait_all ? DispatchWaitForFences(device, 1, &it->fence, VK_TRUE, UINT64_MAX)
+                                   : DispatchGetFenceStatus(device, it->fence);
+        if (result != VK_SUCCESS) {
+            ++it;
+            continue;
+        }
+        for (auto command_buffer : it->command_buffers) {
+            ProcessCommandBufferReadback(it->queue, GetCBState(command_buffer));
+        }
+        DispatchResetFences(device, 1, &it->fence);
+        readback_fence_pool.push_back(it->fence);
+        it = pending_readbacks.erase(it);
+    }
+}
+
+// Block until every pending submission of command_buffer has completed and report its results, along with those of any
+// earlier submissions, so errors stay in submission order.
+void GpuAssisted::WaitForPendingReadback(VkCommandBuffer command_buffer) {
+    auto last = pending_readbacks.end();
+    for (auto it = pending_readbacks.begin(); it != pending_readbacks.end(); ++it) {
+        if (std::find(it->command_buffers.begin(), it->command_buffers.end(), command_buffer) != it->command_buffers.end()) {
+            last = it;
+        }
+    }
+    if (last == pending_readbacks.end()) return;
+
+    const auto count = std::distance(pending_readbacks.begin(), last) + 1;
+    for (decltype(count) i = 0; i < count; ++i) {
+        auto &readback = pending_readbacks.front();
+        DispatchWaitForFences(device, 1, &readback.fence, VK_TRUE, UINT64_MAX);
+        for (auto cb : readback.command_buffers) {
+            ProcessCommandBufferReadback(readback.queue, GetCBState(cb));
+        }
+        DispatchResetFences(device, 1, &readback.fence);
+        readback_fence_pool.push_back(readback.fence);
+        pending_readbacks.pop_front();
+    }
+}
+
+void GpuAssisted::PostCallRecordQueueWaitIdle(VkQueue queue, VkResult result) {
+    ValidationStateTracker::PostCallRecordQueueWaitIdle(queue, result);
+    ProcessPendingReadbacks(false);
+}
+
+void GpuAssisted::PostCallRecordDeviceWaitIdle(VkDevice device, VkResult result) {
+    ValidationStateTracker::PostCallRecordDeviceWaitIdle(device, result);
+    ProcessPendingReadbacks(false);
+}
+
+void GpuAssisted::PostCallRecordWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence *pFences, VkBool32 waitAll,
+                                              uint64_t timeout, VkResult result) {
+    ValidationStateTracker::PostCallRecordWaitForFences(device, fenceCount, pFences, waitAll, timeout, result);
+    ProcessPendingReadbacks(false);
+}
+
+void GpuAssisted::PostCallRecordGetFenceStatus(VkDevice device, VkFence fence, VkResult result) {
+    ValidationStateTracker::PostCallRecordGetFenceStatus(device, fence, result);
+    ProcessPendingReadbacks(false);
+}
+
 void GpuAssisted::PreCallRecordCmdDraw(VkCommandBuffer commandBuffer, uint32_t vertexCount, uint32_t instanceCount,
                                        uint32_t firstVertex, uint32_t firstInstance) {
     AllocateValidationResources(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS);
@@ -1464,19 +1765,6 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
 
     if (aborted) return;
 
-    std::vector<VkDescriptorSet> desc_sets;
-    VkDescriptorPool desc_pool = VK_NULL_HANDLE;
-    result = desc_set_manager->GetDescriptorSets(1, &desc_pool, debug_desc_layout, &desc_sets);
-    assert(result == VK_SUCCESS);
-    if (result != VK_SUCCESS) {
-        ReportSetupProblem(device, "Unable to allocate descriptor sets.  Device could become unstable.");
-        aborted = true;
-        return;
-    }
-
-    VkDescriptorBufferInfo output_desc_buffer_info = {};
-    output_desc_buffer_info.range = output_buffer_size;
-
     auto cb_node = GetCBState(cmd_buffer);
     if (!cb_node) {
         ReportSetupProblem(device, "Unrecognized command buffer");
@@ -1484,39 +1772,52 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
         return;
     }
 
-    // Allocate memory for the output block that the gpu will use to return any error information
-    GpuAssistedDeviceMemoryBlock output_block = {};
-    VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
-    bufferInfo.size = output_buffer_size;
-    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
-    VmaAllocationCreateInfo allocInfo = {};
-    allocInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
-    result = vmaCreateBuffer(vmaAllocator, &bufferInfo, &allocInfo, &output_block.buffer, &output_block.allocation, nullptr);
+    // Get a zeroed output region that the gpu will use to return any error information
+    UtilOutputRegion output_region;
+    result = output_region_allocator->Allocate(&output_region);
     if (result != VK_SUCCESS) {
         ReportSetupProblem(device, "Unable to allocate device memory.  Device could become unstable.");
         aborted = true;
         return;
     }
 
-    // Clear the output block to zeros so that only error information from the gpu will be present
-    uint32_t *pData;
-    result = vmaMapMemory(vmaAllocator, output_block.allocation, (void **)&pData);
-    if (result == VK_SUCCESS) {
-        memset(pData, 0, output_buffer_size);
-        vmaUnmapMemory(vmaAllocator, output_block.allocation);
+    auto const &state = cb_node->lastBound[bind_point];
+    uint32_t number_of_sets = (uint32_t)state.per_set.size();
+    const bool use_di_input = number_of_sets > 0 && descriptor_indexing;
+    const bool use_bda_input = (device_extensions.vk_ext_buffer_device_address || device_extensions.vk_khr_buffer_device_address) &&
+                               buffer_map.size() && shaderInt64 && enabled_features.core12.bufferDeviceAddress;
+
+    // Commands without input buffers share the descriptor set of their output region's block, unless the pipeline layout
+    // had no room for the dynamic output binding
+    const bool dynamic_output =
+        state.pipeline_state && dynamic_output_pipeline_layouts.count(state.pipeline_state->pipeline_layout->layout) != 0;
+    VkDescriptorSet desc_set = output_region_allocator->GetDescriptorSet(output_region);
+    VkDescriptorPool desc_pool = VK_NULL_HANDLE;
+    if (use_di_input || use_bda_input || !dynamic_output) {
+        result = desc_set_manager->GetDescriptorSet(&desc_pool, dynamic_output ? dynamic_debug_desc_layout : debug_desc_layout,
+                                                    &desc_set);
+        assert(result == VK_SUCCESS);
+        if (result != VK_SUCCESS) {
+            ReportSetupProblem(device, "Unable to allocate descriptor sets.  Device could become unstable.");
+            output_region_allocator->Release(output_region);
+            aborted = true;
+            return;
+        }
     }
 
+    VkBufferCreateInfo bufferInfo = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    VmaAllocationCreateInfo allocInfo = {};
     GpuAssistedDeviceMemoryBlock di_input_block = {}, bda_input_block = {};
+    VkDescriptorBufferInfo output_desc_buffer_info = {};
     VkDescriptorBufferInfo di_input_desc_buffer_info = {};
     VkDescriptorBufferInfo bda_input_desc_buffer_info = {};
     VkWriteDescriptorSet desc_writes[3] = {};
     uint32_t desc_count = 1;
-    auto const &state = cb_node->lastBound[bind_point];
-    uint32_t number_of_sets = (uint32_t)state.per_set.size();
 
     // Figure out how much memory we need for the input block based on how many sets and bindings there are
     // and how big each of the bindings is
-    if (number_of_sets > 0 && descriptor_indexing) {
+    if (use_di_input) {
         uint32_t descriptor_count = 0;  // Number of descriptors, including all array elements
         uint32_t binding_count = 0;     // Number of bindings based on the max binding number used
         for (auto s : state.per_set) {
@@ -1560,6 +1861,7 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
         // Populate input buffer first with the sizes of every descriptor in every set, then with whether
         // each element of each descriptor has been written or not.  See gpu_validation.md for a more thourough
         // outline of the input buffer format
+        uint32_t *pData;
         result = vmaMapMemory(vmaAllocator, di_input_block.allocation, (void **)&pData);
         memset(pData, 0, static_cast<size_t>(bufferInfo.size));
         // Pointer to a sets array that points into the sizes array
@@ -1639,13 +1941,12 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
         desc_writes[1].descriptorCount = 1;
         desc_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         desc_writes[1].pBufferInfo = &di_input_desc_buffer_info;
-        desc_writes[1].dstSet = desc_sets[0];
+        desc_writes[1].dstSet = desc_set;
 
         desc_count = 2;
     }
 
-    if ((device_extensions.vk_ext_buffer_device_address || device_extensions.vk_khr_buffer_device_address) && buffer_map.size() &&
-        shaderInt64 && enabled_features.core12.bufferDeviceAddress) {
+    if (use_bda_input) {
         // Example BDA input buffer assuming 2 buffers using BDA:
         // Word 0 | Index of start of buffer sizes (in this case 5)
         // Word 1 | 0x0000000000000000
@@ -1694,20 +1995,15 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
         desc_writes[desc_count].descriptorCount = 1;
         desc_writes[desc_count].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         desc_writes[desc_count].pBufferInfo = &bda_input_desc_buffer_info;
-        desc_writes[desc_count].dstSet = desc_sets[0];
+        desc_writes[desc_count].dstSet = desc_set;
         desc_count++;
     }
 
-    // Write the descriptor
-    output_desc_buffer_info.buffer = output_block.buffer;
-    output_desc_buffer_info.offset = 0;
-
-    desc_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    desc_writes[0].descriptorCount = 1;
-    desc_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    desc_writes[0].pBufferInfo = &output_desc_buffer_info;
-    desc_writes[0].dstSet = desc_sets[0];
-    DispatchUpdateDescriptorSets(device, desc_count, desc_writes, 0, NULL);
+    if (desc_pool != VK_NULL_HANDLE) {
+        output_region_allocator->WriteDescriptor(desc_set, output_region, dynamic_output, &output_desc_buffer_info,
+                                                 &desc_writes[0]);
+        DispatchUpdateDescriptorSets(device, desc_count, desc_writes, 0, NULL);
+    }
 
     auto iter = cb_node->lastBound.find(bind_point);  // find() allows read-only access to cb_state
     if (iter != cb_node->lastBound.end()) {
@@ -1715,15 +2011,16 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
         if (pipeline_state && (pipeline_state->pipeline_layout->set_layouts.size() <= desc_set_bind_index) &&
             !pipeline_state->pipeline_layout->destroyed) {
             DispatchCmdBindDescriptorSets(cmd_buffer, bind_point, pipeline_state->pipeline_layout->layout, desc_set_bind_index, 1,
-                                          desc_sets.data(), 0, nullptr);
+                                          &desc_set, dynamic_output ? 1 : 0, dynamic_output ? &output_region.offset : nullptr);
         }
         if (pipeline_state && pipeline_state->pipeline_layout->destroyed) {
             ReportSetupProblem(device, "Pipeline layout has been destroyed, aborting GPU-AV");
             aborted = true;
         } else {
-            // Record buffer and memory info in CB state tracking
+            // Record buffer and memory info in CB state tracking. A shared descriptor set isn't ours to give back.
             GetBufferInfo(cmd_buffer)
-                .emplace_back(output_block, di_input_block, bda_input_block, desc_sets[0], desc_pool, bind_point);
+                .emplace_back(output_region, di_input_block, bda_input_block,
+                              desc_pool != VK_NULL_HANDLE ? desc_set : VK_NULL_HANDLE, desc_pool, bind_point);
         }
     } else {
         ReportSetupProblem(device, "Unable to find pipeline state");
@@ -1732,7 +2029,7 @@ void GpuAssisted::AllocateValidationResources(const VkCommandBuffer cmd_buffer,
     if (aborted) {
         vmaDestroyBuffer(vmaAllocator, di_input_block.buffer, di_input_block.allocation);
         vmaDestroyBuffer(vmaAllocator, bda_input_block.buffer, bda_input_block.allocation);
-        vmaDestroyBuffer(vmaAllocator, output_block.buffer, output_block.allocation);
+        output_region_allocator->Release(output_region);
         return;
     }
 }
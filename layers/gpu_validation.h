@@ -33,16 +33,16 @@ struct GpuAssistedDeviceMemoryBlock {
 };
 
 struct GpuAssistedBufferInfo {
-    GpuAssistedDeviceMemoryBlock output_mem_block;
+    UtilOutputRegion output_region;
     GpuAssistedDeviceMemoryBlock di_input_mem_block;   // Descriptor Indexing input
     GpuAssistedDeviceMemoryBlock bda_input_mem_block;  // Buffer Device Address input
     VkDescriptorSet desc_set;
     VkDescriptorPool desc_pool;
     VkPipelineBindPoint pipeline_bind_point;
-    GpuAssistedBufferInfo(GpuAssistedDeviceMemoryBlock output_mem_block, GpuAssistedDeviceMemoryBlock di_input_mem_block,
+    GpuAssistedBufferInfo(UtilOutputRegion output_region, GpuAssistedDeviceMemoryBlock di_input_mem_block,
                           GpuAssistedDeviceMemoryBlock bda_input_mem_block, VkDescriptorSet desc_set, VkDescriptorPool desc_pool,
                           VkPipelineBindPoint pipeline_bind_point)
-        : output_mem_block(output_mem_block),
+        : output_region(output_region),
           di_input_mem_block(di_input_mem_block),
           bda_input_mem_block(bda_input_mem_block),
           desc_set(desc_set),
@@ -50,10 +50,39 @@ struct GpuAssistedBufferInfo {
           pipeline_bind_point(pipeline_bind_point){};
 };
 
+// A submission whose instrumentation output is read back once its fence signals, rather than after a queue wait idle
+struct GpuAssistedPendingReadback {
+    VkQueue queue;
+    VkFence fence;
+    std::vector<VkCommandBuffer> command_buffers;  // Submitted primaries and their secondaries
+};
+
 struct GpuAssistedShaderTracker {
     VkPipeline pipeline;
     VkShaderModule shader_module;
-    std::vector<unsigned int> pgm;
+    SpirvBlob pgm;
+};
+
+// Instrumented SPIR-V from earlier runs, keyed by a hash of the original SPIR-V and everything else that changes the
+// instrumentation. Read when the device is created and written back when it is destroyed, most recently used first,
+// until the size cap is reached.
+class GpuAssistedShaderCache {
+  public:
+    void Load(const std::string& path, size_t max_size);
+    void Save();
+    bool Get(uint64_t key, std::vector<unsigned int>& pgm);
+    void Put(uint64_t key, const std::vector<unsigned int>& pgm);
+
+  private:
+    struct Entry {
+        std::vector<unsigned int> pgm;
+        uint64_t last_use;
+    };
+    std::string path_;
+    size_t max_size_ = 0;
+    uint64_t use_count_ = 0;
+    bool dirty_ = false;
+    std::unordered_map<uint64_t, Entry> entries_;
 };
 
 struct GpuAssistedAccelerationStructureBuildValidationBufferInfo {
@@ -88,9 +117,15 @@ class GpuAssisted : public ValidationStateTracker {
     VkBool32 shaderInt64;
     uint32_t unique_shader_module_id = 0;
     std::unordered_map<VkCommandBuffer, std::vector<GpuAssistedBufferInfo>> command_buffer_map;  // gpu_buffer_list;
-    uint32_t output_buffer_size;
     std::map<VkDeviceAddress, VkDeviceSize> buffer_map;
     GpuAssistedAccelerationStructureBuildValidationState acceleration_structure_validation_state;
+    // Only used with gpu_validation_async_readback, oldest submission first
+    std::deque<GpuAssistedPendingReadback> pending_readbacks;
+    std::vector<VkFence> readback_fence_pool;
+    // Only used with khronos_validation.gpu_validation_shader_cache_path. Shader ids are derived from the cache key so
+    // that cached binaries stay valid across runs; this maps each id handed out to its key.
+    std::unique_ptr<GpuAssistedShaderCache> shader_cache;
+    std::unordered_map<uint32_t, uint64_t> cached_shader_ids;
 
   public:
     GpuAssisted() { container_type = LayerObjectTypeGpuAssisted; }
@@ -102,8 +137,12 @@ class GpuAssisted : public ValidationStateTracker {
     uint32_t adjusted_max_desc_sets;
     uint32_t desc_set_bind_index;
     VkDescriptorSetLayout debug_desc_layout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout dynamic_debug_desc_layout = VK_NULL_HANDLE;
     VkDescriptorSetLayout dummy_desc_layout = VK_NULL_HANDLE;
+    std::unordered_set<VkPipelineLayout> dynamic_output_pipeline_layouts;
     std::unique_ptr<UtilDescriptorSetManager> desc_set_manager;
+    std::unique_ptr<UtilOutputRegionAllocator> output_region_allocator;
+    uint32_t output_buffer_size;
     std::unordered_map<uint32_t, GpuAssistedShaderTracker> shader_map;
     PFN_vkSetDeviceLoaderData vkSetDeviceLoaderData;
     VmaAllocator vmaAllocator = {};
@@ -143,6 +182,8 @@ class GpuAssisted : public ValidationStateTracker {
     void PostCallRecordCreatePipelineLayout(VkDevice device, const VkPipelineLayoutCreateInfo* pCreateInfo,
                                             const VkAllocationCallbacks* pAllocator, VkPipelineLayout* pPipelineLayout,
                                             VkResult result);
+    void PreCallRecordDestroyPipelineLayout(VkDevice device, VkPipelineLayout pipelineLayout,
+                                            const VkAllocationCallbacks* pAllocator);
     void ResetCommandBuffer(VkCommandBuffer commandBuffer);
     bool PreCallValidateCmdWaitEvents(VkCommandBuffer commandBuffer, uint32_t eventCount, const VkEvent* pEvents,
                                       VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask,
@@ -193,12 +234,22 @@ class GpuAssisted : public ValidationStateTracker {
     void PreCallRecordDestroyPipeline(VkDevice device, VkPipeline pipeline, const VkAllocationCallbacks* pAllocator);
     bool InstrumentShader(const VkShaderModuleCreateInfo* pCreateInfo, std::vector<unsigned int>& new_pgm,
                           uint32_t* unique_shader_id);
+    bool RunInstrumentation(const VkShaderModuleCreateInfo* pCreateInfo, uint32_t shader_id, std::vector<unsigned int>& new_pgm);
     void PreCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo,
                                          const VkAllocationCallbacks* pAllocator, VkShaderModule* pShaderModule,
                                          void* csm_state_data);
     void AnalyzeAndGenerateMessages(VkCommandBuffer command_buffer, VkQueue queue, VkPipelineBindPoint pipeline_bind_point,
                                     uint32_t operation_index, uint32_t* const debug_output_buffer);
     void UpdateInstrumentationBuffer(CMD_BUFFER_STATE* cb_node);
+    void ProcessCommandBufferReadback(VkQueue queue, CMD_BUFFER_STATE* cb_node);
+    void QueueReadback(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits);
+    void ProcessPendingReadbacks(bool wait_all);
+    void WaitForPendingReadback(VkCommandBuffer command_buffer);
+    void PostCallRecordQueueWaitIdle(VkQueue queue, VkResult result);
+    void PostCallRecordDeviceWaitIdle(VkDevice device, VkResult result);
+    void PostCallRecordWaitForFences(VkDevice device, uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll,
+                                     uint64_t timeout, VkResult result);
+    void PostCallRecordGetFenceStatus(VkDevice device, VkFence fence, VkResult result);
     void PreCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence);
     void PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkFence fence,
                                    VkResult result);
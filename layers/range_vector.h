@@ -24,10 +24,13 @@
 #define RANGE_VECTOR_H_
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <limits>
 #include <map>
+#include <memory>
 #include <utility>
+#include <vector>
 #include <cstdint>
 
 #define RANGE_ASSERT(b) assert(b)
@@ -1352,6 +1355,403 @@ class small_range_map {
     std::array<bool, N> in_use_;
 };
 
+// A two level ordered map, for use as the range map "ImplMap" as an alternate to std::map
+//
+// Entries are kept sorted in fixed size leaf arrays, with a sorted array of the first key of each leaf above them, so lookups
+// are two binary searches over contiguous memory and inserting or erasing moves at most a leaf's worth of entries. Unlike
+// std::map, storage isn't stable: an entry may move when another is inserted or erased. Iterators remember the key of their
+// entry and the map's generation at the time they located it, and look the entry up again by key if the map has changed
+// since, so they stay valid across insertions and erasures of other entries, as range_map and its users expect.
+//
+// Assumes Key has a strict weak ordering operator< (as range above does)
+template <typename Key, typename T, size_t N = 32>
+class flat_btree_map {
+  public:
+    using mapped_type = T;
+    using key_type = Key;
+    using value_type = std::pair<const key_type, mapped_type>;
+    using size_type = size_t;
+
+  private:
+    // Leaf index and slot within the leaf. The end() position is one past the last leaf.
+    struct Position {
+        size_t leaf;
+        size_t slot;
+        Position(size_t leaf_, size_t slot_) : leaf(leaf_), slot(slot_) {}
+    };
+
+  public:
+    template <typename Map_, typename Value_>
+    struct IteratorImpl {
+      public:
+        using Map = Map_;
+        using Value = Value_;
+        friend flat_btree_map;
+        template <typename OtherMap, typename OtherValue>
+        friend struct IteratorImpl;
+        Value *operator->() const { return map_->get_value(get_position()); }
+        Value &operator*() const { return *(map_->get_value(get_position())); }
+        IteratorImpl &operator++() {
+            set_position(map_->next_position(get_position()));
+            return *this;
+        }
+        IteratorImpl &operator--() {
+            set_position(map_->prev_position(get_position()));
+            return *this;
+        }
+        bool operator==(const IteratorImpl &other) const {
+            if (at_end() || other.at_end()) {
+                return at_end() && other.at_end();  // all ends are equal
+            }
+            return (map_ == other.map_) && (key_ == other.key_);
+        }
+        bool operator!=(const IteratorImpl &other) const { return !(*this == other); }
+
+        // At end()
+        IteratorImpl() : map_(nullptr), at_end_(true), key_(), position_(0, 0), generation_(0) {}
+
+        // Raw getter to allow for const_iterator conversion below
+        Map *get_map() const { return map_; }
+        bool at_end() const { return at_end_; }
+
+      protected:
+        IteratorImpl(Map *map, const Position &position) : IteratorImpl() {
+            map_ = map;
+            set_position(position);
+        }
+        template <typename Other>
+        void copy_from(const Other &other) {
+            map_ = other.map_;
+            at_end_ = other.at_end_;
+            key_ = other.key_;
+            position_ = other.position_;
+            generation_ = other.generation_;
+        }
+
+      private:
+        void set_position(const Position &position) {
+            at_end_ = map_->at_end_position(position);
+            if (!at_end_) {
+                key_ = map_->get_value(position)->first;
+                position_ = position;
+                generation_ = map_->generation_;
+            }
+        }
+        Position get_position() const {
+            if (at_end_) return map_->end_position();
+            if (generation_ != map_->generation_) {
+                // Entries have moved since the position was found
+                position_ = map_->lower_bound_position(key_);
+                generation_ = map_->generation_;
+                RANGE_ASSERT(!map_->at_end_position(position_) && !(key_ < map_->get_value(position_)->first));
+            }
+            return position_;
+        }
+
+        Map *map_;
+        bool at_end_;
+        key_type key_;
+        mutable Position position_;
+        mutable uint64_t generation_;
+    };
+
+    class const_iterator;
+    class iterator : public IteratorImpl<flat_btree_map, value_type> {
+        using Base = IteratorImpl<flat_btree_map, value_type>;
+        friend flat_btree_map;
+
+      public:
+        iterator() : Base() {}
+
+      private:
+        iterator(flat_btree_map *map, const Position &position) : Base(map, position) {}
+    };
+
+    // The const iterator must be derived to allow the conversion from iterator, which iterator doesn't support
+    class const_iterator : public IteratorImpl<const flat_btree_map, const value_type> {
+        using Base = IteratorImpl<const flat_btree_map, const value_type>;
+        friend flat_btree_map;
+
+      public:
+        const_iterator(const iterator &it) : Base() { Base::copy_from(it); }
+        const_iterator() : Base() {}
+
+      private:
+        const_iterator(const flat_btree_map *map, const Position &position) : Base(map, position) {}
+    };
+
+    iterator begin() { return iterator(this, Position(0, 0)); }
+    const_iterator cbegin() const { return const_iterator(this, Position(0, 0)); }
+    const_iterator begin() const { return cbegin(); }
+    // Unlike a default constructed iterator, end() knows its map, so it can be decremented
+    iterator end() { return iterator(this, end_position()); }
+    const_iterator cend() const { return const_iterator(this, end_position()); }
+    const_iterator end() const { return cend(); }
+
+    size_type size() const { return size_; }
+    bool empty() const { return 0 == size_; }
+
+    void clear() {
+        leaves_.clear();
+        leaf_keys_.clear();
+        size_ = 0;
+        ++generation_;
+    }
+
+    iterator lower_bound(const key_type &key) { return iterator(this, lower_bound_position(key)); }
+    const_iterator lower_bound(const key_type &key) const { return const_iterator(this, lower_bound_position(key)); }
+
+    iterator upper_bound(const key_type &key) { return iterator(this, upper_bound_position(key)); }
+    const_iterator upper_bound(const key_type &key) const { return const_iterator(this, upper_bound_position(key)); }
+
+    iterator find(const key_type &key) { return iterator(this, find_position(key)); }
+    const_iterator find(const key_type &key) const { return const_iterator(this, find_position(key)); }
+
+    iterator erase(const const_iterator &pos) {
+        RANGE_ASSERT(pos.get_map() == this && !pos.at_end());
+        return iterator(this, erase_position(pos.get_position()));
+    }
+    iterator erase(const iterator &pos) { return erase(const_iterator(pos)); }
+
+    // Must be called with rvalue or lvalue of value_type. The hint is used if value belongs just before it, as with std::map
+    template <typename Value>
+    iterator emplace_hint(const const_iterator &hint, Value &&value) {
+        const auto &key = value.first;
+        Position position = (hint.get_map() == this) ? hint.get_position() : end_position();
+        if (!is_insert_position(position, key)) {
+            position = lower_bound_position(key);
+        }
+        if (!at_end_position(position) && !(key < get_value(position)->first)) {
+            return iterator(this, position);  // Key is already present, nothing is inserted
+        }
+        return iterator(this, insert_position(position, std::forward<Value>(value)));
+    }
+    template <typename Value>
+    iterator emplace_hint(const iterator &hint, Value &&value) {
+        return emplace_hint(const_iterator(hint), std::forward<Value>(value));
+    }
+
+    iterator insert(const const_iterator &hint, const value_type &value) { return emplace_hint(hint, value); }
+    iterator insert(const iterator &hint, const value_type &value) { return emplace_hint(const_iterator(hint), value); }
+
+    flat_btree_map() : size_(0), generation_(0) {}
+    flat_btree_map(const flat_btree_map &other) : size_(0), generation_(0) { copy_from(other); }
+    flat_btree_map &operator=(const flat_btree_map &other) {
+        if (this != &other) {
+            clear();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+  private:
+    struct alignas(alignof(value_type)) BackingStore {
+        uint8_t data[sizeof(value_type)];
+    };
+
+    // Up to N entries in placement new'd storage, only the first count of which are in use
+    struct Leaf {
+        size_t count;
+        std::array<BackingStore, N> backing_store;
+
+        value_type *get_value(size_t slot) { return reinterpret_cast<value_type *>(&backing_store[slot]); }
+        const value_type *get_value(size_t slot) const { return reinterpret_cast<const value_type *>(&backing_store[slot]); }
+
+        template <typename Value>
+        void construct_value(size_t slot, Value &&value) {
+            new (get_value(slot)) value_type(std::forward<Value>(value));
+        }
+        void destruct_value(size_t slot) { get_value(slot)->~value_type(); }
+        // value_type isn't assignable (the key is const), so entries are moved by construction into the destination slot
+        void move_value(size_t from, size_t to) {
+            construct_value(to, std::move(*get_value(from)));
+            destruct_value(from);
+        }
+
+        Leaf() : count(0) {}
+        Leaf(const Leaf &) = delete;
+        Leaf &operator=(const Leaf &) = delete;
+        ~Leaf() {
+            for (size_t slot = 0; slot < count; ++slot) {
+                destruct_value(slot);
+            }
+        }
+    };
+
+    void copy_from(const flat_btree_map &other) {
+        leaves_.reserve(other.leaves_.size());
+        for (const auto &other_leaf : other.leaves_) {
+            std::unique_ptr<Leaf> leaf(new Leaf);
+            for (size_t slot = 0; slot < other_leaf->count; ++slot) {
+                leaf->construct_value(slot, *other_leaf->get_value(slot));
+                ++leaf->count;
+            }
+            leaves_.emplace_back(std::move(leaf));
+        }
+        leaf_keys_ = other.leaf_keys_;
+        size_ = other.size_;
+        ++generation_;
+    }
+
+    value_type *get_value(const Position &position) {
+        RANGE_ASSERT(!at_end_position(position));
+        return leaves_[position.leaf]->get_value(position.slot);
+    }
+    const value_type *get_value(const Position &position) const {
+        RANGE_ASSERT(!at_end_position(position));
+        return leaves_[position.leaf]->get_value(position.slot);
+    }
+
+    Position end_position() const { return Position(leaves_.size(), 0); }
+    bool at_end_position(const Position &position) const { return position.leaf >= leaves_.size(); }
+
+    Position next_position(const Position &position) const {
+        RANGE_ASSERT(!at_end_position(position));
+        if (position.slot + 1 < leaves_[position.leaf]->count) return Position(position.leaf, position.slot + 1);
+        return Position(position.leaf + 1, 0);
+    }
+    Position prev_position(const Position &position) const {
+        if (position.slot > 0) return Position(position.leaf, position.slot - 1);
+        RANGE_ASSERT(position.leaf > 0);
+        return Position(position.leaf - 1, leaves_[position.leaf - 1]->count - 1);
+    }
+
+    // The leaf whose first key is the last one not greater than key, i.e. the only leaf that can contain key
+    size_t find_leaf(const key_type &key) const {
+        const auto leaf_it = std::upper_bound(leaf_keys_.cbegin(), leaf_keys_.cend(), key);
+        return static_cast<size_t>(leaf_it - leaf_keys_.cbegin()) - 1;  // wraps to ~0 if key precedes every leaf
+    }
+
+    template <typename Compare>
+    Position search_leaf(size_t leaf_index, const Compare &goes_before) const {
+        const Leaf &leaf = *leaves_[leaf_index];
+        size_t lower = 0;
+        size_t upper = leaf.count;
+        while (lower < upper) {
+            const size_t middle = lower + (upper - lower) / 2;
+            if (goes_before(leaf.get_value(middle)->first)) {
+                lower = middle + 1;
+            } else {
+                upper = middle;
+            }
+        }
+        // Past the last entry of the leaf, the next position is the first entry of the next leaf (or end)
+        if (lower == leaf.count) return Position(leaf_index + 1, 0);
+        return Position(leaf_index, lower);
+    }
+
+    Position lower_bound_position(const key_type &key) const {
+        const auto leaf = find_leaf(key);
+        if (leaf >= leaves_.size()) return Position(0, 0);
+        return search_leaf(leaf, [&key](const key_type &entry) { return entry < key; });
+    }
+
+    Position upper_bound_position(const key_type &key) const {
+        const auto leaf = find_leaf(key);
+        if (leaf >= leaves_.size()) return Position(0, 0);
+        return search_leaf(leaf, [&key](const key_type &entry) { return !(key < entry); });
+    }
+
+    Position find_position(const key_type &key) const {
+        const auto position = lower_bound_position(key);
+        if (!at_end_position(position) && !(key < get_value(position)->first)) return position;
+        return end_position();
+    }
+
+    // Whether key belongs immediately before position
+    bool is_insert_position(const Position &position, const key_type &key) const {
+        if (!at_end_position(position) && !(key < get_value(position)->first)) return false;
+        if (position.leaf == 0 && position.slot == 0) return true;
+        if (leaves_.empty()) return true;
+        return get_value(prev_position(position))->first < key;
+    }
+
+    template <typename Value>
+    Position insert_position(Position position, Value &&value) {
+        if (leaves_.empty()) {
+            leaves_.emplace_back(new Leaf);
+            leaf_keys_.emplace_back(value.first);
+            position = Position(0, 0);
+        } else if (position.slot == 0 && position.leaf > 0 && leaves_[position.leaf - 1]->count < N) {
+            // Append to the previous leaf rather than shifting the entries of this one (this also covers insert at end)
+            position = Position(position.leaf - 1, leaves_[position.leaf - 1]->count);
+        } else if (at_end_position(position)) {
+            position = Position(position.leaf - 1, leaves_[position.leaf - 1]->count);
+        }
+
+        if (leaves_[position.leaf]->count == N) {
+            const auto split_leaf = position.leaf + 1;
+            if (position.slot == N) {
+                // Appending past a full leaf, start a new one instead of leaving two half full leaves behind
+                leaves_.emplace(leaves_.begin() + split_leaf, new Leaf);
+                leaf_keys_.emplace(leaf_keys_.begin() + split_leaf, value.first);
+                position = Position(split_leaf, 0);
+            } else {
+                // Move the upper half of the entries to a new leaf
+                std::unique_ptr<Leaf> upper(new Leaf);
+                Leaf &lower = *leaves_[position.leaf];
+                const size_t half = N / 2;
+                for (size_t slot = half; slot < N; ++slot) {
+                    upper->construct_value(slot - half, std::move(*lower.get_value(slot)));
+                    lower.destruct_value(slot);
+                }
+                upper->count = N - half;
+                lower.count = half;
+                leaf_keys_.emplace(leaf_keys_.begin() + split_leaf, upper->get_value(0)->first);
+                leaves_.emplace(leaves_.begin() + split_leaf, std::move(upper));
+                if (position.slot > half) {
+                    position = Position(split_leaf, position.slot - half);
+                }
+            }
+        }
+
+        Leaf &leaf = *leaves_[position.leaf];
+        for (size_t slot = leaf.count; slot > position.slot; --slot) {
+            leaf.move_value(slot - 1, slot);
+        }
+        leaf.construct_value(position.slot, std::forward<Value>(value));
+        ++leaf.count;
+        if (position.slot == 0) {
+            leaf_keys_[position.leaf] = leaf.get_value(0)->first;
+        }
+        ++size_;
+        ++generation_;
+        return position;
+    }
+
+    // Returns the position of the entry following the erased one
+    Position erase_position(const Position &position) {
+        Leaf &leaf = *leaves_[position.leaf];
+        leaf.destruct_value(position.slot);
+        for (size_t slot = position.slot + 1; slot < leaf.count; ++slot) {
+            leaf.move_value(slot, slot - 1);
+        }
+        --leaf.count;
+        --size_;
+        ++generation_;
+
+        if (leaf.count == 0) {
+            leaves_.erase(leaves_.begin() + position.leaf);
+            leaf_keys_.erase(leaf_keys_.begin() + position.leaf);
+            return Position(position.leaf, 0);
+        }
+        if (position.slot == 0) {
+            leaf_keys_[position.leaf] = leaf.get_value(0)->first;
+        }
+        if (position.slot == leaf.count) return Position(position.leaf + 1, 0);
+        return position;
+    }
+
+    std::vector<std::unique_ptr<Leaf>> leaves_;
+    std::vector<key_type> leaf_keys_;  // The first key of each leaf, for the leaf search
+    size_type size_;
+    uint64_t generation_;  // Changed whenever entries move, to tell iterators to look their entry up again
+};
+
+// A range_map backed by the cache friendlier flat_btree_map
+template <typename Key, typename T, typename RangeKey = range<Key>>
+using flat_range_map = range_map<Key, T, RangeKey, flat_btree_map<RangeKey, T>>;
+
 // Forward index iterator, tracking an index value and the appropos lower bound
 // returns an index_type, lower_bound pair.  Supports ++,  offset, and seek affecting the index,
 // lower bound updates as needed. As the index may specify a range for which no entry exist, dereferenced
@@ -25,10 +25,13 @@
 #include <chrono>
 #include <cinttypes>
 #include <cmath>
+#include <fstream>
 #include <map>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <spirv/unified1/spirv.hpp>
@@ -93,8 +96,6 @@ enum FORMAT_TYPE {
     FORMAT_TYPE_UINT = 4,
 };
 
-typedef std::pair<unsigned, unsigned> location_t;
-
 static shader_stage_attributes shader_stage_attribs[] = {
     {"vertex shader", false, false, VK_SHADER_STAGE_VERTEX_BIT},
     {"tessellation control shader", true, true, VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT},
@@ -106,7 +107,29 @@ static shader_stage_attributes shader_stage_attribs[] = {
 unsigned ExecutionModelToShaderStageFlagBits(unsigned mode);
 
 // SPIRV utility functions
+// Ids at or above the bound only appear in invalid modules, which are reported elsewhere, so they are left out of the tables.
+// The tables start at the smaller of the bound and the module size, so a bogus bound can't force a huge allocation.
+void SHADER_MODULE_STATE::SetDef(uint32_t id, uint32_t offset) {
+    if (id >= IdBound()) return;
+    if (id >= def_index.size()) def_index.resize(id + 1, 0);
+    def_index[id] = offset;
+}
+
+decoration_set *SHADER_MODULE_STATE::DecorationsFor(uint32_t id) {
+    if (id >= IdBound()) return nullptr;
+    if (id >= decoration_index.size()) decoration_index.resize(id + 1, 0);
+    if (decoration_index[id] == 0) {
+        decorations.emplace_back();
+        decoration_index[id] = static_cast<uint32_t>(decorations.size());
+    }
+    return &decorations[decoration_index[id] - 1];
+}
+
 void SHADER_MODULE_STATE::BuildDefIndex() {
+    const size_t initial_size = std::min(static_cast<size_t>(IdBound()), words.size());
+    def_index.assign(initial_size, 0);
+    decoration_index.assign(initial_size, 0);
+    decorations.clear();
     for (auto insn : *this) {
         switch (insn.opcode()) {
             // Types
@@ -132,7 +155,7 @@ void SHADER_MODULE_STATE::BuildDefIndex() {
             case spv::OpTypePipe:
             case spv::OpTypeAccelerationStructureNV:
             case spv::OpTypeCooperativeMatrixNV:
-                def_index[insn.word(1)] = insn.offset();
+                SetDef(insn.word(1), insn.offset());
                 break;
 
                 // Fixed constants
@@ -142,7 +165,7 @@ void SHADER_MODULE_STATE::BuildDefIndex() {
             case spv::OpConstantComposite:
             case spv::OpConstantSampler:
             case spv::OpConstantNull:
-                def_index[insn.word(2)] = insn.offset();
+                SetDef(insn.word(2), insn.offset());
                 break;
 
                 // Specialization constants
@@ -151,27 +174,31 @@ void SHADER_MODULE_STATE::BuildDefIndex() {
             case spv::OpSpecConstant:
             case spv::OpSpecConstantComposite:
             case spv::OpSpecConstantOp:
-                def_index[insn.word(2)] = insn.offset();
+                SetDef(insn.word(2), insn.offset());
                 break;
 
                 // Variables
             case spv::OpVariable:
-                def_index[insn.word(2)] = insn.offset();
+                SetDef(insn.word(2), insn.offset());
                 break;
 
                 // Functions
             case spv::OpFunction:
-                def_index[insn.word(2)] = insn.offset();
+                SetDef(insn.word(2), insn.offset());
                 break;
 
                 // Decorations
             case spv::OpDecorate: {
-                auto targetId = insn.word(1);
-                decorations[targetId].add(insn.word(2), insn.len() > 3u ? insn.word(3) : 0u);
+                auto target_decorations = DecorationsFor(insn.word(1));
+                if (target_decorations) target_decorations->add(insn.word(2), insn.len() > 3u ? insn.word(3) : 0u);
             } break;
             case spv::OpGroupDecorate: {
-                auto const &src = decorations[insn.word(1)];
-                for (auto i = 2u; i < insn.len(); i++) decorations[insn.word(i)].merge(src);
+                // Copied, as adding sets for the targets may reallocate decorations
+                const decoration_set src = get_decorations(insn.word(1));
+                for (auto i = 2u; i < insn.len(); i++) {
+                    auto target_decorations = DecorationsFor(insn.word(i));
+                    if (target_decorations) target_decorations->merge(src);
+                }
             } break;
 
                 // Entry points ... add to the entrypoint table
@@ -689,7 +716,7 @@ static std::map<location_t, interface_var> CollectInterfaceByLocation(SHADER_MOD
         assert(insn.opcode() == spv::OpVariable);
 
         if (insn.word(3) == static_cast<uint32_t>(sinterface)) {
-            auto d = src->get_decorations(iid);
+            auto const &d = src->get_decorations(iid);
             unsigned id = insn.word(2);
             unsigned type = insn.word(1);
 
@@ -965,7 +992,7 @@ std::vector<std::pair<descriptor_slot_t, interface_var>> CollectInterfaceByDescr
         if (insn.opcode() == spv::OpVariable &&
             (insn.word(3) == spv::StorageClassUniform || insn.word(3) == spv::StorageClassUniformConstant ||
              insn.word(3) == spv::StorageClassStorageBuffer)) {
-            auto d = src->get_decorations(insn.word(2));
+            auto const &d = src->get_decorations(insn.word(2));
             unsigned set = d.descriptor_set;
             unsigned binding = d.binding;
 
@@ -986,12 +1013,9 @@ std::vector<std::pair<descriptor_slot_t, interface_var>> CollectInterfaceByDescr
     return out;
 }
 
-std::unordered_set<uint32_t> CollectWritableOutputLocationinFS(const SHADER_MODULE_STATE &module,
-                                                               const VkPipelineShaderStageCreateInfo &stage_info) {
+static std::unordered_set<uint32_t> CollectWritableOutputLocationinFS(const SHADER_MODULE_STATE &module,
+                                                                      const std::map<location_t, interface_var> &outputs) {
     std::unordered_set<uint32_t> location_list;
-    if (stage_info.stage != VK_SHADER_STAGE_FRAGMENT_BIT) return location_list;
-    const auto entrypoint = FindEntrypoint(&module, stage_info.pName, stage_info.stage);
-    const auto outputs = CollectInterfaceByLocation(&module, entrypoint, spv::StorageClassOutput, false);
     std::unordered_set<unsigned> store_members;
     std::unordered_map<unsigned, unsigned> accesschain_members;
 
@@ -1065,7 +1089,8 @@ bool CoreChecks::ValidateViAgainstVsInputs(VkPipelineVertexInputStateCreateInfo
                                            spirv_inst_iter entrypoint) const {
     bool skip = false;
 
-    const auto inputs = CollectInterfaceByLocation(vs, entrypoint, spv::StorageClassInput, false);
+    const auto reflection = vs->GetEntryPointReflection(entrypoint);
+    const auto &inputs = reflection->inputs;
 
     // Build index by location
     std::map<uint32_t, const VkVertexInputAttributeDescription *> attribs;
@@ -1140,8 +1165,8 @@ bool CoreChecks::ValidateFsOutputsAgainstRenderPass(SHADER_MODULE_STATE const *f
 
     // TODO: dual source blend index (spv::DecIndex, zero if not provided)
 
-    const auto outputs = CollectInterfaceByLocation(fs, entrypoint, spv::StorageClassOutput, false);
-    for (const auto &output_it : outputs) {
+    const auto reflection = fs->GetEntryPointReflection(entrypoint);
+    for (const auto &output_it : reflection->outputs) {
         auto const location = output_it.first.first;
         location_map[location].output = &output_it.second;
     }
@@ -1431,15 +1456,13 @@ bool CoreChecks::ValidatePushConstantBlockAgainstPipeline(std::vector<VkPushCons
 }
 
 bool CoreChecks::ValidatePushConstantUsage(std::vector<VkPushConstantRange> const *push_constant_ranges,
-                                           SHADER_MODULE_STATE const *src, std::unordered_set<uint32_t> accessible_ids,
+                                           SHADER_MODULE_STATE const *src, std::vector<uint32_t> const &push_constant_variables,
                                            VkShaderStageFlagBits stage) const {
     bool skip = false;
 
-    for (auto id : accessible_ids) {
+    for (auto id : push_constant_variables) {
         auto def_insn = src->get_def(id);
-        if (def_insn.opcode() == spv::OpVariable && def_insn.word(3) == spv::StorageClassPushConstant) {
-            skip |= ValidatePushConstantBlockAgainstPipeline(push_constant_ranges, src, src->get_def(def_insn.word(1)), stage);
-        }
+        skip |= ValidatePushConstantBlockAgainstPipeline(push_constant_ranges, src, src->get_def(def_insn.word(1)), stage);
     }
 
     return skip;
@@ -2074,14 +2097,13 @@ bool CoreChecks::ValidateShaderStageInputOutputLimits(SHADER_MODULE_STATE const
     uint32_t numCompIn = 0, numCompOut = 0;
     int maxCompIn = 0, maxCompOut = 0;
 
-    auto inputs = CollectInterfaceByLocation(src, entrypoint, spv::StorageClassInput, strip_input_array_level);
-    auto outputs = CollectInterfaceByLocation(src, entrypoint, spv::StorageClassOutput, strip_output_array_level);
+    const auto reflection = src->GetEntryPointReflection(entrypoint);
 
     // Find max component location used for input variables.
-    for (auto &var : inputs) {
+    for (const auto &var : reflection->inputs) {
         int location = var.first.first;
         int component = var.first.second;
-        interface_var &iv = var.second;
+        const interface_var &iv = var.second;
 
         // Only need to look at the first location, since we use the type's whole size
         if (iv.offset != 0) {
@@ -2097,10 +2119,10 @@ bool CoreChecks::ValidateShaderStageInputOutputLimits(SHADER_MODULE_STATE const
     }
 
     // Find max component location used for output variables.
-    for (auto &var : outputs) {
+    for (const auto &var : reflection->outputs) {
         int location = var.first.first;
         int component = var.first.second;
-        interface_var &iv = var.second;
+        const interface_var &iv = var.second;
 
         // Only need to look at the first location, since we use the type's whole size
         if (iv.offset != 0) {
@@ -2932,9 +2954,10 @@ static bool FindLocalSize(SHADER_MODULE_STATE const *src, uint32_t &local_size_x
     return false;
 }
 
-void ProcessExecutionModes(SHADER_MODULE_STATE const *src, const spirv_inst_iter &entrypoint, PIPELINE_STATE *pipeline) {
+static VkPrimitiveTopology GetExecutionModeTopology(SHADER_MODULE_STATE const *src, const spirv_inst_iter &entrypoint) {
     auto entrypoint_id = entrypoint.word(2);
     bool is_point_mode = false;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_MAX_ENUM;
 
     for (auto insn : *src) {
         if (insn.opcode() == spv::OpExecutionMode && insn.word(1) == entrypoint_id) {
@@ -2945,24 +2968,67 @@ void ProcessExecutionModes(SHADER_MODULE_STATE const *src, const spirv_inst_iter
                     break;
 
                 case spv::ExecutionModeOutputPoints:
-                    pipeline->topology_at_rasterizer = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+                    topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
                     break;
 
                 case spv::ExecutionModeIsolines:
                 case spv::ExecutionModeOutputLineStrip:
-                    pipeline->topology_at_rasterizer = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+                    topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
                     break;
 
                 case spv::ExecutionModeTriangles:
                 case spv::ExecutionModeQuads:
                 case spv::ExecutionModeOutputTriangleStrip:
-                    pipeline->topology_at_rasterizer = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+                    topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
                     break;
             }
         }
     }
 
-    if (is_point_mode) pipeline->topology_at_rasterizer = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    if (is_point_mode) topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    return topology;
+}
+
+std::shared_ptr<const EntryPointReflection> SHADER_MODULE_STATE::GetEntryPointReflection(spirv_inst_iter entrypoint) const {
+    if (entrypoint == end()) {
+        static const std::shared_ptr<const EntryPointReflection> no_entrypoint = std::make_shared<EntryPointReflection>();
+        return no_entrypoint;
+    }
+    {
+        std::lock_guard<std::mutex> lock(entry_point_reflections_lock_);
+        auto it = entry_point_reflections_.find(entrypoint.offset());
+        if (it != entry_point_reflections_.end()) return it->second;
+    }
+
+    // Built without the lock held. Should another thread build the same entrypoint meanwhile, the first one stored is kept.
+    auto reflection = std::make_shared<EntryPointReflection>();
+    reflection->stage = ExecutionModelToShaderStageFlagBits(entrypoint.word(1));
+    reflection->accessible_ids = MarkAccessibleIds(this, entrypoint);
+    reflection->descriptor_uses =
+        CollectInterfaceByDescriptorSlot(this, reflection->accessible_ids, &reflection->has_writable_descriptor);
+    for (auto id : reflection->accessible_ids) {
+        auto def_insn = get_def(id);
+        if (def_insn.opcode() == spv::OpVariable && def_insn.word(3) == spv::StorageClassPushConstant) {
+            reflection->push_constant_variables.push_back(id);
+        }
+    }
+
+    const bool strip_output_array_level =
+        (reflection->stage == VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT || reflection->stage == VK_SHADER_STAGE_MESH_BIT_NV);
+    const bool strip_input_array_level =
+        (reflection->stage == VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT ||
+         reflection->stage == VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT || reflection->stage == VK_SHADER_STAGE_GEOMETRY_BIT);
+    reflection->inputs = CollectInterfaceByLocation(this, entrypoint, spv::StorageClassInput, strip_input_array_level);
+    reflection->outputs = CollectInterfaceByLocation(this, entrypoint, spv::StorageClassOutput, strip_output_array_level);
+    reflection->builtin_input_block_members = CollectBuiltinBlockMembers(this, entrypoint, spv::StorageClassInput);
+    reflection->builtin_output_block_members = CollectBuiltinBlockMembers(this, entrypoint, spv::StorageClassOutput);
+    if (reflection->stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
+        reflection->writable_output_locations = CollectWritableOutputLocationinFS(*this, reflection->outputs);
+    }
+    reflection->topology_at_rasterizer = GetExecutionModeTopology(this, entrypoint);
+
+    std::lock_guard<std::mutex> lock(entry_point_reflections_lock_);
+    return entry_point_reflections_.emplace(entrypoint.offset(), std::move(reflection)).first->second;
 }
 
 // If PointList topology is specified in the pipeline, verify that a shader geometry stage writes PointSize
@@ -3018,11 +3084,218 @@ bool CoreChecks::ValidatePointListShaderState(const PIPELINE_STATE *pipeline, SH
     return skip;
 }
 
+// Collects the inputs of a memoized check so that they can be hashed in one go. Structs are added field by field, as their
+// padding holds whatever happened to be in memory and would give equal inputs different hashes.
+class HashInput {
+  public:
+    template <typename T>
+    void Add(const T &value) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "structs are added field by field");
+        Add(&value, sizeof(T));
+    }
+    void Add(const void *data, size_t size) {
+        auto bytes = reinterpret_cast<const uint8_t *>(data);
+        bytes_.insert(bytes_.end(), bytes, bytes + size);
+    }
+    void AddString(const char *str) { Add(str, strlen(str) + 1); }
+    // The VkBool32 members of a struct from first to last, which being of one type have no padding between them
+    template <typename T>
+    void AddBool32s(const T &vk_struct, VkBool32 T::*first, VkBool32 T::*last) {
+        const VkBool32 *begin = &(vk_struct.*first);
+        const VkBool32 *end = &(vk_struct.*last) + 1;
+        Add(begin, (end - begin) * sizeof(VkBool32));
+    }
+    uint64_t Hash() const { return XXH64(bytes_.data(), bytes_.size(), 0); }
+
+  private:
+    std::vector<uint8_t> bytes_;
+};
+
+// Everything outside of the pipeline that ValidatePipelineShaderStage looks at. Computed once at device creation.
+uint64_t CoreChecks::MakeShaderDeviceStateHash() const {
+    HashInput input;
+    input.Add(api_version);
+    // Nothing but one byte ExtEnabled flags, so without padding
+    static_assert(alignof(DeviceExtensions) == alignof(ExtEnabled), "DeviceExtensions holds more than ExtEnabled flags");
+    input.Add(&device_extensions, sizeof(device_extensions));
+
+    // Only the limits and properties that the checks read, so a check reading another has to add it here
+    const auto &limits = phys_dev_props.limits;
+    input.Add(limits.maxVertexOutputComponents);
+    input.Add(limits.maxTessellationControlPerVertexInputComponents);
+    input.Add(limits.maxTessellationControlPerVertexOutputComponents);
+    input.Add(limits.maxTessellationEvaluationInputComponents);
+    input.Add(limits.maxTessellationEvaluationOutputComponents);
+    input.Add(limits.maxGeometryShaderInvocations);
+    input.Add(limits.maxGeometryInputComponents);
+    input.Add(limits.maxGeometryOutputComponents);
+    input.Add(limits.maxGeometryOutputVertices);
+    input.Add(limits.maxGeometryTotalOutputComponents);
+    input.Add(limits.maxFragmentInputComponents);
+    input.Add(limits.maxComputeWorkGroupSize, sizeof(limits.maxComputeWorkGroupSize));
+    input.Add(limits.maxComputeWorkGroupInvocations);
+    input.Add(limits.maxPerStageResources);
+    input.Add(phys_dev_props_core11.subgroupSupportedStages);
+    input.Add(phys_dev_props_core11.subgroupSupportedOperations);
+    input.Add(phys_dev_props_core12.denormBehaviorIndependence);
+    input.Add(phys_dev_props_core12.roundingModeIndependence);
+    input.AddBool32s(phys_dev_props_core12, &VkPhysicalDeviceVulkan12Properties::shaderSignedZeroInfNanPreserveFloat16,
+                     &VkPhysicalDeviceVulkan12Properties::shaderRoundingModeRTZFloat64);
+    input.Add(phys_dev_ext_props.cooperative_matrix_props.cooperativeMatrixSupportedStages);
+    for (const auto &props : cooperative_matrix_properties) {
+        input.Add(props.MSize);
+        input.Add(props.NSize);
+        input.Add(props.KSize);
+        input.Add(props.AType);
+        input.Add(props.BType);
+        input.Add(props.CType);
+        input.Add(props.DType);
+        input.Add(props.scope);
+    }
+
+    const auto &features = enabled_features;
+    input.AddBool32s(features.core, &VkPhysicalDeviceFeatures::robustBufferAccess, &VkPhysicalDeviceFeatures::inheritedQueries);
+    input.AddBool32s(features.core11, &VkPhysicalDeviceVulkan11Features::storageBuffer16BitAccess,
+                     &VkPhysicalDeviceVulkan11Features::shaderDrawParameters);
+    input.AddBool32s(features.core12, &VkPhysicalDeviceVulkan12Features::samplerMirrorClampToEdge,
+                     &VkPhysicalDeviceVulkan12Features::subgroupBroadcastDynamicId);
+    input.Add(features.exclusive_scissor.exclusiveScissor);
+    input.Add(features.shading_rate_image.shadingRateImage);
+    input.Add(features.shading_rate_image.shadingRateCoarseSampleOrder);
+    input.Add(features.mesh_shader.taskShader);
+    input.Add(features.mesh_shader.meshShader);
+    input.Add(features.inline_uniform_block.inlineUniformBlock);
+    input.Add(features.inline_uniform_block.descriptorBindingInlineUniformBlockUpdateAfterBind);
+    input.Add(features.transform_feedback_features.transformFeedback);
+    input.Add(features.transform_feedback_features.geometryStreams);
+    input.Add(features.vtx_attrib_divisor_features.vertexAttributeInstanceRateDivisor);
+    input.Add(features.vtx_attrib_divisor_features.vertexAttributeInstanceRateZeroDivisor);
+    input.Add(features.buffer_device_address_ext.bufferDeviceAddress);
+    input.Add(features.buffer_device_address_ext.bufferDeviceAddressCaptureReplay);
+    input.Add(features.buffer_device_address_ext.bufferDeviceAddressMultiDevice);
+    input.Add(features.cooperative_matrix_features.cooperativeMatrix);
+    input.Add(features.cooperative_matrix_features.cooperativeMatrixRobustBufferAccess);
+    input.Add(features.compute_shader_derivatives_features.computeDerivativeGroupQuads);
+    input.Add(features.compute_shader_derivatives_features.computeDerivativeGroupLinear);
+    input.Add(features.fragment_shader_barycentric_features.fragmentShaderBarycentric);
+    input.Add(features.shader_image_footprint_features.imageFootprint);
+    input.Add(features.fragment_shader_interlock_features.fragmentShaderSampleInterlock);
+    input.Add(features.fragment_shader_interlock_features.fragmentShaderPixelInterlock);
+    input.Add(features.fragment_shader_interlock_features.fragmentShaderShadingRateInterlock);
+    input.Add(features.demote_to_helper_invocation_features.shaderDemoteToHelperInvocation);
+    input.Add(features.texel_buffer_alignment_features.texelBufferAlignment);
+    input.Add(features.pipeline_exe_props_features.pipelineExecutableInfo);
+    input.Add(features.dedicated_allocation_image_aliasing_features.dedicatedAllocationImageAliasing);
+    input.Add(features.performance_query_features.performanceCounterQueryPools);
+    input.Add(features.performance_query_features.performanceCounterMultipleQueryPools);
+    input.Add(features.device_coherent_memory_features.deviceCoherentMemory);
+    input.Add(features.ycbcr_image_array_features.ycbcrImageArrays);
+    input.AddBool32s(features.ray_tracing_features, &VkPhysicalDeviceRayTracingFeaturesKHR::rayTracing,
+                     &VkPhysicalDeviceRayTracingFeaturesKHR::rayTracingPrimitiveCulling);
+    input.Add(features.robustness2_features.robustBufferAccess2);
+    input.Add(features.robustness2_features.robustImageAccess2);
+    input.Add(features.robustness2_features.nullDescriptor);
+    input.Add(features.fragment_density_map_features.fragmentDensityMap);
+    input.Add(features.fragment_density_map_features.fragmentDensityMapDynamic);
+    input.Add(features.fragment_density_map_features.fragmentDensityMapNonSubsampledImages);
+    input.Add(features.fragment_density_map2_features.fragmentDensityMapDeferred);
+    input.Add(features.astc_decode_features.decodeModeSharedExponent);
+    input.Add(features.custom_border_color_features.customBorderColors);
+    input.Add(features.custom_border_color_features.customBorderColorWithoutFormat);
+    input.Add(features.pipeline_creation_cache_control_features.pipelineCreationCacheControl);
+    input.Add(features.extended_dynamic_state_features.extendedDynamicState);
+    return input.Hash();
+}
+
+// Identifies one ValidatePipelineShaderStage call by the module contents, the stage create info and the parts of the
+// pipeline that the stage is checked against, so that a clean result can be remembered across pipelines and runs.
+uint64_t CoreChecks::MakePipelineStageHash(VkPipelineShaderStageCreateInfo const *pStage, const PIPELINE_STATE *pipeline,
+                                           const SHADER_MODULE_STATE *module, bool check_point_size) const {
+    HashInput input;
+    input.Add(shader_device_state_hash);
+    input.Add(module->spirv_hash);
+    input.Add(pStage->stage);
+    input.AddString(pStage->pName);
+    const auto *spec_info = pStage->pSpecializationInfo;
+    if (spec_info) {
+        input.Add(spec_info->mapEntryCount);
+        for (uint32_t i = 0; i < spec_info->mapEntryCount; i++) {
+            input.Add(spec_info->pMapEntries[i].constantID);
+            input.Add(spec_info->pMapEntries[i].offset);
+            input.Add(spec_info->pMapEntries[i].size);
+        }
+        input.Add(spec_info->dataSize);
+        input.Add(spec_info->pData, spec_info->dataSize);
+    }
+
+    for (const auto &set_layout : pipeline->pipeline_layout->set_layouts) {
+        input.Add(set_layout->GetCreateFlags());
+        input.Add(set_layout->GetBindingCount());
+        for (uint32_t i = 0; i < set_layout->GetBindingCount(); i++) {
+            const VkDescriptorSetLayoutBinding *binding = set_layout->GetDescriptorSetLayoutBindingPtrFromIndex(i);
+            input.Add(binding->binding);
+            input.Add(binding->descriptorType);
+            input.Add(binding->descriptorCount);
+            input.Add(binding->stageFlags);
+        }
+    }
+    for (const auto &range : *pipeline->pipeline_layout->push_constant_ranges) {
+        input.Add(range.stageFlags);
+        input.Add(range.offset);
+        input.Add(range.size);
+    }
+
+    input.Add(check_point_size);
+    if (check_point_size) {
+        input.Add(pipeline->topology_at_rasterizer);
+        input.Add(pipeline->graphicsPipelineCI.pRasterizationState->rasterizerDiscardEnable);
+    }
+    if (pStage->stage == VK_SHADER_STAGE_FRAGMENT_BIT && pipeline->rp_state) {
+        const auto rpci = pipeline->rp_state->createInfo.ptr();
+        const auto &subpass = rpci->pSubpasses[pipeline->graphicsPipelineCI.subpass];
+        input.Add(subpass.colorAttachmentCount);
+        for (uint32_t i = 0; i < subpass.inputAttachmentCount; i++) {
+            const uint32_t attachment = subpass.pInputAttachments[i].attachment;
+            input.Add(attachment == VK_ATTACHMENT_UNUSED ? VK_FORMAT_UNDEFINED : rpci->pAttachments[attachment].format);
+        }
+    }
+    return input.Hash();
+}
+
+void CoreChecks::LoadLayerValidationCache() {
+    std::vector<char> data;
+    std::ifstream file(layer_validation_cache_path, std::ios::binary);
+    if (file) {
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    VkValidationCacheCreateInfoEXT create_info = {VK_STRUCTURE_TYPE_VALIDATION_CACHE_CREATE_INFO_EXT};
+    create_info.initialDataSize = data.size();
+    create_info.pInitialData = data.empty() ? nullptr : data.data();
+    layer_validation_cache.reset(CastFromHandle<ValidationCache *>(ValidationCache::Create(&create_info)));
+}
+
+void CoreChecks::SaveLayerValidationCache() {
+    size_t size = 0;
+    layer_validation_cache->Write(&size, nullptr);
+    std::vector<char> data(size);
+    layer_validation_cache->Write(&size, data.data());
+    std::ofstream file(layer_validation_cache_path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), size);
+}
+
 bool CoreChecks::ValidatePipelineShaderStage(VkPipelineShaderStageCreateInfo const *pStage, const PIPELINE_STATE *pipeline,
                                              const PIPELINE_STATE::StageState &stage_state, const SHADER_MODULE_STATE *module,
                                              const spirv_inst_iter &entrypoint, bool check_point_size) const {
     bool skip = false;
 
+    // A stage that once passed without a single message can only do so again
+    uint64_t stage_hash = 0;
+    const uint64_t message_count = ThreadLogMessageCount();
+    if (layer_validation_cache && module->has_valid_spirv) {
+        stage_hash = MakePipelineStageHash(pStage, pipeline, module, check_point_size);
+        if (layer_validation_cache->ContainsPipelineStage(stage_hash)) return skip;
+    }
+
     // Check the module
     if (!module->has_valid_spirv) {
         skip |= LogError(device, "VUID-VkPipelineShaderStageCreateInfo-module-parameter",
@@ -3048,49 +3321,85 @@ bool CoreChecks::ValidatePipelineShaderStage(VkPipelineShaderStageCreateInfo con
             memcpy(entry.first->second.data(), specialization_data + map_entry.offset, map_entry.size);
         }
 
-        // Apply the specialization-constant values and revalidate the shader module.
+        // Apply the specialization-constant values and revalidate the shader module, unless the module has been revalidated with
+        // the same values before. Passing results are also kept in layer_validation_cache, if there is one.
         spv_target_env spirv_environment = PickSpirvEnv(api_version, (device_extensions.vk_khr_spirv_1_4 != kNotEnabled));
-        spvtools::Optimizer optimizer(spirv_environment);
-        spvtools::MessageConsumer consumer = [&skip, &module, &pStage, this](spv_message_level_t level, const char *source,
-                                                                             const spv_position_t &position, const char *message) {
-            skip |= LogError(
-                device, "VUID-VkPipelineShaderStageCreateInfo-module-parameter", "%s does not contain valid spirv for stage %s. %s",
-                report_data->FormatHandle(module->vk_shader_module).c_str(), string_VkShaderStageFlagBits(pStage->stage), message);
-        };
-        optimizer.SetMessageConsumer(consumer);
-        optimizer.RegisterPass(spvtools::CreateSetSpecConstantDefaultValuePass(id_value_map));
-        optimizer.RegisterPass(spvtools::CreateFreezeSpecConstantValuePass());
-        std::vector<uint32_t> specialized_spirv;
-        auto const optimized =
-            optimizer.Run(module->words.data(), module->words.size(), &specialized_spirv, spvtools::ValidatorOptions(), true);
-        assert(optimized == true);
-
-        if (optimized) {
-            spv_context ctx = spvContextCreate(spirv_environment);
-            spv_const_binary_t binary{specialized_spirv.data(), specialized_spirv.size()};
-            spv_diagnostic diag = nullptr;
-            spv_validator_options options = spvValidatorOptionsCreate();
-            if (device_extensions.vk_khr_relaxed_block_layout) {
-                spvValidatorOptionsSetRelaxBlockLayout(options, true);
-            }
-            if (device_extensions.vk_khr_uniform_buffer_standard_layout &&
-                enabled_features.core12.uniformBufferStandardLayout == VK_TRUE) {
-                spvValidatorOptionsSetUniformBufferStandardLayout(options, true);
-            }
-            if (device_extensions.vk_ext_scalar_block_layout && enabled_features.core12.scalarBlockLayout == VK_TRUE) {
-                spvValidatorOptionsSetScalarBlockLayout(options, true);
-            }
-            auto const spv_valid = spvValidateWithOptions(ctx, options, &binary, &diag);
-            if (spv_valid != SPV_SUCCESS) {
-                skip |= LogError(device, "VUID-VkPipelineShaderStageCreateInfo-module-parameter",
-                                 "After specialization was applied, %s does not contain valid spirv for stage %s.",
-                                 report_data->FormatHandle(module->vk_shader_module).c_str(),
-                                 string_VkShaderStageFlagBits(pStage->stage));
-            }
-
-            spvValidatorOptionsDestroy(options);
-            spvDiagnosticDestroy(diag);
-            spvContextDestroy(ctx);
+        const bool relax_block_layout = device_extensions.vk_khr_relaxed_block_layout;
+        const bool uniform_buffer_standard_layout = device_extensions.vk_khr_uniform_buffer_standard_layout &&
+                                                    enabled_features.core12.uniformBufferStandardLayout == VK_TRUE;
+        const bool scalar_block_layout =
+            device_extensions.vk_ext_scalar_block_layout && enabled_features.core12.scalarBlockLayout == VK_TRUE;
+
+        std::vector<std::pair<uint32_t, std::vector<uint32_t>>> sorted_values(id_value_map.begin(), id_value_map.end());
+        std::sort(sorted_values.begin(), sorted_values.end());
+        HashInput key_input;
+        key_input.AddString("specialization");
+        key_input.Add(module->spirv_hash);
+        key_input.Add(spirv_environment);
+        key_input.Add(relax_block_layout);
+        key_input.Add(uniform_buffer_standard_layout);
+        key_input.Add(scalar_block_layout);
+        for (const auto &value : sorted_values) {
+            key_input.Add(value.first);
+            key_input.Add(value.second.data(), value.second.size() * sizeof(uint32_t));
+        }
+        const uint64_t specialization_key = key_input.Hash();
+
+        SpecializationValidationCache::Result result;
+        if (!specialization_validation_cache.Get(specialization_key, &result) &&
+            !(layer_validation_cache && layer_validation_cache->ContainsPipelineStage(specialization_key))) {
+            spvtools::Optimizer optimizer(spirv_environment);
+            spvtools::MessageConsumer consumer = [&result](spv_message_level_t level, const char *source,
+                                                           const spv_position_t &position, const char *message) {
+                result.optimizer_messages.emplace_back(message);
+            };
+            optimizer.SetMessageConsumer(consumer);
+            optimizer.RegisterPass(spvtools::CreateSetSpecConstantDefaultValuePass(id_value_map));
+            optimizer.RegisterPass(spvtools::CreateFreezeSpecConstantValuePass());
+            std::vector<uint32_t> specialized_spirv;
+            auto const optimized =
+                optimizer.Run(module->words.data(), module->words.size(), &specialized_spirv, spvtools::ValidatorOptions(), true);
+            assert(optimized == true);
+
+            if (optimized) {
+                spv_context ctx = spvContextCreate(spirv_environment);
+                spv_const_binary_t binary{specialized_spirv.data(), specialized_spirv.size()};
+                spv_diagnostic diag = nullptr;
+                spv_validator_options options = spvValidatorOptionsCreate();
+                if (relax_block_layout) {
+                    spvValidatorOptionsSetRelaxBlockLayout(options, true);
+                }
+                if (uniform_buffer_standard_layout) {
+                    spvValidatorOptionsSetUniformBufferStandardLayout(options, true);
+                }
+                if (scalar_block_layout) {
+                    spvValidatorOptionsSetScalarBlockLayout(options, true);
+                }
+                auto const spv_valid = spvValidateWithOptions(ctx, options, &binary, &diag);
+                result.valid = (spv_valid == SPV_SUCCESS);
+
+                spvValidatorOptionsDestroy(options);
+                spvDiagnosticDestroy(diag);
+                spvContextDestroy(ctx);
+            }
+
+            specialization_validation_cache.Put(specialization_key, result);
+            if (layer_validation_cache && result.valid && result.optimizer_messages.empty()) {
+                layer_validation_cache->InsertPipelineStage(specialization_key);
+            }
+        }
+
+        for (const auto &message : result.optimizer_messages) {
+            skip |= LogError(device, "VUID-VkPipelineShaderStageCreateInfo-module-parameter",
+                             "%s does not contain valid spirv for stage %s. %s",
+                             report_data->FormatHandle(module->vk_shader_module).c_str(),
+                             string_VkShaderStageFlagBits(pStage->stage), message.c_str());
+        }
+        if (!result.valid) {
+            skip |= LogError(device, "VUID-VkPipelineShaderStageCreateInfo-module-parameter",
+                             "After specialization was applied, %s does not contain valid spirv for stage %s.",
+                             report_data->FormatHandle(module->vk_shader_module).c_str(),
+                             string_VkShaderStageFlagBits(pStage->stage));
         }
     }
 
@@ -3101,30 +3410,26 @@ bool CoreChecks::ValidatePipelineShaderStage(VkPipelineShaderStageCreateInfo con
                      pStage->pName, string_VkShaderStageFlagBits(pStage->stage));
     }
     if (skip) return true;  // no point continuing beyond here, any analysis is just going to be garbage.
-
-    // Mark accessible ids
-    auto &accessible_ids = stage_state.accessible_ids;
-
-    // Validate descriptor set layout against what the entrypoint actually uses
-    bool has_writable_descriptor = stage_state.has_writable_descriptor;
-    auto &descriptor_uses = stage_state.descriptor_uses;
+    if (!stage_state.reflection) return skip;
+    const auto &reflection = *stage_state.reflection;
 
     // Validate shader capabilities against enabled device features
     skip |= ValidateShaderCapabilities(module, pStage->stage);
-    skip |= ValidateShaderStageWritableDescriptor(pStage->stage, has_writable_descriptor);
+    skip |= ValidateShaderStageWritableDescriptor(pStage->stage, reflection.has_writable_descriptor);
     skip |= ValidateShaderStageInputOutputLimits(module, pStage, pipeline, entrypoint);
     skip |= ValidateShaderStageMaxResources(pStage->stage, pipeline);
     skip |= ValidateShaderStageGroupNonUniform(module, pStage->stage);
     skip |= ValidateExecutionModes(module, entrypoint);
     skip |= ValidateSpecializationOffsets(pStage);
-    skip |= ValidatePushConstantUsage(pipeline->pipeline_layout->push_constant_ranges.get(), module, accessible_ids, pStage->stage);
+    skip |= ValidatePushConstantUsage(pipeline->pipeline_layout->push_constant_ranges.get(), module,
+                                      reflection.push_constant_variables, pStage->stage);
     if (check_point_size && !pipeline->graphicsPipelineCI.pRasterizationState->rasterizerDiscardEnable) {
         skip |= ValidatePointListShaderState(pipeline, module, entrypoint, pStage->stage);
     }
     skip |= ValidateCooperativeMatrix(module, pStage, pipeline);
 
-    // Validate descriptor use
-    for (auto use : descriptor_uses) {
+    // Validate descriptor set layout against what the entrypoint actually uses
+    for (const auto &use : reflection.descriptor_uses) {
         // Verify given pipelineLayout has requested setLayout with requested binding
         const auto &binding = GetDescriptorBinding(pipeline->pipeline_layout.get(), use.first);
         unsigned required_descriptor_count;
@@ -3152,7 +3457,7 @@ bool CoreChecks::ValidatePipelineShaderStage(VkPipelineShaderStageCreateInfo con
 
     // Validate use of input attachments against subpass structure
     if (pStage->stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
-        auto input_attachment_uses = CollectInterfaceByInputAttachmentIndex(module, accessible_ids);
+        auto input_attachment_uses = CollectInterfaceByInputAttachmentIndex(module, reflection.accessible_ids);
 
         auto rpci = pipeline->rp_state->createInfo.ptr();
         auto subpass = pipeline->graphicsPipelineCI.subpass;
@@ -3177,6 +3482,9 @@ bool CoreChecks::ValidatePipelineShaderStage(VkPipelineShaderStageCreateInfo con
     if (pStage->stage == VK_SHADER_STAGE_COMPUTE_BIT) {
         skip |= ValidateComputeWorkGroupSizes(module);
     }
+    if (stage_hash && ThreadLogMessageCount() == message_count) {
+        layer_validation_cache->InsertPipelineStage(stage_hash);
+    }
     return skip;
 }
 
@@ -3186,9 +3494,25 @@ bool CoreChecks::ValidateInterfaceBetweenStages(SHADER_MODULE_STATE const *produ
                                                 shader_stage_attributes const *consumer_stage) const {
     bool skip = false;
 
-    auto outputs =
-        CollectInterfaceByLocation(producer, producer_entrypoint, spv::StorageClassOutput, producer_stage->arrayed_output);
-    auto inputs = CollectInterfaceByLocation(consumer, consumer_entrypoint, spv::StorageClassInput, consumer_stage->arrayed_input);
+    uint64_t interface_hash = 0;
+    const uint64_t message_count = ThreadLogMessageCount();
+    if (layer_validation_cache) {
+        HashInput input;
+        input.Add(producer->spirv_hash);
+        input.Add(producer_entrypoint.offset());
+        input.Add(producer_stage->stage);
+        input.Add(consumer->spirv_hash);
+        input.Add(consumer_entrypoint.offset());
+        input.Add(consumer_stage->stage);
+        interface_hash = input.Hash();
+        if (layer_validation_cache->ContainsPipelineStage(interface_hash)) return false;
+    }
+
+    // The reflections strip the per-vertex array level exactly as producer_stage and consumer_stage do
+    const auto producer_reflection = producer->GetEntryPointReflection(producer_entrypoint);
+    const auto consumer_reflection = consumer->GetEntryPointReflection(consumer_entrypoint);
+    const auto &outputs = producer_reflection->outputs;
+    const auto &inputs = consumer_reflection->inputs;
 
     auto a_it = outputs.begin();
     auto b_it = inputs.begin();
@@ -3240,8 +3564,8 @@ bool CoreChecks::ValidateInterfaceBetweenStages(SHADER_MODULE_STATE const *produ
     }
 
     if (consumer_stage->stage != VK_SHADER_STAGE_FRAGMENT_BIT) {
-        auto builtins_producer = CollectBuiltinBlockMembers(producer, producer_entrypoint, spv::StorageClassOutput);
-        auto builtins_consumer = CollectBuiltinBlockMembers(consumer, consumer_entrypoint, spv::StorageClassInput);
+        const auto &builtins_producer = producer_reflection->builtin_output_block_members;
+        const auto &builtins_consumer = consumer_reflection->builtin_input_block_members;
 
         if (!builtins_producer.empty() && !builtins_consumer.empty()) {
             if (builtins_producer.size() != builtins_consumer.size()) {
@@ -3266,6 +3590,9 @@ bool CoreChecks::ValidateInterfaceBetweenStages(SHADER_MODULE_STATE const *produ
         }
     }
 
+    if (interface_hash && ThreadLogMessageCount() == message_count) {
+        layer_validation_cache->InsertPipelineStage(interface_hash);
+    }
     return skip;
 }
 
@@ -3495,10 +3822,46 @@ static ValidationCache *GetValidationCacheInfo(VkShaderModuleCreateInfo const *p
     return nullptr;
 }
 
+spv_result_t SpirvValidatorSettings::Validate(const uint32_t *code, size_t word_count, std::string *message) const {
+    spv_context ctx = spvContextCreate(env);
+    spv_const_binary_t binary{code, word_count};
+    spv_diagnostic diag = nullptr;
+    spv_validator_options options = spvValidatorOptionsCreate();
+    spvValidatorOptionsSetRelaxBlockLayout(options, relax_block_layout);
+    spvValidatorOptionsSetUniformBufferStandardLayout(options, uniform_buffer_standard_layout);
+    spvValidatorOptionsSetScalarBlockLayout(options, scalar_block_layout);
+    spv_result_t result = spvValidateWithOptions(ctx, options, &binary, &diag);
+    if (result != SPV_SUCCESS) {
+        *message = diag && diag->error ? diag->error : "(no error text)";
+    }
+    spvValidatorOptionsDestroy(options);
+    spvDiagnosticDestroy(diag);
+    spvContextDestroy(ctx);
+    return result;
+}
+
+SpirvValidatorSettings CoreChecks::GetSpirvValidatorSettings() const {
+    SpirvValidatorSettings settings;
+    settings.env = PickSpirvEnv(api_version, (device_extensions.vk_khr_spirv_1_4 != kNotEnabled));
+    settings.relax_block_layout = device_extensions.vk_khr_relaxed_block_layout != kNotEnabled;
+    settings.uniform_buffer_standard_layout =
+        device_extensions.vk_khr_uniform_buffer_standard_layout && enabled_features.core12.uniformBufferStandardLayout == VK_TRUE;
+    settings.scalar_block_layout =
+        device_extensions.vk_ext_scalar_block_layout && enabled_features.core12.scalarBlockLayout == VK_TRUE;
+    return settings;
+}
+
+// With background_shader_validation, spirv-val for a SPIR-V module is queued once its handle is known and joined when the
+// module is first used. Modules created with their own VkShaderModuleValidationCacheCreateInfoEXT keep the synchronous path,
+// since the application may destroy that cache before the queued validation finishes.
+bool CoreChecks::DeferShaderModuleValidation(const VkShaderModuleCreateInfo *pCreateInfo) const {
+    return shader_module_validation_pool && !disabled[shader_validation] && (pCreateInfo->codeSize % 4) == 0 &&
+           pCreateInfo->pCode[0] == spv::MagicNumber && !GetValidationCacheInfo(pCreateInfo);
+}
+
 bool CoreChecks::PreCallValidateCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
                                                    const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule) const {
     bool skip = false;
-    spv_result_t spv_valid = SPV_SUCCESS;
 
     if (disabled[shader_validation]) {
         return false;
@@ -3512,38 +3875,27 @@ bool CoreChecks::PreCallValidateCreateShaderModule(VkDevice device, const VkShad
                          pCreateInfo->codeSize);
     } else {
         auto cache = GetValidationCacheInfo(pCreateInfo);
+        if (!cache) cache = layer_validation_cache.get();
         uint32_t hash = 0;
         if (cache) {
             hash = ValidationCache::MakeShaderHash(pCreateInfo);
             if (cache->Contains(hash)) return false;
         }
 
+        // Queued by PostCallRecordCreateShaderModule instead
+        if (DeferShaderModuleValidation(pCreateInfo)) return false;
+
         // Use SPIRV-Tools validator to try and catch any issues with the module itself. If specialization constants are present,
         // the default values will be used during validation.
-        spv_target_env spirv_environment = PickSpirvEnv(api_version, (device_extensions.vk_khr_spirv_1_4 != kNotEnabled));
-        spv_context ctx = spvContextCreate(spirv_environment);
-        spv_const_binary_t binary{pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t)};
-        spv_diagnostic diag = nullptr;
-        spv_validator_options options = spvValidatorOptionsCreate();
-        if (device_extensions.vk_khr_relaxed_block_layout) {
-            spvValidatorOptionsSetRelaxBlockLayout(options, true);
-        }
-        if (device_extensions.vk_khr_uniform_buffer_standard_layout &&
-            enabled_features.core12.uniformBufferStandardLayout == VK_TRUE) {
-            spvValidatorOptionsSetUniformBufferStandardLayout(options, true);
-        }
-        if (device_extensions.vk_ext_scalar_block_layout && enabled_features.core12.scalarBlockLayout == VK_TRUE) {
-            spvValidatorOptionsSetScalarBlockLayout(options, true);
-        }
-        spv_valid = spvValidateWithOptions(ctx, options, &binary, &diag);
+        std::string message;
+        spv_result_t spv_valid =
+            GetSpirvValidatorSettings().Validate(pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t), &message);
         if (spv_valid != SPV_SUCCESS) {
             if (!have_glsl_shader || (pCreateInfo->pCode[0] == spv::MagicNumber)) {
                 if (spv_valid == SPV_WARNING) {
-                    skip |= LogWarning(device, kVUID_Core_Shader_InconsistentSpirv, "SPIR-V module not valid: %s",
-                                       diag && diag->error ? diag->error : "(no error text)");
+                    skip |= LogWarning(device, kVUID_Core_Shader_InconsistentSpirv, "SPIR-V module not valid: %s", message.c_str());
                 } else {
-                    skip |= LogError(device, kVUID_Core_Shader_InconsistentSpirv, "SPIR-V module not valid: %s",
-                                     diag && diag->error ? diag->error : "(no error text)");
+                    skip |= LogError(device, kVUID_Core_Shader_InconsistentSpirv, "SPIR-V module not valid: %s", message.c_str());
                 }
             }
         } else {
@@ -3551,15 +3903,87 @@ bool CoreChecks::PreCallValidateCreateShaderModule(VkDevice device, const VkShad
                 cache->Insert(hash);
             }
         }
+    }
 
-        spvValidatorOptionsDestroy(options);
-        spvDiagnosticDestroy(diag);
-        spvContextDestroy(ctx);
+    return skip;
+}
+
+void CoreChecks::PostCallRecordCreateShaderModule(VkDevice device, const VkShaderModuleCreateInfo *pCreateInfo,
+                                                  const VkAllocationCallbacks *pAllocator, VkShaderModule *pShaderModule,
+                                                  VkResult result, void *csm_state_data) {
+    StateTracker::PostCallRecordCreateShaderModule(device, pCreateInfo, pAllocator, pShaderModule, result, csm_state_data);
+    if (VK_SUCCESS != result || !DeferShaderModuleValidation(pCreateInfo)) return;
+
+    ValidationCache *cache = layer_validation_cache.get();
+    const uint32_t hash = ValidationCache::MakeShaderHash(pCreateInfo);
+    if (cache && cache->Contains(hash)) return;
+
+    // pCode may be freed as soon as this call returns. Unless decoration flattening rewrote it, the module state already holds
+    // the original code and this is the same blob.
+    auto module = GetShaderModuleState(*pShaderModule);
+    SpirvBlob code =
+        SpirvBlobStore::Get().Intern(pCreateInfo->pCode, pCreateInfo->codeSize / sizeof(uint32_t), module->spirv_hash);
+    const SpirvValidatorSettings settings = GetSpirvValidatorSettings();
+    auto task = std::make_shared<std::packaged_task<SHADER_MODULE_STATE::DeferredValidation()>>([settings, code, cache, hash]() {
+        SHADER_MODULE_STATE::DeferredValidation validation;
+        validation.result = settings.Validate(code->data(), code->size(), &validation.message);
+        if (validation.result == SPV_SUCCESS && cache) cache->Insert(hash);
+        return validation;
+    });
+    module->deferred_validation = task->get_future().share();
+    shader_module_validation_pool->Submit([task]() { (*task)(); });
+}
+
+// Waits for the background spirv-val of module, if it was queued, and reports a failure that hasn't been reported yet
+bool CoreChecks::ValidateDeferredShaderModule(const SHADER_MODULE_STATE *module) const {
+    bool skip = false;
+    if (!module->deferred_validation.valid()) return skip;
+
+    const auto &validation = module->deferred_validation.get();
+    if (validation.result != SPV_SUCCESS && !module->deferred_validation_reported) {
+        if (validation.result == SPV_WARNING) {
+            skip |= LogWarning(module->vk_shader_module, kVUID_Core_Shader_InconsistentSpirv, "SPIR-V module not valid: %s",
+                               validation.message.c_str());
+        } else {
+            skip |= LogError(module->vk_shader_module, kVUID_Core_Shader_InconsistentSpirv, "SPIR-V module not valid: %s",
+                             validation.message.c_str());
+        }
     }
+    return skip;
+}
 
+// Called on the calling thread for each pipeline of a batch before any of them is validated, as the pipelines may be validated
+// in parallel. Each module is checked once per batch, and its failure is reported ahead of the checks of the pipelines.
+bool CoreChecks::ValidateDeferredShaderModules(const VkPipelineShaderStageCreateInfo *stages, uint32_t stage_count,
+                                               std::unordered_set<const SHADER_MODULE_STATE *> *checked) const {
+    bool skip = false;
+    if (!shader_module_validation_pool) return skip;
+    for (uint32_t i = 0; i < stage_count; i++) {
+        const auto *module = GetShaderModuleState(stages[i].module);
+        if (module && checked->insert(module).second) {
+            skip |= ValidateDeferredShaderModule(module);
+        }
+    }
     return skip;
 }
 
+void CoreChecks::RecordDeferredShaderModulesReported(const VkPipelineShaderStageCreateInfo *stages, uint32_t stage_count) {
+    if (!shader_module_validation_pool) return;
+    for (uint32_t i = 0; i < stage_count; i++) {
+        auto *module = GetShaderModuleState(stages[i].module);
+        if (module) module->deferred_validation_reported = true;
+    }
+}
+
+void CoreChecks::PreCallRecordDestroyShaderModule(VkDevice device, VkShaderModule shaderModule,
+                                                  const VkAllocationCallbacks *pAllocator) {
+    // A module that was never used in a pipeline still gets its spirv-val result reported. This can't skip the call, which
+    // would leak the module, so it is done here rather than in a validate hook, and is report only.
+    const auto *module = shaderModule ? GetShaderModuleState(shaderModule) : nullptr;
+    if (module) ValidateDeferredShaderModule(module);
+    StateTracker::PreCallRecordDestroyShaderModule(device, shaderModule, pAllocator);
+}
+
 bool CoreChecks::ValidateComputeWorkGroupSizes(const SHADER_MODULE_STATE *shader) const {
     bool skip = false;
     uint32_t local_size_x = 0;
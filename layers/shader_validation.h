@@ -22,7 +22,15 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <future>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -32,6 +40,7 @@
 #include <generated/spirv_tools_commit_id.h>
 #include "spirv-tools/optimizer.hpp"
 #include "core_validation_types.h"
+#include "xxhash.h"
 
 // A forward iterator over spirv instructions. Provides easy access to len, opcode, and content words
 // without the caller needing to care too much about the physical SPIRV module layout.
@@ -52,7 +61,7 @@ struct spirv_inst_iter {
         return it[n];
     }
 
-    uint32_t offset() { return (uint32_t)(it - zero); }
+    uint32_t offset() const { return (uint32_t)(it - zero); }
 
     spirv_inst_iter() {}
 
@@ -120,25 +129,111 @@ struct decoration_set {
     void add(uint32_t decoration, uint32_t value);
 };
 
+typedef std::pair<unsigned, unsigned> location_t;
+
+// What pipeline creation needs to know about one entrypoint of a module. Built the first time a pipeline uses the
+// entrypoint and shared by every later one; never modified once built, so it may be read from any thread.
+struct EntryPointReflection {
+    VkShaderStageFlags stage = 0;
+    // Ids referenced by the static call tree of the entrypoint, see MarkAccessibleIds
+    std::unordered_set<uint32_t> accessible_ids;
+    std::vector<std::pair<descriptor_slot_t, interface_var>> descriptor_uses;
+    bool has_writable_descriptor = false;
+    // Accessible variables in the PushConstant storage class
+    std::vector<uint32_t> push_constant_variables;
+    // User-defined interface variables. The outer array level of per-vertex interfaces is stripped as the stage requires.
+    std::map<location_t, interface_var> inputs;
+    std::map<location_t, interface_var> outputs;
+    // Members of the built-in interface blocks, such as gl_PerVertex
+    std::vector<uint32_t> builtin_input_block_members;
+    std::vector<uint32_t> builtin_output_block_members;
+    // Locations of fragment shader outputs that are stored to
+    std::unordered_set<uint32_t> writable_output_locations;
+    // Set by execution modes such as PointMode or OutputLineStrip, VK_PRIMITIVE_TOPOLOGY_MAX_ENUM if none apply
+    VkPrimitiveTopology topology_at_rasterizer = VK_PRIMITIVE_TOPOLOGY_MAX_ENUM;
+};
+
+// SPIR-V module contents, shared by everything that needs to keep the same module around
+using SpirvBlob = std::shared_ptr<const std::vector<uint32_t>>;
+
+// Process-wide store of SPIR-V module contents. Identical modules, whether created on several devices or tracked by several
+// validation objects and the GPU-AV and DebugPrintf shader maps, share a single copy. Entries live only as long as someone
+// holds the blob.
+class SpirvBlobStore {
+  public:
+    static SpirvBlobStore &Get() {
+        static SpirvBlobStore store;
+        return store;
+    }
+
+    SpirvBlob Intern(const uint32_t *code, size_t word_count, uint64_t hash) {
+        std::lock_guard<std::mutex> lock(lock_);
+        auto range = blobs_.equal_range(hash);
+        for (auto it = range.first; it != range.second;) {
+            auto blob = it->second.lock();
+            if (!blob) {
+                it = blobs_.erase(it);
+            } else if (blob->size() == word_count && std::equal(blob->begin(), blob->end(), code)) {
+                return blob;
+            } else {
+                ++it;
+            }
+        }
+
+        auto blob = std::make_shared<const std::vector<uint32_t>>(code, code + word_count);
+        blobs_.emplace(hash, blob);
+        // Sweep out entries of released blobs every so often, so the cost stays proportional to the inserts
+        if (++inserts_since_sweep_ > blobs_.size() / 2) {
+            for (auto it = blobs_.begin(); it != blobs_.end();) {
+                it = it->second.expired() ? blobs_.erase(it) : std::next(it);
+            }
+            inserts_since_sweep_ = 0;
+        }
+        return blob;
+    }
+
+  private:
+    std::mutex lock_;
+    std::unordered_multimap<uint64_t, std::weak_ptr<const std::vector<uint32_t>>> blobs_;
+    size_t inserts_since_sweep_ = 0;
+};
+
 struct SHADER_MODULE_STATE : public BASE_NODE {
-    // The spirv image itself
-    std::vector<uint32_t> words;
+    // Identifies the module's contents in hashes that outlive the handle, e.g. ValidationCache pipeline stage hashes
+    uint64_t spirv_hash{0};
+    // Set while preprocessing, so it must be declared before spirv
+    bool has_specialization_constants{false};
+    // The spirv image itself. Comes from SpirvBlobStore, unless decoration flattening had to rewrite the module.
+    SpirvBlob spirv;
+    const std::vector<uint32_t> &words;
     // A mapping of <id> to the first word of its def. this is useful because walking type
     // trees, constant expressions, etc requires jumping all over the instruction stream.
-    std::unordered_map<unsigned, unsigned> def_index;
-    std::unordered_map<unsigned, decoration_set> decorations;
+    // Indexed directly by id, as ids are bounded by the header; 0 means no def since no instruction starts in the header.
+    std::vector<uint32_t> def_index;
+    // Position in decorations plus one for each id, 0 for the common case of an undecorated id
+    std::vector<uint32_t> decoration_index;
+    std::vector<decoration_set> decorations;
     struct EntryPoint {
         uint32_t offset;
         VkShaderStageFlags stage;
     };
     std::unordered_multimap<std::string, EntryPoint> entry_points;
     bool has_valid_spirv;
-    bool has_specialization_constants{false};
     VkShaderModule vk_shader_module;
     uint32_t gpu_validation_shader_id;
 
-    std::vector<uint32_t> PreprocessShaderBinary(uint32_t *src_binary, size_t binary_size, spv_target_env env) {
-        std::vector<uint32_t> src(src_binary, src_binary + binary_size / sizeof(uint32_t));
+    // Result of the spirv-val run queued at vkCreateShaderModule with background_shader_validation. Only valid() for modules
+    // that were queued; it is reported against vk_shader_module by pipeline creation and at destruction, until a pipeline
+    // creation call that reported it goes through.
+    struct DeferredValidation {
+        spv_result_t result;
+        std::string message;
+    };
+    std::shared_future<DeferredValidation> deferred_validation;
+    bool deferred_validation_reported = false;
+
+    SpirvBlob PreprocessShaderBinary(const uint32_t *src_binary, size_t binary_size, spv_target_env env) {
+        SpirvBlob src = SpirvBlobStore::Get().Intern(src_binary, binary_size / sizeof(uint32_t), spirv_hash);
 
         // Check if there are any group decoration instructions, and flatten them if found.
         bool has_group_decoration = false;
@@ -146,8 +241,8 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
 
         // Walk through the first part of the SPIR-V module, looking for group decoration and specialization constant instructions.
         // Skip the header (5 words).
-        auto itr = spirv_inst_iter(src.begin(), src.begin() + 5);
-        auto itrend = spirv_inst_iter(src.begin(), src.end());
+        auto itr = spirv_inst_iter(src->begin(), src->begin() + 5);
+        auto itrend = spirv_inst_iter(src->begin(), src->end());
         while (itr != itrend && !done) {
             spv::Op opcode = (spv::Op)itr.opcode();
             switch (opcode) {
@@ -181,7 +276,8 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
             auto result =
                 optimizer.Run(src_binary, binary_size / sizeof(uint32_t), &optimized_binary, spvtools::ValidatorOptions(), true);
             if (result) {
-                return optimized_binary;
+                // The rewritten module is private to this one
+                return std::make_shared<const std::vector<uint32_t>>(std::move(optimized_binary));
             }
         }
         // Return the original module.
@@ -190,18 +286,29 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
 
     SHADER_MODULE_STATE(VkShaderModuleCreateInfo const *pCreateInfo, VkShaderModule shaderModule, spv_target_env env,
                         uint32_t unique_shader_id)
-        : words(), def_index(), has_valid_spirv(true), vk_shader_module(shaderModule), gpu_validation_shader_id(unique_shader_id) {
-        words = PreprocessShaderBinary((uint32_t *)pCreateInfo->pCode, pCreateInfo->codeSize, env);
+        : spirv_hash(XXH64(pCreateInfo->pCode, pCreateInfo->codeSize, 0)),
+          spirv(PreprocessShaderBinary(pCreateInfo->pCode, pCreateInfo->codeSize, env)),
+          words(*spirv),
+          has_valid_spirv(true),
+          vk_shader_module(shaderModule),
+          gpu_validation_shader_id(unique_shader_id) {
         BuildDefIndex();
     }
 
-    SHADER_MODULE_STATE() : has_valid_spirv(false), vk_shader_module(VK_NULL_HANDLE), gpu_validation_shader_id(UINT32_MAX) {}
+    // Wraps SPIR-V that is only going to be walked instruction by instruction, such as the code kept for GPU-AV and
+    // DebugPrintf messages; no def index is built
+    explicit SHADER_MODULE_STATE(SpirvBlob code = nullptr)
+        : spirv(code ? std::move(code) : std::make_shared<const std::vector<uint32_t>>()),
+          words(*spirv),
+          has_valid_spirv(false),
+          vk_shader_module(VK_NULL_HANDLE),
+          gpu_validation_shader_id(UINT32_MAX) {}
 
-    decoration_set get_decorations(unsigned id) const {
+    decoration_set const &get_decorations(unsigned id) const {
         // return the actual decorations for this id, or a default set.
-        auto it = decorations.find(id);
-        if (it != decorations.end()) return it->second;
-        return decoration_set();
+        static const decoration_set no_decorations;
+        if (id < decoration_index.size() && decoration_index[id]) return decorations[decoration_index[id] - 1];
+        return no_decorations;
     }
 
     // Expose begin() / end() to enable range-based for
@@ -212,14 +319,63 @@ struct SHADER_MODULE_STATE : public BASE_NODE {
 
     // Gets an iterator to the definition of an id
     spirv_inst_iter get_def(unsigned id) const {
-        auto it = def_index.find(id);
-        if (it == def_index.end()) {
+        if (id >= def_index.size() || def_index[id] == 0) {
             return end();
         }
-        return at(it->second);
+        return at(def_index[id]);
     }
 
     void BuildDefIndex();
+
+    // Reflection of one of the module's entrypoints, built on first use. An empty one for end().
+    std::shared_ptr<const EntryPointReflection> GetEntryPointReflection(spirv_inst_iter entrypoint) const;
+
+  private:
+    uint32_t IdBound() const { return words.size() > 3 ? words[3] : 0; }
+    void SetDef(uint32_t id, uint32_t offset);
+    decoration_set *DecorationsFor(uint32_t id);
+
+    // Keyed by the offset of the OpEntryPoint instruction
+    mutable std::unordered_map<uint32_t, std::shared_ptr<const EntryPointReflection>> entry_point_reflections_;
+    mutable std::mutex entry_point_reflections_lock_;
+};
+
+// The device state that spirv-val depends on, captured so that a module can also be validated away from the creating thread
+struct SpirvValidatorSettings {
+    spv_target_env env;
+    bool relax_block_layout;
+    bool uniform_buffer_standard_layout;
+    bool scalar_block_layout;
+
+    spv_result_t Validate(const uint32_t *code, size_t word_count, std::string *message) const;
+};
+
+// Outcomes of revalidating modules with specialization constant values applied, keyed by a hash of the module, the values and
+// the validator options. Applications tend to specialize a module the same few ways for many pipelines.
+class SpecializationValidationCache {
+  public:
+    struct Result {
+        // Messages from the optimizer applying the values, reported against whichever module handle asks
+        std::vector<std::string> optimizer_messages;
+        bool valid = true;
+    };
+
+    bool Get(uint64_t key, Result *result) const {
+        std::lock_guard<std::mutex> lock(lock_);
+        auto it = results_.find(key);
+        if (it == results_.end()) return false;
+        *result = it->second;
+        return true;
+    }
+
+    void Put(uint64_t key, const Result &result) {
+        std::lock_guard<std::mutex> lock(lock_);
+        results_.emplace(key, result);
+    }
+
+  private:
+    mutable std::mutex lock_;
+    std::unordered_map<uint64_t, Result> results_;
 };
 
 class ValidationCache {
@@ -228,8 +384,16 @@ class ValidationCache {
     // wrong with them; also, we expect they will get fixed, so we're less
     // likely to see them again.
     std::unordered_set<uint32_t> good_shader_hashes;
+    // hashes of pipeline shader stages (module, entrypoint, specialization, layout and device state) that produced no
+    // messages at all, see CoreChecks::MakePipelineStageHash
+    std::unordered_set<uint64_t> good_pipeline_stage_hashes;
+    // Pipeline creation may look up and insert from several threads at once
+    mutable std::mutex lock_;
     ValidationCache() {}
 
+    // Bumped whenever the data following the header changes layout, so that older data is discarded rather than misread
+    static const uint8_t kDataFormatVersion = 2;
+
   public:
     static VkValidationCacheEXT Create(VkValidationCacheCreateInfoEXT const *pCreateInfo) {
         auto cache = new ValidationCache();
@@ -237,33 +401,48 @@ class ValidationCache {
         return VkValidationCacheEXT(cache);
     }
 
+    // Data layout following the header: shader hash count, shader hashes, then pipeline stage hashes up to the end
     void Load(VkValidationCacheCreateInfoEXT const *pCreateInfo) {
         const auto headerSize = 2 * sizeof(uint32_t) + VK_UUID_SIZE;
         auto size = headerSize;
-        if (!pCreateInfo->pInitialData || pCreateInfo->initialDataSize < size) return;
+        if (!pCreateInfo->pInitialData || pCreateInfo->initialDataSize < size + sizeof(uint32_t)) return;
 
         uint32_t const *data = (uint32_t const *)pCreateInfo->pInitialData;
         if (data[0] != size) return;
         if (data[1] != VK_VALIDATION_CACHE_HEADER_VERSION_ONE_EXT) return;
         uint8_t expected_uuid[VK_UUID_SIZE];
-        Sha1ToVkUuid(SPIRV_TOOLS_COMMIT_ID, expected_uuid);
+        MakeUuid(expected_uuid);
         if (memcmp(&data[2], expected_uuid, VK_UUID_SIZE) != 0) return;  // different version
 
-        data = (uint32_t const *)(reinterpret_cast<uint8_t const *>(data) + headerSize);
-
-        for (; size < pCreateInfo->initialDataSize; data++, size += sizeof(uint32_t)) {
-            good_shader_hashes.insert(*data);
+        auto bytes = reinterpret_cast<uint8_t const *>(pCreateInfo->pInitialData);
+        uint32_t shader_hash_count;
+        memcpy(&shader_hash_count, bytes + size, sizeof(shader_hash_count));
+        size += sizeof(uint32_t);
+        if (shader_hash_count > (pCreateInfo->initialDataSize - size) / sizeof(uint32_t)) return;
+
+        std::lock_guard<std::mutex> lock(lock_);
+        for (uint32_t i = 0; i < shader_hash_count; i++, size += sizeof(uint32_t)) {
+            uint32_t hash;
+            memcpy(&hash, bytes + size, sizeof(hash));
+            good_shader_hashes.insert(hash);
+        }
+        for (; size + sizeof(uint64_t) <= pCreateInfo->initialDataSize; size += sizeof(uint64_t)) {
+            uint64_t hash;
+            memcpy(&hash, bytes + size, sizeof(hash));
+            good_pipeline_stage_hashes.insert(hash);
         }
     }
 
     void Write(size_t *pDataSize, void *pData) {
         const auto headerSize = 2 * sizeof(uint32_t) + VK_UUID_SIZE;  // 4 bytes for header size + 4 bytes for version number + UUID
+        std::lock_guard<std::mutex> lock(lock_);
         if (!pData) {
-            *pDataSize = headerSize + good_shader_hashes.size() * sizeof(uint32_t);
+            *pDataSize = headerSize + sizeof(uint32_t) + good_shader_hashes.size() * sizeof(uint32_t) +
+                         good_pipeline_stage_hashes.size() * sizeof(uint64_t);
             return;
         }
 
-        if (*pDataSize < headerSize) {
+        if (*pDataSize < headerSize + sizeof(uint32_t)) {
             *pDataSize = 0;
             return;  // Too small for even the header!
         }
@@ -274,29 +453,65 @@ class ValidationCache {
         // Write the header
         *out++ = headerSize;
         *out++ = VK_VALIDATION_CACHE_HEADER_VERSION_ONE_EXT;
-        Sha1ToVkUuid(SPIRV_TOOLS_COMMIT_ID, reinterpret_cast<uint8_t *>(out));
-        out = (uint32_t *)(reinterpret_cast<uint8_t *>(out) + VK_UUID_SIZE);
+        MakeUuid(reinterpret_cast<uint8_t *>(out));
+
+        auto bytes = reinterpret_cast<uint8_t *>(pData);
+        const uint32_t shader_hash_count = static_cast<uint32_t>(
+            std::min(good_shader_hashes.size(), (*pDataSize - headerSize - sizeof(uint32_t)) / sizeof(uint32_t)));
+        memcpy(bytes + actualSize, &shader_hash_count, sizeof(shader_hash_count));
+        actualSize += sizeof(uint32_t);
 
-        for (auto it = good_shader_hashes.begin(); it != good_shader_hashes.end() && actualSize < *pDataSize;
-             it++, out++, actualSize += sizeof(uint32_t)) {
-            *out = *it;
+        auto it = good_shader_hashes.begin();
+        for (uint32_t i = 0; i < shader_hash_count; i++, it++, actualSize += sizeof(uint32_t)) {
+            memcpy(bytes + actualSize, &*it, sizeof(uint32_t));
+        }
+        for (auto stage_it = good_pipeline_stage_hashes.begin();
+             stage_it != good_pipeline_stage_hashes.end() && actualSize + sizeof(uint64_t) <= *pDataSize;
+             stage_it++, actualSize += sizeof(uint64_t)) {
+            memcpy(bytes + actualSize, &*stage_it, sizeof(uint64_t));
         }
 
         *pDataSize = actualSize;
     }
 
     void Merge(ValidationCache const *other) {
+        std::unique_lock<std::mutex> lock(lock_, std::defer_lock);
+        std::unique_lock<std::mutex> other_lock(other->lock_, std::defer_lock);
+        std::lock(lock, other_lock);
         good_shader_hashes.reserve(good_shader_hashes.size() + other->good_shader_hashes.size());
         for (auto h : other->good_shader_hashes) good_shader_hashes.insert(h);
+        good_pipeline_stage_hashes.reserve(good_pipeline_stage_hashes.size() + other->good_pipeline_stage_hashes.size());
+        for (auto h : other->good_pipeline_stage_hashes) good_pipeline_stage_hashes.insert(h);
     }
 
     static uint32_t MakeShaderHash(VkShaderModuleCreateInfo const *smci);
 
-    bool Contains(uint32_t hash) { return good_shader_hashes.count(hash) != 0; }
+    bool Contains(uint32_t hash) {
+        std::lock_guard<std::mutex> lock(lock_);
+        return good_shader_hashes.count(hash) != 0;
+    }
 
-    void Insert(uint32_t hash) { good_shader_hashes.insert(hash); }
+    void Insert(uint32_t hash) {
+        std::lock_guard<std::mutex> lock(lock_);
+        good_shader_hashes.insert(hash);
+    }
+
+    bool ContainsPipelineStage(uint64_t hash) {
+        std::lock_guard<std::mutex> lock(lock_);
+        return good_pipeline_stage_hashes.count(hash) != 0;
+    }
+
+    void InsertPipelineStage(uint64_t hash) {
+        std::lock_guard<std::mutex> lock(lock_);
+        good_pipeline_stage_hashes.insert(hash);
+    }
 
   private:
+    void MakeUuid(uint8_t *uuid) {
+        Sha1ToVkUuid(SPIRV_TOOLS_COMMIT_ID, uuid);
+        uuid[VK_UUID_SIZE - 1] ^= kDataFormatVersion;
+    }
+
     void Sha1ToVkUuid(const char *sha1_str, uint8_t *uuid) {
         // Convert sha1_str from a hex string to binary. We only need VK_UUID_SIZE bytes of
         // output, so pad with zeroes if the input string is shorter than that, and truncate
@@ -328,14 +543,9 @@ spirv_inst_iter FindEntrypoint(SHADER_MODULE_STATE const *src, char const *name,
 // converting parts of this to be generated from the machine-readable spec instead.
 std::unordered_set<uint32_t> MarkAccessibleIds(SHADER_MODULE_STATE const *src, spirv_inst_iter entrypoint);
 
-void ProcessExecutionModes(SHADER_MODULE_STATE const *src, const spirv_inst_iter &entrypoint, PIPELINE_STATE *pipeline);
-
 std::vector<std::pair<descriptor_slot_t, interface_var>> CollectInterfaceByDescriptorSlot(
     SHADER_MODULE_STATE const *src, std::unordered_set<uint32_t> const &accessible_ids, bool *has_writable_descriptor);
 
-std::unordered_set<uint32_t> CollectWritableOutputLocationinFS(const SHADER_MODULE_STATE &module,
-                                                               const VkPipelineShaderStageCreateInfo &stage_info);
-
 uint32_t DescriptorTypeToReqs(SHADER_MODULE_STATE const *module, uint32_t type_id);
 
 spv_target_env PickSpirvEnv(uint32_t api_version, bool spirv_1_4);
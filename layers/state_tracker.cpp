@@ -335,7 +335,7 @@ void ValidationStateTracker::PostCallRecordCreateImage(VkDevice device, const Vk
 
     is_node->unprotected = ((pCreateInfo->flags & VK_IMAGE_CREATE_PROTECTED_BIT) == 0);
 
-    imageMap.insert(std::make_pair(*pImage, std::move(is_node)));
+    imageMap.insert(*pImage, std::move(is_node));
 }
 
 void ValidationStateTracker::PreCallRecordDestroyImage(VkDevice device, VkImage image, const VkAllocationCallbacks *pAllocator) {
@@ -436,7 +436,7 @@ void ValidationStateTracker::PostCallRecordCreateBuffer(VkDevice device, const V
 
     buffer_state->unprotected = ((pCreateInfo->flags & VK_BUFFER_CREATE_PROTECTED_BIT) == 0);
 
-    bufferMap.insert(std::make_pair(*pBuffer, std::move(buffer_state)));
+    bufferMap.insert(*pBuffer, std::move(buffer_state));
 }
 
 void ValidationStateTracker::PostCallRecordCreateBufferView(VkDevice device, const VkBufferViewCreateInfo *pCreateInfo,
@@ -444,7 +444,7 @@ void ValidationStateTracker::PostCallRecordCreateBufferView(VkDevice device, con
                                                             VkResult result) {
     if (result != VK_SUCCESS) return;
     auto buffer_state = GetBufferShared(pCreateInfo->buffer);
-    bufferViewMap[*pView] = std::make_shared<BUFFER_VIEW_STATE>(buffer_state, *pView, pCreateInfo);
+    bufferViewMap.insert_or_assign(*pView, std::make_shared<BUFFER_VIEW_STATE>(buffer_state, *pView, pCreateInfo));
 }
 
 void ValidationStateTracker::PostCallRecordCreateImageView(VkDevice device, const VkImageViewCreateInfo *pCreateInfo,
@@ -487,7 +487,7 @@ void ValidationStateTracker::PostCallRecordCreateImageView(VkDevice device, cons
                                                                                      : format_properties.optimalTilingFeatures;
     }
 
-    imageViewMap.insert(std::make_pair(*pView, std::move(image_view_state)));
+    imageViewMap.insert(*pView, std::move(image_view_state));
 }
 
 void ValidationStateTracker::PreCallRecordCmdCopyBuffer(VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkBuffer dstBuffer,
@@ -726,8 +726,9 @@ void ValidationStateTracker::AddMemObjInfo(void *object, const VkDeviceMemory me
     assert(object != NULL);
 
     auto fake_address = fake_memory.Alloc(pAllocateInfo->allocationSize);
-    memObjMap[mem] = std::make_shared<DEVICE_MEMORY_STATE>(object, mem, pAllocateInfo, fake_address);
-    auto mem_info = memObjMap[mem].get();
+    auto mem_state = std::make_shared<DEVICE_MEMORY_STATE>(object, mem, pAllocateInfo, fake_address);
+    auto mem_info = mem_state.get();
+    memObjMap.insert_or_assign(mem, std::move(mem_state));
 
     auto dedicated = lvl_find_in_chain<VkMemoryDedicatedAllocateInfoKHR>(pAllocateInfo->pNext);
     if (dedicated) {
@@ -1035,13 +1036,13 @@ void ValidationStateTracker::FreeDescriptorSet(cvdescriptorset::DescriptorSet *d
 // Free all DS Pools including their Sets & related sub-structs
 // NOTE : Calls to this function should be wrapped in mutex
 void ValidationStateTracker::DeleteDescriptorSetPools() {
-    for (auto ii = descriptorPoolMap.begin(); ii != descriptorPoolMap.end();) {
+    for (const auto &entry : descriptorPoolMap.snapshot()) {
         // Remove this pools' sets from setMap and delete them
-        for (auto ds : ii->second->sets) {
+        for (auto ds : entry.second->sets) {
             FreeDescriptorSet(ds);
         }
-        ii->second->sets.clear();
-        ii = descriptorPoolMap.erase(ii);
+        entry.second->sets.clear();
+        descriptorPoolMap.erase(entry.first);
     }
 }
 
@@ -1164,6 +1165,7 @@ bool ValidationStateTracker::AddCommandBufferBinding(small_unordered_map<CMD_BUF
     if (disabled[command_buffer_state]) {
         return false;
     }
+    auto binding_lock = cb_binding_lock();
     // Insert the cb_binding with a default 'index' of -1. Then push the obj into the object_bindings
     // vector, and update cb_bindings[cb_node] with the index of that element of the vector.
     auto inserted = cb_bindings.insert({cb_node, -1});
@@ -1184,6 +1186,10 @@ void ValidationStateTracker::RemoveCommandBufferBinding(VulkanTypedHandle const
 // Reset the command buffer state
 //  Maintain the createInfo and set state to CB_NEW, but clear all other state
 void ValidationStateTracker::ResetCommandBufferState(const VkCommandBuffer cb) {
+    // Let derived classes see the command buffer's state one last time, e.g. to read back results still in flight
+    if (command_buffer_reset_callback) {
+        (*command_buffer_reset_callback)(cb);
+    }
     CMD_BUFFER_STATE *pCB = GetCBState(cb);
     if (pCB) {
         pCB->in_use.store(0);
@@ -1215,6 +1221,25 @@ void ValidationStateTracker::ResetCommandBufferState(const VkCommandBuffer cb) {
         pCB->activeRenderPass = nullptr;
         pCB->activeSubpassContents = VK_SUBPASS_CONTENTS_INLINE;
         pCB->activeSubpass = 0;
+        // If secondary, invalidate any primary command buffer that may call us.
+        if (pCB->createInfo.level == VK_COMMAND_BUFFER_LEVEL_SECONDARY) {
+            InvalidateLinkedCommandBuffers(pCB->linkedCommandBuffers, VulkanTypedHandle(cb, kVulkanObjectTypeCommandBuffer));
+        }
+
+        // Remove reverse command buffer links, each under the lock of the command buffer linked to.
+        std::vector<CMD_BUFFER_STATE *> linked_cbs;
+        {
+            auto binding_lock = cb_binding_lock();
+            linked_cbs.assign(pCB->linkedCommandBuffers.begin(), pCB->linkedCommandBuffers.end());
+            pCB->linkedCommandBuffers.clear();
+        }
+        for (auto pSubCB : linked_cbs) {
+            auto sub_cb_lock = cb_state_lock(pSubCB);
+            auto binding_lock = cb_binding_lock();
+            pSubCB->linkedCommandBuffers.erase(pCB);
+        }
+
+        auto binding_lock = cb_binding_lock();
         pCB->broken_bindings.clear();
         pCB->waitedEvents.clear();
         pCB->events.clear();
@@ -1225,16 +1250,6 @@ void ValidationStateTracker::ResetCommandBufferState(const VkCommandBuffer cb) {
         pCB->current_vertex_buffer_binding_info.vertex_buffer_bindings.clear();
         pCB->vertex_buffer_used = false;
         pCB->primaryCommandBuffer = VK_NULL_HANDLE;
-        // If secondary, invalidate any primary command buffer that may call us.
-        if (pCB->createInfo.level == VK_COMMAND_BUFFER_LEVEL_SECONDARY) {
-            InvalidateLinkedCommandBuffers(pCB->linkedCommandBuffers, VulkanTypedHandle(cb, kVulkanObjectTypeCommandBuffer));
-        }
-
-        // Remove reverse command buffer links.
-        for (auto pSubCB : pCB->linkedCommandBuffers) {
-            pSubCB->linkedCommandBuffers.erase(pCB);
-        }
-        pCB->linkedCommandBuffers.clear();
         pCB->queue_submit_functions.clear();
         pCB->cmd_execute_commands_functions.clear();
         pCB->eventUpdates.clear();
@@ -1260,15 +1275,13 @@ void ValidationStateTracker::ResetCommandBufferState(const VkCommandBuffer cb) {
         ResetCmdDebugUtilsLabel(report_data, pCB->commandBuffer);
         pCB->debug_label.Reset();
         pCB->validate_descriptorsets_in_queuesubmit.clear();
+        pCB->deferred_draw_validation.clear();
 
         // Best practices info
         pCB->small_indexed_draw_call_count = 0;
 
         pCB->transform_feedback_active = false;
     }
-    if (command_buffer_reset_callback) {
-        (*command_buffer_reset_callback)(cb);
-    }
 }
 
 void ValidationStateTracker::PostCallRecordCreateDevice(VkPhysicalDevice gpu, const VkDeviceCreateInfo *pCreateInfo,
@@ -1797,7 +1810,7 @@ void ValidationStateTracker::PreCallRecordDestroyDevice(VkDevice device, const V
     if (!device) return;
 
     // Reset all command buffers before destroying them, to unlink object_bindings.
-    for (auto &commandBuffer : commandBufferMap) {
+    for (const auto &commandBuffer : commandBufferMap.snapshot()) {
         ResetCommandBufferState(commandBuffer.first);
     }
     pipelineMap.clear();
@@ -2242,7 +2255,7 @@ void ValidationStateTracker::PostCallRecordCreateSemaphore(VkDevice device, cons
         semaphore_state->type = semaphore_type_create_info->semaphoreType;
         semaphore_state->payload = semaphore_type_create_info->initialValue;
     }
-    semaphoreMap[*pSemaphore] = std::move(semaphore_state);
+    semaphoreMap.insert_or_assign(*pSemaphore, std::move(semaphore_state));
 }
 
 void ValidationStateTracker::RecordImportSemaphoreState(VkSemaphore semaphore, VkExternalSemaphoreHandleTypeFlagBitsKHR handle_type,
@@ -2658,10 +2671,9 @@ void ValidationStateTracker::PreCallRecordDestroySampler(VkDevice device, VkSamp
 void ValidationStateTracker::PreCallRecordDestroyDescriptorSetLayout(VkDevice device, VkDescriptorSetLayout descriptorSetLayout,
                                                                      const VkAllocationCallbacks *pAllocator) {
     if (!descriptorSetLayout) return;
-    auto layout_it = descriptorSetLayoutMap.find(descriptorSetLayout);
+    auto layout_it = descriptorSetLayoutMap.pop(descriptorSetLayout);
     if (layout_it != descriptorSetLayoutMap.end()) {
         layout_it->second.get()->destroyed = true;
-        descriptorSetLayoutMap.erase(layout_it);
     }
 }
 
@@ -2722,7 +2734,7 @@ void ValidationStateTracker::PostCallRecordCreateCommandPool(VkDevice device, co
     cmd_pool_state->createFlags = pCreateInfo->flags;
     cmd_pool_state->queueFamilyIndex = pCreateInfo->queueFamilyIndex;
     cmd_pool_state->unprotected = ((pCreateInfo->flags & VK_COMMAND_POOL_CREATE_PROTECTED_BIT) == 0);
-    commandPoolMap[*pCommandPool] = std::move(cmd_pool_state);
+    commandPoolMap.insert_or_assign(*pCommandPool, std::move(cmd_pool_state));
 }
 
 void ValidationStateTracker::PostCallRecordCreateQueryPool(VkDevice device, const VkQueryPoolCreateInfo *pCreateInfo,
@@ -2754,7 +2766,7 @@ void ValidationStateTracker::PostCallRecordCreateQueryPool(VkDevice device, cons
                                                                       &query_pool_state->n_performance_passes);
     }
 
-    queryPoolMap[*pQueryPool] = std::move(query_pool_state);
+    queryPoolMap.insert_or_assign(*pQueryPool, std::move(query_pool_state));
 
     QueryObject query_obj{*pQueryPool, 0u};
     for (uint32_t i = 0; i < pCreateInfo->queryCount; ++i) {
@@ -2808,44 +2820,57 @@ void ValidationStateTracker::PostCallRecordResetFences(VkDevice device, uint32_t
 // can also unlink objects from command buffers.
 void ValidationStateTracker::InvalidateCommandBuffers(small_unordered_map<CMD_BUFFER_STATE *, int, 8> &cb_nodes,
                                                       const VulkanTypedHandle &obj, bool unlink) {
-    for (const auto &cb_node_pair : cb_nodes) {
-        auto &cb_node = cb_node_pair.first;
-        if (cb_node->state == CB_RECORDING) {
-            cb_node->state = CB_INVALID_INCOMPLETE;
-        } else if (cb_node->state == CB_RECORDED) {
-            cb_node->state = CB_INVALID_COMPLETE;
-        }
-        cb_node->broken_bindings.push_back(obj);
-
-        // if secondary, then propagate the invalidation to the primaries that will call us.
-        if (cb_node->createInfo.level == VK_COMMAND_BUFFER_LEVEL_SECONDARY) {
-            InvalidateLinkedCommandBuffers(cb_node->linkedCommandBuffers, obj);
+    // The command buffers are invalidated after cb_binding_mutex is released, as their locks must be taken first
+    std::vector<CMD_BUFFER_STATE *> invalid_cbs;
+    {
+        auto binding_lock = cb_binding_lock();
+        invalid_cbs.reserve(cb_nodes.size());
+        for (const auto &cb_node_pair : cb_nodes) {
+            auto &cb_node = cb_node_pair.first;
+            invalid_cbs.push_back(cb_node);
+            if (unlink) {
+                int index = cb_node_pair.second;
+                assert(cb_node->object_bindings[index] == obj);
+                cb_node->object_bindings[index] = VulkanTypedHandle();
+            }
         }
         if (unlink) {
-            int index = cb_node_pair.second;
-            assert(cb_node->object_bindings[index] == obj);
-            cb_node->object_bindings[index] = VulkanTypedHandle();
+            cb_nodes.clear();
         }
     }
-    if (unlink) {
-        cb_nodes.clear();
+    for (auto cb_node : invalid_cbs) {
+        InvalidateCommandBuffer(cb_node, obj);
     }
 }
 
 void ValidationStateTracker::InvalidateLinkedCommandBuffers(std::unordered_set<CMD_BUFFER_STATE *> &cb_nodes,
                                                             const VulkanTypedHandle &obj) {
-    for (auto cb_node : cb_nodes) {
+    std::vector<CMD_BUFFER_STATE *> invalid_cbs;
+    {
+        auto binding_lock = cb_binding_lock();
+        invalid_cbs.assign(cb_nodes.begin(), cb_nodes.end());
+    }
+    for (auto cb_node : invalid_cbs) {
+        InvalidateCommandBuffer(cb_node, obj);
+    }
+}
+
+void ValidationStateTracker::InvalidateCommandBuffer(CMD_BUFFER_STATE *cb_node, const VulkanTypedHandle &obj) {
+    {
+        auto cb_lock = cb_state_lock(cb_node);
         if (cb_node->state == CB_RECORDING) {
             cb_node->state = CB_INVALID_INCOMPLETE;
         } else if (cb_node->state == CB_RECORDED) {
             cb_node->state = CB_INVALID_COMPLETE;
         }
         cb_node->broken_bindings.push_back(obj);
+        // Queued draw checks may point at the object being destroyed, and an invalid command buffer can't be submitted anyway
+        cb_node->deferred_draw_validation.clear();
+    }
 
-        // if secondary, then propagate the invalidation to the primaries that will call us.
-        if (cb_node->createInfo.level == VK_COMMAND_BUFFER_LEVEL_SECONDARY) {
-            InvalidateLinkedCommandBuffers(cb_node->linkedCommandBuffers, obj);
-        }
+    // if secondary, then propagate the invalidation to the primaries that will call us.
+    if (cb_node->createInfo.level == VK_COMMAND_BUFFER_LEVEL_SECONDARY) {
+        InvalidateLinkedCommandBuffers(cb_node->linkedCommandBuffers, obj);
     }
 }
 
@@ -2876,7 +2901,7 @@ void ValidationStateTracker::PostCallRecordCreateFence(VkDevice device, const Vk
     fence_state->fence = *pFence;
     fence_state->createInfo = *pCreateInfo;
     fence_state->state = (pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) ? FENCE_RETIRED : FENCE_UNSIGNALED;
-    fenceMap[*pFence] = std::move(fence_state);
+    fenceMap.insert_or_assign(*pFence, std::move(fence_state));
 }
 
 bool ValidationStateTracker::PreCallValidateCreateGraphicsPipelines(VkDevice device, VkPipelineCache pipelineCache, uint32_t count,
@@ -2904,7 +2929,7 @@ void ValidationStateTracker::PostCallRecordCreateGraphicsPipelines(VkDevice devi
     for (uint32_t i = 0; i < count; i++) {
         if (pPipelines[i] != VK_NULL_HANDLE) {
             (cgpl_state->pipe_state)[i]->pipeline = pPipelines[i];
-            pipelineMap[pPipelines[i]] = std::move((cgpl_state->pipe_state)[i]);
+            pipelineMap.insert_or_assign(pPipelines[i], std::move((cgpl_state->pipe_state)[i]));
         }
     }
     cgpl_state->pipe_state.clear();
@@ -2936,7 +2961,7 @@ void ValidationStateTracker::PostCallRecordCreateComputePipelines(VkDevice devic
     for (uint32_t i = 0; i < count; i++) {
         if (pPipelines[i] != VK_NULL_HANDLE) {
             (ccpl_state->pipe_state)[i]->pipeline = pPipelines[i];
-            pipelineMap[pPipelines[i]] = std::move((ccpl_state->pipe_state)[i]);
+            pipelineMap.insert_or_assign(pPipelines[i], std::move((ccpl_state->pipe_state)[i]));
         }
     }
     ccpl_state->pipe_state.clear();
@@ -2966,7 +2991,7 @@ void ValidationStateTracker::PostCallRecordCreateRayTracingPipelinesNV(
     for (uint32_t i = 0; i < count; i++) {
         if (pPipelines[i] != VK_NULL_HANDLE) {
             (crtpl_state->pipe_state)[i]->pipeline = pPipelines[i];
-            pipelineMap[pPipelines[i]] = std::move((crtpl_state->pipe_state)[i]);
+            pipelineMap.insert_or_assign(pPipelines[i], std::move((crtpl_state->pipe_state)[i]));
         }
     }
     crtpl_state->pipe_state.clear();
@@ -2996,7 +3021,7 @@ void ValidationStateTracker::PostCallRecordCreateRayTracingPipelinesKHR(
     for (uint32_t i = 0; i < count; i++) {
         if (pPipelines[i] != VK_NULL_HANDLE) {
             (crtpl_state->pipe_state)[i]->pipeline = pPipelines[i];
-            pipelineMap[pPipelines[i]] = std::move((crtpl_state->pipe_state)[i]);
+            pipelineMap.insert_or_assign(pPipelines[i], std::move((crtpl_state->pipe_state)[i]));
         }
     }
     crtpl_state->pipe_state.clear();
@@ -3005,7 +3030,7 @@ void ValidationStateTracker::PostCallRecordCreateRayTracingPipelinesKHR(
 void ValidationStateTracker::PostCallRecordCreateSampler(VkDevice device, const VkSamplerCreateInfo *pCreateInfo,
                                                          const VkAllocationCallbacks *pAllocator, VkSampler *pSampler,
                                                          VkResult result) {
-    samplerMap[*pSampler] = std::make_shared<SAMPLER_STATE>(pSampler, pCreateInfo);
+    samplerMap.insert_or_assign(*pSampler, std::make_shared<SAMPLER_STATE>(pSampler, pCreateInfo));
     if (pCreateInfo->borderColor == VK_BORDER_COLOR_INT_CUSTOM_EXT || pCreateInfo->borderColor == VK_BORDER_COLOR_FLOAT_CUSTOM_EXT)
         custom_border_color_sampler_count++;
 }
@@ -3015,7 +3040,8 @@ void ValidationStateTracker::PostCallRecordCreateDescriptorSetLayout(VkDevice de
                                                                      const VkAllocationCallbacks *pAllocator,
                                                                      VkDescriptorSetLayout *pSetLayout, VkResult result) {
     if (VK_SUCCESS != result) return;
-    descriptorSetLayoutMap[*pSetLayout] = std::make_shared<cvdescriptorset::DescriptorSetLayout>(pCreateInfo, *pSetLayout);
+    descriptorSetLayoutMap.insert_or_assign(*pSetLayout,
+                                            std::make_shared<cvdescriptorset::DescriptorSetLayout>(pCreateInfo, *pSetLayout));
 }
 
 // For repeatable sorting, not very useful for "memory in range" search
@@ -3090,14 +3116,14 @@ void ValidationStateTracker::PostCallRecordCreatePipelineLayout(VkDevice device,
         pipeline_layout_state->compat_for_set.emplace_back(
             GetCanonicalId(i, pipeline_layout_state->push_constant_ranges, set_layouts_id));
     }
-    pipelineLayoutMap[*pPipelineLayout] = std::move(pipeline_layout_state);
+    pipelineLayoutMap.insert_or_assign(*pPipelineLayout, std::move(pipeline_layout_state));
 }
 
 void ValidationStateTracker::PostCallRecordCreateDescriptorPool(VkDevice device, const VkDescriptorPoolCreateInfo *pCreateInfo,
                                                                 const VkAllocationCallbacks *pAllocator,
                                                                 VkDescriptorPool *pDescriptorPool, VkResult result) {
     if (VK_SUCCESS != result) return;
-    descriptorPoolMap[*pDescriptorPool] = std::make_shared<DESCRIPTOR_POOL_STATE>(*pDescriptorPool, pCreateInfo);
+    descriptorPoolMap.insert_or_assign(*pDescriptorPool, std::make_shared<DESCRIPTOR_POOL_STATE>(*pDescriptorPool, pCreateInfo));
 }
 
 void ValidationStateTracker::PostCallRecordResetDescriptorPool(VkDevice device, VkDescriptorPool descriptorPool,
@@ -3148,7 +3174,7 @@ void ValidationStateTracker::PreCallRecordFreeDescriptorSets(VkDevice device, Vk
     // For each freed descriptor add its resources back into the pool as available and remove from pool and setMap
     for (uint32_t i = 0; i < count; ++i) {
         if (pDescriptorSets[i] != VK_NULL_HANDLE) {
-            auto descriptor_set = setMap[pDescriptorSets[i]].get();
+            auto descriptor_set = GetSetNode(pDescriptorSets[i]);
             uint32_t type_index = 0, descriptor_count = 0;
             for (uint32_t j = 0; j < descriptor_set->GetBindingCount(); ++j) {
                 type_index = static_cast<uint32_t>(descriptor_set->GetTypeFromIndex(j));
@@ -3182,7 +3208,7 @@ void ValidationStateTracker::PostCallRecordAllocateCommandBuffers(VkDevice devic
             pCB->command_pool = pPool;
             pCB->unprotected = pPool->unprotected;
             // Add command buffer to map
-            commandBufferMap[pCommandBuffer[i]] = std::move(pCB);
+            commandBufferMap.insert_or_assign(pCommandBuffer[i], std::move(pCB));
             ResetCommandBufferState(pCommandBuffer[i]);
         }
     }
@@ -3478,7 +3504,7 @@ void ValidationStateTracker::PostCallRecordCreateAccelerationStructureNV(VkDevic
     DispatchGetAccelerationStructureMemoryRequirementsNV(device, &update_memory_req_info,
                                                          &as_state->update_scratch_memory_requirements);
     as_state->allocator = pAllocator;
-    accelerationStructureMap[*pAccelerationStructure] = std::move(as_state);
+    accelerationStructureMap.insert_or_assign(*pAccelerationStructure, std::move(as_state));
 }
 
 void ValidationStateTracker::PostCallRecordCreateAccelerationStructureKHR(VkDevice device,
@@ -3513,7 +3539,7 @@ void ValidationStateTracker::PostCallRecordCreateAccelerationStructureKHR(VkDevi
     DispatchGetAccelerationStructureMemoryRequirementsKHR(device, &update_memory_req_info,
                                                           &as_state->update_scratch_memory_requirements);
     as_state->allocator = pAllocator;
-    accelerationStructureMap[*pAccelerationStructure] = std::move(as_state);
+    accelerationStructureMap.insert_or_assign(*pAccelerationStructure, std::move(as_state));
 }
 
 void ValidationStateTracker::PostCallRecordGetAccelerationStructureMemoryRequirementsNV(
@@ -4102,7 +4128,7 @@ void ValidationStateTracker::PostCallRecordCreateFramebuffer(VkDevice device, co
             }
         }
     }
-    frameBufferMap[*pFramebuffer] = std::move(fb_state);
+    frameBufferMap.insert_or_assign(*pFramebuffer, std::move(fb_state));
 }
 
 void ValidationStateTracker::RecordRenderPassDAG(RenderPassCreateVersion rp_version, const VkRenderPassCreateInfo2KHR *pCreateInfo,
@@ -4321,7 +4347,7 @@ void ValidationStateTracker::RecordCreateRenderPassState(RenderPassCreateVersion
     }
 
     // Even though render_pass is an rvalue-ref parameter, still must move s.t. move assignment is invoked.
-    renderPassMap[*pRenderPass] = std::move(render_pass);
+    renderPassMap.insert_or_assign(*pRenderPass, std::move(render_pass));
 }
 
 // Style note:
@@ -4481,6 +4507,9 @@ void ValidationStateTracker::PreCallRecordCmdExecuteCommands(VkCommandBuffer com
     for (uint32_t i = 0; i < commandBuffersCount; i++) {
         sub_cb_state = GetCBState(pCommandBuffers[i]);
         assert(sub_cb_state);
+        // Other primaries may be executing the same secondary concurrently. Passing the primary itself is an error, but
+        // mustn't deadlock.
+        auto sub_cb_lock = cb_state_lock(sub_cb_state != cb_state ? sub_cb_state : nullptr);
         if (!(sub_cb_state->beginInfo.flags & VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT)) {
             if (cb_state->beginInfo.flags & VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT) {
                 // TODO: Because this is a state change, clearing the VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT needs to be moved
@@ -4505,8 +4534,11 @@ void ValidationStateTracker::PreCallRecordCmdExecuteCommands(VkCommandBuffer com
         }
 
         sub_cb_state->primaryCommandBuffer = cb_state->commandBuffer;
-        cb_state->linkedCommandBuffers.insert(sub_cb_state);
-        sub_cb_state->linkedCommandBuffers.insert(cb_state);
+        {
+            auto binding_lock = cb_binding_lock();
+            cb_state->linkedCommandBuffers.insert(sub_cb_state);
+            sub_cb_state->linkedCommandBuffers.insert(cb_state);
+        }
         for (auto &function : sub_cb_state->queryUpdates) {
             cb_state->queryUpdates.push_back(function);
         }
@@ -4704,7 +4736,7 @@ void ValidationStateTracker::RecordCreateSwapchainState(VkResult result, const V
             swapchain_state->shared_presentable = true;
         }
         surface_state->swapchain = swapchain_state.get();
-        swapchainMap[*pSwapchain] = std::move(swapchain_state);
+        swapchainMap.insert_or_assign(*pSwapchain, std::move(swapchain_state));
     } else {
         surface_state->swapchain = nullptr;
     }
@@ -4905,7 +4937,7 @@ void ValidationStateTracker::PreCallRecordDestroySurfaceKHR(VkInstance instance,
 }
 
 void ValidationStateTracker::RecordVulkanSurface(VkSurfaceKHR *pSurface) {
-    surface_map[*pSurface] = std::make_shared<SURFACE_STATE>(*pSurface);
+    surface_map.insert_or_assign(*pSurface, std::make_shared<SURFACE_STATE>(*pSurface));
 }
 
 void ValidationStateTracker::PostCallRecordCreateDisplayPlaneSurfaceKHR(VkInstance instance,
@@ -5220,7 +5252,7 @@ void ValidationStateTracker::PostCallRecordAcquireProfilingLockKHR(VkDevice devi
 
 void ValidationStateTracker::PostCallRecordReleaseProfilingLockKHR(VkDevice device) {
     performance_lock_acquired = false;
-    for (auto &cmd_buffer : commandBufferMap) {
+    for (const auto &cmd_buffer : commandBufferMap.snapshot()) {
         cmd_buffer.second->performance_lock_released = true;
     }
 }
@@ -5247,7 +5279,7 @@ void ValidationStateTracker::RecordCreateDescriptorUpdateTemplateState(const VkD
                                                                        VkDescriptorUpdateTemplateKHR *pDescriptorUpdateTemplate) {
     safe_VkDescriptorUpdateTemplateCreateInfo local_create_info(pCreateInfo);
     auto template_state = std::make_shared<TEMPLATE_STATE>(*pDescriptorUpdateTemplate, &local_create_info);
-    desc_template_map[*pDescriptorUpdateTemplate] = std::move(template_state);
+    desc_template_map.insert_or_assign(*pDescriptorUpdateTemplate, std::move(template_state));
 }
 
 void ValidationStateTracker::PostCallRecordCreateDescriptorUpdateTemplate(
@@ -5377,7 +5409,7 @@ void ValidationStateTracker::RecordCreateSamplerYcbcrConversionState(const VkSam
 
     ycbcr_state->chromaFilter = create_info->chromaFilter;
     ycbcr_state->format = conversion_format;
-    samplerYcbcrConversionMap[ycbcr_conversion] = std::move(ycbcr_state);
+    samplerYcbcrConversionMap.insert_or_assign(ycbcr_conversion, std::move(ycbcr_state));
 }
 
 void ValidationStateTracker::PostCallRecordCreateSamplerYcbcrConversion(VkDevice device,
@@ -5485,7 +5517,7 @@ void ValidationStateTracker::UpdateAllocateDescriptorSetsData(const VkDescriptor
 void ValidationStateTracker::PerformAllocateDescriptorSets(const VkDescriptorSetAllocateInfo *p_alloc_info,
                                                            const VkDescriptorSet *descriptor_sets,
                                                            const cvdescriptorset::AllocateDescriptorSetsData *ds_data) {
-    auto pool_state = descriptorPoolMap[p_alloc_info->descriptorPool].get();
+    auto pool_state = GetDescriptorPoolState(p_alloc_info->descriptorPool);
     // Account for sets and individual descriptors allocated from pool
     pool_state->availableSets -= p_alloc_info->descriptorSetCount;
     for (auto it = ds_data->required_descriptors_by_type.begin(); it != ds_data->required_descriptors_by_type.end(); ++it) {
@@ -5503,7 +5535,7 @@ void ValidationStateTracker::PerformAllocateDescriptorSets(const VkDescriptorSet
                                                                        variable_count, this);
         pool_state->sets.insert(new_ds.get());
         new_ds->in_use.store(0);
-        setMap[descriptor_sets[i]] = std::move(new_ds);
+        setMap.insert_or_assign(descriptor_sets[i], std::move(new_ds));
     }
 }
 
@@ -5655,7 +5687,7 @@ void ValidationStateTracker::PostCallRecordCreateShaderModule(VkDevice device, c
     auto new_shader_module = is_spirv ? std::make_shared<SHADER_MODULE_STATE>(pCreateInfo, *pShaderModule, spirv_environment,
                                                                               csm_state->unique_shader_id)
                                       : std::make_shared<SHADER_MODULE_STATE>();
-    shaderModuleMap[*pShaderModule] = std::move(new_shader_module);
+    shaderModuleMap.insert_or_assign(*pShaderModule, std::move(new_shader_module));
 }
 
 void ValidationStateTracker::RecordPipelineShaderStage(VkPipelineShaderStageCreateInfo const *pStage, PIPELINE_STATE *pipeline,
@@ -5670,14 +5702,15 @@ void ValidationStateTracker::RecordPipelineShaderStage(VkPipelineShaderStageCrea
 
     stage_state->stage_flag = pStage->stage;
 
-    // Mark accessible ids
-    stage_state->accessible_ids = MarkAccessibleIds(module, entrypoint);
-    ProcessExecutionModes(module, entrypoint, pipeline);
+    // Reflection of the entrypoint is shared by all pipelines using it, so is usually already built
+    stage_state->reflection = module->GetEntryPointReflection(entrypoint);
+    const auto &reflection = *stage_state->reflection;
+    if (reflection.topology_at_rasterizer != VK_PRIMITIVE_TOPOLOGY_MAX_ENUM) {
+        pipeline->topology_at_rasterizer = reflection.topology_at_rasterizer;
+    }
 
-    stage_state->descriptor_uses =
-        CollectInterfaceByDescriptorSlot(module, stage_state->accessible_ids, &stage_state->has_writable_descriptor);
     // Capture descriptor uses for the pipeline
-    for (auto use : stage_state->descriptor_uses) {
+    for (const auto &use : reflection.descriptor_uses) {
         // While validating shaders capture which slots are used by the pipeline
         const uint32_t slot = use.first.first;
         auto &reqs = pipeline->active_slots[slot][use.first.second];
@@ -5686,7 +5719,7 @@ void ValidationStateTracker::RecordPipelineShaderStage(VkPipelineShaderStageCrea
     }
 
     if (pStage->stage == VK_SHADER_STAGE_FRAGMENT_BIT) {
-        pipeline->fragmentShader_writable_output_location_list = CollectWritableOutputLocationinFS(*module, *pStage);
+        pipeline->fragmentShader_writable_output_location_list = reflection.writable_output_locations;
     }
 }
 
@@ -5755,8 +5788,7 @@ void ValidationStateTracker::PostCallRecordGetSwapchainImagesKHR(VkDevice device
             if (swapchain_state->createInfo.flags & VK_SWAPCHAIN_CREATE_MUTABLE_FORMAT_BIT_KHR)
                 image_ci.flags |= (VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT_KHR);
 
-            imageMap[pSwapchainImages[i]] = std::make_shared<IMAGE_STATE>(device, pSwapchainImages[i], &image_ci);
-            auto &image_state = imageMap[pSwapchainImages[i]];
+            auto image_state = std::make_shared<IMAGE_STATE>(device, pSwapchainImages[i], &image_ci);
             image_state->valid = false;
             image_state->create_from_swapchain = swapchain;
             image_state->bind_swapchain = swapchain;
@@ -5766,6 +5798,7 @@ void ValidationStateTracker::PostCallRecordGetSwapchainImagesKHR(VkDevice device
             swapchain_state->images[i].bound_images.emplace(pSwapchainImages[i]);
 
             AddImageStateProps(*image_state, device, physical_device);
+            imageMap.insert_or_assign(pSwapchainImages[i], std::move(image_state));
         }
     }
 
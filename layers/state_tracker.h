@@ -40,6 +40,7 @@
 #include <list>
 #include <deque>
 #include <map>
+#include <mutex>
 
 uint32_t ResolveRemainingLevels(const VkImageSubresourceRange* range, uint32_t mip_levels);
 uint32_t ResolveRemainingLayers(const VkImageSubresourceRange* range, uint32_t layers);
@@ -375,7 +376,7 @@ class ValidationStateTracker : public ValidationObject {
         using SharedType = std::shared_ptr<StateType>;
         using ConstSharedType = std::shared_ptr<const StateType>;
         using MappedType = std::shared_ptr<StateType>;
-        using MapType = unordered_map<HandleType, MappedType>;
+        using MapType = vl_concurrent_unordered_map<HandleType, MappedType, 4>;
     };
 
     // Override base class, we have some extra work to do here
@@ -433,7 +434,7 @@ class ValidationStateTracker : public ValidationObject {
             (Traits::kInstanceScope && (this->*map_member).size() == 0) ? instance_state->*map_member : this->*map_member;
 
         const auto found_it = map.find(handle);
-        if (found_it == map.cend()) {
+        if (found_it == map.end()) {
             return nullptr;
         }
         return found_it->second.get();
@@ -461,7 +462,7 @@ class ValidationStateTracker : public ValidationObject {
             (Traits::kInstanceScope && (this->*map_member).size() == 0) ? instance_state->*map_member : this->*map_member;
 
         const auto found_it = map.find(handle);
-        if (found_it == map.cend()) {
+        if (found_it == map.end()) {
             return nullptr;
         }
         return found_it->second;
@@ -477,7 +478,7 @@ class ValidationStateTracker : public ValidationObject {
             (Traits::kInstanceScope && (this->*map_member).size() == 0) ? instance_state->*map_member : this->*map_member;
 
         const auto found_it = map.find(handle);
-        if (found_it == map.cend()) {
+        if (found_it == map.end()) {
             return nullptr;
         }
         return found_it->second;
@@ -1167,6 +1168,24 @@ class ValidationStateTracker : public ValidationObject {
     void PostCallRecordCreateHeadlessSurfaceEXT(VkInstance instance, const VkHeadlessSurfaceCreateInfoEXT* pCreateInfo,
                                                 const VkAllocationCallbacks* pAllocator, VkSurfaceKHR* pSurface, VkResult result);
 
+    // With fine_grained_locking, command buffers record without holding the validation object lock, so the links between
+    // command buffers and the device level objects they reference (cb_bindings, object_bindings and linkedCommandBuffers)
+    // are guarded by cb_binding_mutex instead.
+    std::unique_lock<std::mutex> cb_binding_lock() const {
+        std::unique_lock<std::mutex> lock(cb_binding_mutex, std::defer_lock);
+        if (enabled[fine_grained_locking]) lock.lock();
+        return lock;
+    }
+    mutable std::mutex cb_binding_mutex;
+    // State that a command buffer's own vkCmd* calls read (state, broken_bindings, primaryCommandBuffer and
+    // linkedCommandBuffers) is only changed from elsewhere holding that command buffer's lock. It is taken before
+    // cb_binding_mutex, and only one command buffer lock is held at a time, except by vkCmdExecuteCommands, which locks
+    // its secondaries while holding the primary's. Nothing is locked for a null cb_state.
+    write_lock_guard_t cb_state_lock(const CMD_BUFFER_STATE* cb_state) const {
+        if (!cb_state || !enabled[fine_grained_locking]) return write_lock_guard_t();
+        return write_lock_guard_t(cb_state->lock);
+    }
+
     // State Utilty functions
     bool AddCommandBufferMem(small_unordered_map<CMD_BUFFER_STATE*, int, 8>& cb_bindings, VkDeviceMemory obj,
                              CMD_BUFFER_STATE* cb_node);
@@ -1202,6 +1221,7 @@ class ValidationStateTracker : public ValidationObject {
     void InvalidateCommandBuffers(small_unordered_map<CMD_BUFFER_STATE*, int, 8>& cb_nodes, const VulkanTypedHandle& obj,
                                   bool unlink = true);
     void InvalidateLinkedCommandBuffers(std::unordered_set<CMD_BUFFER_STATE*>& cb_nodes, const VulkanTypedHandle& obj);
+    void InvalidateCommandBuffer(CMD_BUFFER_STATE* cb_node, const VulkanTypedHandle& obj);
     void PerformAllocateDescriptorSets(const VkDescriptorSetAllocateInfo*, const VkDescriptorSet*,
                                        const cvdescriptorset::AllocateDescriptorSetsData*);
     void PerformUpdateDescriptorSetsWithTemplateKHR(VkDescriptorSet descriptorSet, const TEMPLATE_STATE* template_state,
@@ -17,6 +17,7 @@
  * Author: John Zulauf <jzulauf@lunarg.com>
  */
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 #include <memory>
@@ -108,6 +109,28 @@ static std::string string_UsageTag(const HazardResult &hazard) {
     return out.str();
 }
 
+// For hazards against the accesses of a queue, whose tags index its submissions
+static std::string string_SubmitUsageTag(const HazardResult &hazard) {
+    std::stringstream out;
+    const auto *info = SyncStageAccessInfoFromMask(hazard.prior_access);
+    const char *stage_access_name = info ? info->name : "INVALID_STAGE_ACCESS";
+    out << "(stage/access " << stage_access_name;
+    out << ", command " << CommandTypeString(hazard.tag.command);
+    out << ", submission #" << hazard.tag.index << ")";
+    return out.str();
+}
+
+// For hazards against the accesses of the command buffers earlier in the same vkCmdExecuteCommands
+static std::string string_ExecutedUsageTag(const HazardResult &hazard) {
+    std::stringstream out;
+    const auto *info = SyncStageAccessInfoFromMask(hazard.prior_access);
+    const char *stage_access_name = info ? info->name : "INVALID_STAGE_ACCESS";
+    out << "(stage/access " << stage_access_name;
+    out << ", command " << CommandTypeString(hazard.tag.command);
+    out << ", pCommandBuffers[" << hazard.tag.index << "])";
+    return out.str();
+}
+
 // NOTE: the attachement read flag is put *only* in the access scope and not in the exect scope, since the ordering
 //       rules apply only to this specific access for this stage, and not the stage as a whole. The ordering detection
 //       also reflects this special case for read hazard detection (using access instead of exec scope)
@@ -395,6 +418,14 @@ AccessContext::AccessContext(uint32_t subpass, VkQueueFlags queue_flags,
     }
 }
 
+AccessContext::AccessContext(const AccessContext &base, CopyOnWrite)
+    : prev_(base.prev_),
+      prev_by_subpass_(base.prev_by_subpass_),
+      async_(base.async_),
+      src_external_(base.src_external_),
+      dst_external_(base.dst_external_),
+      base_(&base) {}
+
 template <typename Detector>
 HazardResult AccessContext::DetectPreviousHazard(AddressType type, const Detector &detector,
                                                  const ResourceAccessRange &range) const {
@@ -403,7 +434,7 @@ HazardResult AccessContext::DetectPreviousHazard(AddressType type, const Detecto
 
     HazardResult hazard;
     for (auto prev = descent_map.begin(); prev != descent_map.end() && !hazard.hazard; ++prev) {
-        hazard = detector.Detect(prev);
+        hazard = detector.Detect(prev->second);
     }
     return hazard;
 }
@@ -425,36 +456,40 @@ HazardResult AccessContext::DetectHazard(AddressType type, const Detector &detec
     }
 
     const bool detect_prev = (static_cast<uint32_t>(options) & DetectOptions::kDetectPrevious) != 0;
+    // The gaps of a copy-on-write context are covered by its base, which shares the previous contexts (the async ones are
+    // already done)
+    const auto base_options = static_cast<DetectOptions>(options & DetectOptions::kDetectPrevious);
 
     const auto &accesses = GetAccessStateMap(type);
     const auto from = accesses.lower_bound(range);
     const auto to = accesses.upper_bound(range);
     ResourceAccessRange gap = {range.begin, range.begin};
+    ResourceAccessState scratch;
 
     for (auto pos = from; pos != to; ++pos) {
         // Cover any leading gap, or gap between entries
-        if (detect_prev) {
+        if (detect_prev || base_) {
             // TODO: After profiling we may want to change the descent logic such that we don't recur per gap...
             // Cover any leading gap, or gap between entries
             gap.end = pos->first.begin;  // We know this begin is < range.end
             if (gap.non_empty()) {
                 // Recur on all gaps
-                hazard = DetectPreviousHazard(type, detector, gap);
+                hazard = base_ ? base_->DetectHazard(type, detector, gap, base_options) : DetectPreviousHazard(type, detector, gap);
                 if (hazard.hazard) return hazard;
             }
             // Set up for the next gap.  If pos..end is >= range.end, loop will exit, and trailing gap will be empty
             gap.begin = pos->first.end;
         }
 
-        hazard = detector.Detect(pos);
+        hazard = detector.Detect(GetCurrentAccessState(pos->second, &scratch));
         if (hazard.hazard) return hazard;
     }
 
-    if (detect_prev) {
+    if (detect_prev || base_) {
         // Detect in the trailing empty as needed
         gap.end = range.end;
         if (gap.non_empty()) {
-            hazard = DetectPreviousHazard(type, detector, gap);
+            hazard = base_ ? base_->DetectHazard(type, detector, gap, base_options) : DetectPreviousHazard(type, detector, gap);
         }
     }
 
@@ -469,8 +504,25 @@ HazardResult AccessContext::DetectAsyncHazard(AddressType type, const Detector &
     const auto to = accesses.upper_bound(range);
 
     HazardResult hazard;
+    ResourceAccessState scratch;
+    ResourceAccessRange gap = {range.begin, range.begin};
     for (auto pos = from; pos != to && !hazard.hazard; ++pos) {
-        hazard = detector.DetectAsync(pos);
+        if (base_) {
+            // The gaps of a copy-on-write context are covered by its base
+            gap.end = pos->first.begin;
+            if (gap.non_empty()) {
+                hazard = base_->DetectAsyncHazard(type, detector, gap);
+                if (hazard.hazard) return hazard;
+            }
+            gap.begin = pos->first.end;
+        }
+        hazard = detector.DetectAsync(GetCurrentAccessState(pos->second, &scratch));
+    }
+    if (base_ && !hazard.hazard) {
+        gap.end = range.end;
+        if (gap.non_empty()) {
+            hazard = base_->DetectAsyncHazard(type, detector, gap);
+        }
     }
 
     return hazard;
@@ -501,12 +553,26 @@ void AccessContext::ResolveAccessRange(AddressType type, const ResourceAccessRan
                                        bool recur_to_infill) const {
     if (!range.non_empty()) return;
 
-    ResourceRangeMergeIterator current(*resolve_map, GetAccessStateMap(type), range.begin);
+    // For a copy-on-write context, resolve from the accesses a full copy of the base would have within range
+    ResourceAccessRangeMap base_accesses;
+    if (base_) {
+        const auto &accesses = GetAccessStateMap(type);
+        const auto to = accesses.upper_bound(range);
+        for (auto pos = accesses.lower_bound(range); pos != to; ++pos) {
+            base_accesses.insert(base_accesses.end(), *pos);
+        }
+        ResolveBaseAccesses(type, range, &base_accesses);
+    }
+
+    ResourceRangeMergeIterator current(*resolve_map, base_ ? base_accesses : GetAccessStateMap(type), range.begin);
     while (current->range.non_empty() && range.includes(current->range.begin)) {
         const auto current_range = current->range & range;
         if (current->pos_B->valid) {
             const auto &src_pos = current->pos_B->lower_bound;
+            // The copy leaves this context, so it takes the global barriers still pending here along
             auto access = src_pos->second;
+            access.ApplyPendingGlobalBarriers(global_barriers_);
+            access.SetGlobalBarrierEpoch(0);
             if (barrier) {
                 access.ApplyBarrier(*barrier);
             }
@@ -610,7 +676,7 @@ static SyncStageAccessIndex DepthStencilLoadUsage(VkAttachmentLoadOp load_op) {
 static AccessContext *CreateStoreResolveProxyContext(const AccessContext &context, const RENDER_PASS_STATE &rp_state,
                                                      uint32_t subpass, const VkRect2D &render_area,
                                                      std::vector<const IMAGE_VIEW_STATE *> attachment_views) {
-    auto *proxy = new AccessContext(context);
+    auto *proxy = new AccessContext(context, AccessContext::CopyOnWrite());
     proxy->UpdateAttachmentResolveAccess(rp_state, render_area, attachment_views, subpass, kCurrentCommandTag);
     proxy->UpdateAttachmentStoreAccess(rp_state, render_area, attachment_views, subpass, kCurrentCommandTag);
     return proxy;
@@ -850,10 +916,8 @@ class HazardDetector {
     SyncStageAccessIndex usage_index_;
 
   public:
-    HazardResult Detect(const ResourceAccessRangeMap::const_iterator &pos) const { return pos->second.DetectHazard(usage_index_); }
-    HazardResult DetectAsync(const ResourceAccessRangeMap::const_iterator &pos) const {
-        return pos->second.DetectAsyncHazard(usage_index_);
-    }
+    HazardResult Detect(const ResourceAccessState &access) const { return access.DetectHazard(usage_index_); }
+    HazardResult DetectAsync(const ResourceAccessState &access) const { return access.DetectAsyncHazard(usage_index_); }
     HazardDetector(SyncStageAccessIndex usage) : usage_index_(usage) {}
 };
 
@@ -862,12 +926,8 @@ class HazardDetectorWithOrdering {
     const SyncOrderingBarrier &ordering_;
 
   public:
-    HazardResult Detect(const ResourceAccessRangeMap::const_iterator &pos) const {
-        return pos->second.DetectHazard(usage_index_, ordering_);
-    }
-    HazardResult DetectAsync(const ResourceAccessRangeMap::const_iterator &pos) const {
-        return pos->second.DetectAsyncHazard(usage_index_);
-    }
+    HazardResult Detect(const ResourceAccessState &access) const { return access.DetectHazard(usage_index_, ordering_); }
+    HazardResult DetectAsync(const ResourceAccessState &access) const { return access.DetectAsyncHazard(usage_index_); }
     HazardDetectorWithOrdering(SyncStageAccessIndex usage, const SyncOrderingBarrier &ordering)
         : usage_index_(usage), ordering_(ordering) {}
 };
@@ -951,12 +1011,12 @@ class BarrierHazardDetector {
                           SyncStageAccessFlags src_access_scope)
         : usage_index_(usage_index), src_exec_scope_(src_exec_scope), src_access_scope_(src_access_scope) {}
 
-    HazardResult Detect(const ResourceAccessRangeMap::const_iterator &pos) const {
-        return pos->second.DetectBarrierHazard(usage_index_, src_exec_scope_, src_access_scope_);
+    HazardResult Detect(const ResourceAccessState &access) const {
+        return access.DetectBarrierHazard(usage_index_, src_exec_scope_, src_access_scope_);
     }
-    HazardResult DetectAsync(const ResourceAccessRangeMap::const_iterator &pos) const {
+    HazardResult DetectAsync(const ResourceAccessState &access) const {
         // Async barrier hazard detection can use the same path as the usage index is not IsRead, but is IsWrite
-        return pos->second.DetectAsyncHazard(usage_index_);
+        return access.DetectAsyncHazard(usage_index_);
     }
 
   private:
@@ -1020,8 +1080,7 @@ SyncStageAccessFlags SyncStageAccess::AccessScope(VkPipelineStageFlags stages, V
 
 template <typename Action>
 void UpdateMemoryAccessState(ResourceAccessRangeMap *accesses, const ResourceAccessRange &range, const Action &action) {
-    // TODO: Optimization for operations that do a pure overwrite (i.e. WRITE usages which rewrite the state, vs READ usages
-    //       that do incrementalupdates
+    // Note: writes, which overwrite the state rather than updating it, mostly take AccessContext::OverwriteAccessState instead
     auto pos = accesses->lower_bound(range);
     if (pos == accesses->end() || !pos->first.intersects(range)) {
         // The range is empty, fill it with a default value.
@@ -1056,6 +1115,24 @@ void UpdateMemoryAccessState(ResourceAccessRangeMap *accesses, const ResourceAcc
     }
 }
 
+// Accesses must be current with the global barrier log before being updated, and those infilled by the action are current
+// by definition
+template <typename Action>
+void AccessContext::UpdateMemoryAccessState(AddressType type, const ResourceAccessRange &range, const Action &action) {
+    auto *accesses = &GetAccessStateMap(type);
+    if (base_) {
+        // Copy in what the base holds for the range before changing it
+        ResolveBaseAccesses(type, range, accesses);
+    }
+    if (global_barriers_.empty()) {
+        ::UpdateMemoryAccessState(accesses, range, action);
+        return;
+    }
+    ApplyPendingGlobalBarriers(type, range);
+    ::UpdateMemoryAccessState(accesses, range, action);
+    SetGlobalBarrierEpoch(type, range);
+}
+
 struct UpdateMemoryAccessStateFunctor {
     using Iterator = ResourceAccessRangeMap::iterator;
     Iterator Infill(ResourceAccessRangeMap *accesses, Iterator pos, ResourceAccessRange range) const {
@@ -1103,42 +1180,67 @@ struct ApplyMemoryAccessBarrierFunctor {
     SyncStageAccessFlags dst_access_scope;
 };
 
-struct ApplyGlobalBarrierFunctor {
-    using Iterator = ResourceAccessRangeMap::iterator;
-    inline Iterator Infill(ResourceAccessRangeMap *accesses, Iterator pos, ResourceAccessRange range) const { return pos; }
-
-    Iterator operator()(ResourceAccessRangeMap *accesses, Iterator pos) const {
-        auto &access_state = pos->second;
-        access_state.ApplyExecutionBarrier(src_exec_scope, dst_exec_scope);
+void AccessContext::UpdateAccessState(AddressType type, SyncStageAccessIndex current_usage, const ResourceAccessRange &range,
+                                      const ResourceUsageTag &tag) {
+    if (SyncStageAccess::IsWrite(current_usage) && OverwriteAccessState(type, current_usage, range, tag)) return;
+    UpdateMemoryAccessStateFunctor action(type, *this, current_usage, tag);
+    UpdateMemoryAccessState(type, range, action);
+}
 
-        for (const auto &functor : barrier_functor) {
-            functor(accesses, pos);
-        }
-        return pos;
+// A write supersedes every earlier access, so rather than splitting and updating each entry within range, the whole of it is
+// replaced with a single entry, merged with equal neighbours. Of the states replaced, only the first accesses carry over, so this
+// is only possible where they are the same throughout, as they are once the range has been written. Returns false otherwise.
+bool AccessContext::OverwriteAccessState(AddressType type, SyncStageAccessIndex current_usage, const ResourceAccessRange &range,
+                                         const ResourceUsageTag &tag) {
+    if (!range.non_empty()) return false;
+    auto &accesses = GetAccessStateMap(type);
+    if (base_) {
+        ResolveBaseAccesses(type, range, &accesses);
     }
-
-    ApplyGlobalBarrierFunctor(VkPipelineStageFlags src_exec_scope, VkPipelineStageFlags dst_exec_scope,
-                              SyncStageAccessFlags src_stage_accesses, SyncStageAccessFlags dst_stage_accesses,
-                              uint32_t memoryBarrierCount, const VkMemoryBarrier *pMemoryBarriers)
-        : src_exec_scope(src_exec_scope), dst_exec_scope(dst_exec_scope) {
-        // Don't want to create this per tracked item, but don't want to loop through all tracked items per barrier...
-        barrier_functor.reserve(memoryBarrierCount);
-        for (uint32_t barrier_index = 0; barrier_index < memoryBarrierCount; barrier_index++) {
-            const auto &barrier = pMemoryBarriers[barrier_index];
-            barrier_functor.emplace_back(src_exec_scope, SyncStageAccess::AccessScope(src_stage_accesses, barrier.srcAccessMask),
-                                         dst_exec_scope, SyncStageAccess::AccessScope(dst_stage_accesses, barrier.dstAccessMask));
+    // Gaps are filled in from the previous contexts, so are only known to be free of accesses in a context without any
+    const bool has_previous = !prev_.empty() || src_external_.context;
+    const ResourceAccessState empty_state;
+    const ResourceAccessState *prior_state = nullptr;
+    const auto same_first_accesses = [&prior_state](const ResourceAccessState &state) -> bool {
+        if (!prior_state) prior_state = &state;
+        return prior_state->GetFirstAccesses() == state.GetFirstAccesses();
+    };
+    VkDeviceSize covered = range.begin;
+    const auto to = accesses.upper_bound(range);
+    for (auto pos = accesses.lower_bound(range); pos != to; ++pos) {
+        if ((pos->first.begin > covered) && (has_previous || !same_first_accesses(empty_state))) return false;
+        if (!same_first_accesses(pos->second)) return false;
+        covered = pos->first.end;
+    }
+    if ((covered < range.end) && (has_previous || !same_first_accesses(empty_state))) return false;
+
+    auto overwrite = *prior_state;
+    overwrite.Update(current_usage, tag);
+    const auto epoch = static_cast<uint32_t>(global_barriers_.size());
+    overwrite.SetGlobalBarrierEpoch(epoch);
+    auto pos = accesses.overwrite_range(std::make_pair(range, overwrite));
+
+    // Neighbours with pending global barriers aren't the same as they look, and equality leaves the first accesses to compare
+    const auto mergeable = [&overwrite, this](const ResourceAccessState &state) {
+        return (state == overwrite) && (state.GetFirstAccesses() == overwrite.GetFirstAccesses()) &&
+               !state.HasPendingGlobalBarriers(global_barriers_);
+    };
+    ResourceAccessRange merged = range;
+    auto next = pos;
+    ++next;
+    if ((next != accesses.end()) && next->first.is_subsequent_to(range) && mergeable(next->second)) {
+        merged.end = next->first.end;
+    }
+    if (range.begin > 0) {
+        const auto prev = accesses.lower_bound(ResourceAccessRange(range.begin - 1, range.begin));
+        if ((prev != pos) && (prev->first.end == range.begin) && mergeable(prev->second)) {
+            merged.begin = prev->first.begin;
         }
     }
-
-    const VkPipelineStageFlags src_exec_scope;
-    const VkPipelineStageFlags dst_exec_scope;
-    std::vector<ApplyMemoryAccessBarrierFunctor> barrier_functor;
-};
-
-void AccessContext::UpdateAccessState(AddressType type, SyncStageAccessIndex current_usage, const ResourceAccessRange &range,
-                                      const ResourceUsageTag &tag) {
-    UpdateMemoryAccessStateFunctor action(type, *this, current_usage, tag);
-    UpdateMemoryAccessState(&GetAccessStateMap(type), range, action);
+    if (merged != range) {
+        accesses.overwrite_range(std::make_pair(merged, overwrite));
+    }
+    return true;
 }
 
 void AccessContext::UpdateAccessState(const BUFFER_STATE &buffer, SyncStageAccessIndex current_usage,
@@ -1155,9 +1257,8 @@ void AccessContext::UpdateAccessState(const IMAGE_STATE &image, SyncStageAccessI
     subresource_adapter::ImageRangeGenerator range_gen(*image.fragment_encoder.get(), subresource_range, offset, extent);
     const auto address_type = ImageAddressType(image);
     const auto base_address = ResourceBaseAddress(image);
-    UpdateMemoryAccessStateFunctor action(address_type, *this, current_usage, tag);
     for (; range_gen->non_empty(); ++range_gen) {
-        UpdateMemoryAccessState(&GetAccessStateMap(address_type), (*range_gen + base_address), action);
+        UpdateAccessState(address_type, current_usage, (*range_gen + base_address), tag);
     }
 }
 void AccessContext::UpdateAccessState(const IMAGE_VIEW_STATE *view, SyncStageAccessIndex current_usage, const VkOffset3D &offset,
@@ -1189,7 +1290,7 @@ template <typename Action>
 void AccessContext::UpdateMemoryAccess(const BUFFER_STATE &buffer, const ResourceAccessRange &range, const Action action) {
     if (!SimpleBinding(buffer)) return;
     const auto base_address = ResourceBaseAddress(buffer);
-    UpdateMemoryAccessState(&GetAccessStateMap(AddressType::kLinearAddress), (range + base_address), action);
+    UpdateMemoryAccessState(AddressType::kLinearAddress, (range + base_address), action);
 }
 
 template <typename Action>
@@ -1197,14 +1298,13 @@ void AccessContext::UpdateMemoryAccess(const IMAGE_STATE &image, const VkImageSu
                                        const Action action) {
     if (!SimpleBinding(image)) return;
     const auto address_type = ImageAddressType(image);
-    auto *accesses = &GetAccessStateMap(address_type);
 
     subresource_adapter::ImageRangeGenerator range_gen(*image.fragment_encoder.get(), subresource_range, {0, 0, 0},
                                                        image.createInfo.extent);
 
     const auto base_address = ResourceBaseAddress(image);
     for (; range_gen->non_empty(); ++range_gen) {
-        UpdateMemoryAccessState(accesses, (*range_gen + base_address), action);
+        UpdateMemoryAccessState(address_type, (*range_gen + base_address), action);
     }
 }
 
@@ -1256,15 +1356,169 @@ void AccessContext::UpdateAttachmentStoreAccess(const RENDER_PASS_STATE &rp_stat
     }
 }
 
-template <typename Action>
-void AccessContext::ApplyGlobalBarriers(const Action &barrier_action) {
+void AccessContext::ApplyGlobalBarrier(SyncGlobalBarrier &&barrier) {
     // Note: Barriers do *not* cross context boundaries, applying to accessess within.... (at least for renderpass subpasses)
+    DetachFromBase();
+    bool has_accesses = false;
+    for (const auto &accesses : access_state_maps_) {
+        has_accesses |= !accesses.empty();
+    }
+    // Accesses added later are unaffected by the barrier, so with nothing tracked there is nothing to apply it to
+    if (!has_accesses) return;
+
+    if (global_barriers_.size() >= kMaxPendingGlobalBarriers) {
+        ApplyPendingGlobalBarriers();
+    }
+    global_barriers_.emplace_back(std::move(barrier));
+}
+
+void AccessContext::ApplyPendingGlobalBarriers() {
+    if (global_barriers_.empty()) return;
+    for (auto &accesses : access_state_maps_) {
+        for (auto &entry : accesses) {
+            entry.second.ApplyPendingGlobalBarriers(global_barriers_);
+            entry.second.SetGlobalBarrierEpoch(0);
+        }
+    }
+    global_barriers_.clear();
+}
+
+void AccessContext::ApplyPendingGlobalBarriers(AddressType type, const ResourceAccessRange &range) {
+    auto &accesses = GetAccessStateMap(type);
+    const auto to = accesses.upper_bound(range);
+    for (auto pos = accesses.lower_bound(range); pos != to; ++pos) {
+        pos->second.ApplyPendingGlobalBarriers(global_barriers_);
+    }
+}
+
+void AccessContext::SetGlobalBarrierEpoch(AddressType type, const ResourceAccessRange &range) {
+    const auto epoch = static_cast<uint32_t>(global_barriers_.size());
+    auto &accesses = GetAccessStateMap(type);
+    const auto to = accesses.upper_bound(range);
+    for (auto pos = accesses.lower_bound(range); pos != to; ++pos) {
+        pos->second.SetGlobalBarrierEpoch(epoch);
+    }
+}
+
+// The parts of range with no entry in accesses, found up front as filling them changes the map
+static std::vector<ResourceAccessRange> GetGaps(const ResourceAccessRangeMap &accesses, const ResourceAccessRange &range) {
+    std::vector<ResourceAccessRange> gaps;
+    ResourceAccessRange gap = {range.begin, range.begin};
+    const auto to = accesses.upper_bound(range);
+    for (auto pos = accesses.lower_bound(range); pos != to; ++pos) {
+        gap.end = pos->first.begin;
+        if (gap.non_empty()) gaps.emplace_back(gap);
+        gap.begin = pos->first.end;
+    }
+    gap.end = range.end;
+    if (gap.non_empty()) gaps.emplace_back(gap);
+    return gaps;
+}
+
+// Fill the gaps of accesses within range with the accesses of the copy-on-write base
+void AccessContext::ResolveBaseAccesses(AddressType type, const ResourceAccessRange &range,
+                                        ResourceAccessRangeMap *accesses) const {
+    // Copies resolved out of the base arrive current with its global barriers, and a context with a base has none of its own
+    assert(global_barriers_.empty());
+    for (const auto &fill : GetGaps(*accesses, range)) {
+        base_->ResolveAccessRange(type, fill, nullptr, accesses, nullptr, false);
+    }
+}
+
+template <typename Action>
+void AccessContext::ImportAccessRange(const AccessContext &from, AddressType type, const ResourceAccessRange &range,
+                                      const Action &seed_action) {
+    auto &accesses = GetAccessStateMap(type);
+    // The copies arrive current with the global barriers of from, and seed_action brings them up to date with those of this
+    const auto epoch = static_cast<uint32_t>(global_barriers_.size());
+    for (const auto &gap : GetGaps(accesses, range)) {
+        from.ResolveAccessRange(type, gap, nullptr, &accesses, nullptr, false);
+        const auto to = accesses.upper_bound(gap);
+        for (auto pos = accesses.lower_bound(gap); pos != to; ++pos) {
+            seed_action(&pos->second);
+            pos->second.SetGlobalBarrierEpoch(epoch);
+        }
+    }
+}
+
+void AccessContext::ApplyExecutedAccesses(const AccessContext &executed, uint64_t execute_index) {
+    DetachFromBase();
+    const auto epoch = static_cast<uint32_t>(global_barriers_.size());
+    for (const auto address_type : kAddressTypes) {
+        const auto &executed_accesses = executed.GetAccessStateMap(address_type);
+        if (executed_accesses.empty()) continue;
+        auto &accesses = GetAccessStateMap(address_type);
+        const auto executed_end = executed_accesses.cend();
+        ResourceRangeMergeIterator current(accesses, executed_accesses, executed_accesses.cbegin()->first.begin);
+        while (current->range.non_empty() && (current->pos_B->lower_bound != executed_end)) {
+            if (current->pos_B->valid) {
+                const auto &executed_access = current->pos_B->lower_bound->second;
+                if (current->pos_A->valid) {
+                    const auto trimmed = sparse_container::split(current->pos_A->lower_bound, accesses, current->range);
+                    trimmed->second.ApplyPendingGlobalBarriers(global_barriers_);
+                    trimmed->second.ApplyExecutedAccesses(executed_access, execute_index);
+                    current.invalidate_A(trimmed);
+                } else {
+                    // Start from what the previous contexts hold for the gap, as UpdateAccessState would
+                    const auto gap = current->range;
+                    ResourceAccessState default_state;
+                    ResolvePreviousAccess(address_type, gap, &accesses, &default_state);
+                    const auto to = accesses.upper_bound(gap);
+                    for (auto pos = accesses.lower_bound(gap); pos != to; ++pos) {
+                        pos->second.ApplyExecutedAccesses(executed_access, execute_index);
+                        pos->second.SetGlobalBarrierEpoch(epoch);
+                    }
+                    // The gap may have been filled with several entries, so step past them as ResolveAccessRange does
+                    current.invalidate_A();
+                    current.seek(gap.end - 1);
+                }
+            }
+            ++current;
+        }
+    }
+}
+
+void AccessContext::Coalesce(const std::vector<SyncRecordedBarrier> &recorded_barriers) {
+    ApplyPendingGlobalBarriers();
+    for (auto &accesses : access_state_maps_) {
+        ResourceAccessRangeMap coalesced;
+        auto pos = accesses.cbegin();
+        while (pos != accesses.cend()) {
+            auto range = pos->first;
+            auto next = pos;
+            ++next;
+            while ((next != accesses.cend()) && next->first.is_subsequent_to(range) && (next->second == pos->second) &&
+                   next->second.HasEquivalentFirstAccesses(pos->second, recorded_barriers)) {
+                range.end = next->first.end;
+                ++next;
+            }
+            coalesced.insert(coalesced.end(), std::make_pair(range, pos->second));
+            pos = next;
+        }
+        accesses = std::move(coalesced);
+    }
+}
+
+void AccessContext::DetachFromBase() {
+    if (!base_) return;
     for (const auto address_type : kAddressTypes) {
-        UpdateMemoryAccessState(&GetAccessStateMap(address_type), full_range, barrier_action);
+        ResolveBaseAccesses(address_type, full_range, &GetAccessStateMap(address_type));
     }
+    base_ = nullptr;
+}
+
+const ResourceAccessState &AccessContext::GetCurrentAccessState(const ResourceAccessState &access,
+                                                                ResourceAccessState *scratch) const {
+    if (!access.HasPendingGlobalBarriers(global_barriers_)) return access;
+    *scratch = access;
+    scratch->ApplyPendingGlobalBarriers(global_barriers_);
+    return *scratch;
 }
 
 void AccessContext::ResolveChildContexts(const std::vector<AccessContext> &contexts) {
+    // The child accesses are resolved into the current state of this context
+    DetachFromBase();
+    ApplyPendingGlobalBarriers();
     for (uint32_t subpass_index = 0; subpass_index < contexts.size(); subpass_index++) {
         auto &context = contexts[subpass_index];
         for (const auto address_type : kAddressTypes) {
@@ -1385,7 +1639,8 @@ bool CommandBufferAccessContext::ValidateDispatchDrawDescriptorSet(VkPipelineBin
         if (stage_state.stage_flag == VK_SHADER_STAGE_FRAGMENT_BIT && pPipe->graphicsPipelineCI.pRasterizationState &&
             pPipe->graphicsPipelineCI.pRasterizationState->rasterizerDiscardEnable)
             continue;
-        for (const auto &set_binding : stage_state.descriptor_uses) {
+        if (!stage_state.reflection) continue;
+        for (const auto &set_binding : stage_state.reflection->descriptor_uses) {
             cvdescriptorset::DescriptorSet *descriptor_set = (*per_sets)[set_binding.first.first].bound_descriptor_set;
             cvdescriptorset::DescriptorSetLayout::ConstBindingIterator binding_it(descriptor_set->GetLayout().get(),
                                                                                   set_binding.first.second);
@@ -1505,7 +1760,8 @@ void CommandBufferAccessContext::RecordDispatchDrawDescriptorSet(VkPipelineBindP
         if (stage_state.stage_flag == VK_SHADER_STAGE_FRAGMENT_BIT && pPipe->graphicsPipelineCI.pRasterizationState &&
             pPipe->graphicsPipelineCI.pRasterizationState->rasterizerDiscardEnable)
             continue;
-        for (const auto &set_binding : stage_state.descriptor_uses) {
+        if (!stage_state.reflection) continue;
+        for (const auto &set_binding : stage_state.reflection->descriptor_uses) {
             cvdescriptorset::DescriptorSet *descriptor_set = (*per_sets)[set_binding.first.first].bound_descriptor_set;
             cvdescriptorset::DescriptorSetLayout::ConstBindingIterator binding_it(descriptor_set->GetLayout().get(),
                                                                                   set_binding.first.second);
@@ -1716,6 +1972,31 @@ void CommandBufferAccessContext::RecordBeginRenderPass(const ResourceUsageTag &t
     current_renderpass_context_ = &render_pass_contexts_.back();
     current_renderpass_context_->RecordBeginRenderPass(*sync_state_, *cb_state_, &cb_access_context_, queue_flags_, tag);
     current_context_ = &current_renderpass_context_->CurrentContext();
+
+    // The external dependencies order the render pass after earlier submissions too. Those of later subpasses are taken to
+    // apply from the start, as a submission's first accesses are only replayed in order with the barriers.
+    for (const auto &context : current_renderpass_context_->GetContexts()) {
+        const auto *track_back = context.GetTrackBackFromSubpass(VK_SUBPASS_EXTERNAL);
+        if (track_back->context) {
+            const auto &barrier = track_back->barrier;
+            RecordBarrier(tag, SyncGlobalBarrier{barrier.src_exec_scope, barrier.dst_exec_scope, {barrier}});
+        }
+    }
+}
+
+void CommandBufferAccessContext::RecordEndCommandBuffer() {
+    // Merging equal neighbours, split apart by accesses long since superseded, makes for fewer entries to execute or submit
+    cb_access_context_.Coalesce(recorded_barriers_);
+}
+
+void CommandBufferAccessContext::RecordExecuteCommands(const CommandBufferAccessContext &secondary, const ResourceUsageTag &tag) {
+    // The barriers of the secondary apply to the accesses recorded before it, and are replayed at submission for those of
+    // earlier submissions. There, all of them are taken to come ahead of the secondary's first accesses.
+    for (const auto &recorded : secondary.GetRecordedBarriers()) {
+        current_context_->ApplyGlobalBarrier(SyncGlobalBarrier(recorded.barrier));
+        RecordBarrier(tag, recorded.barrier);
+    }
+    current_context_->ApplyExecutedAccesses(*secondary.GetCurrentAccessContext(), tag.index);
 }
 
 void CommandBufferAccessContext::RecordNextSubpass(const RENDER_PASS_STATE &rp_state, const ResourceUsageTag &tag) {
@@ -2102,8 +2383,7 @@ HazardResult ResourceAccessState::DetectHazard(SyncStageAccessIndex usage_index)
                 hazard.Set(WRITE_AFTER_READ, SYNC_FRAGMENT_SHADER_INPUT_ATTACHMENT_READ, input_attachment_tag);
             }
             if (!hazard.hazard) {
-                for (uint32_t read_index = 0; read_index < last_read_count; read_index++) {
-                    const auto &read_access = last_reads[read_index];
+                for (const auto &read_access : last_reads) {
                     if (IsReadHazard(usage_stage, read_access)) {
                         hazard.Set(WRITE_AFTER_READ, read_access.access, read_access.tag);
                         break;
@@ -2132,8 +2412,7 @@ HazardResult ResourceAccessState::DetectHazard(SyncStageAccessIndex usage_index,
             const auto unordered_reads = last_read_stages & ~ordering.exec_scope;
             if (unordered_reads) {
                 // Look for any WAR hazards outside the ordered set of stages
-                for (uint32_t read_index = 0; read_index < last_read_count; read_index++) {
-                    const auto &read_access = last_reads[read_index];
+                for (const auto &read_access : last_reads) {
                     if ((read_access.stage & unordered_reads) && IsReadHazard(usage_stage, read_access)) {
                         hazard.Set(WRITE_AFTER_READ, read_access.access, read_access.tag);
                     }
@@ -2165,7 +2444,7 @@ HazardResult ResourceAccessState::DetectAsyncHazard(SyncStageAccessIndex usage_i
     } else {
         if (last_write != 0) {
             hazard.Set(WRITE_RACING_WRITE, last_write, write_tag);
-        } else if (last_read_count > 0) {
+        } else if (!last_reads.empty()) {
             hazard.Set(WRITE_RACING_READ, last_reads[0].access, last_reads[0].tag);
         } else if (input_attachment_barriers != kNoAttachmentRead) {
             hazard.Set(WRITE_RACING_READ, SYNC_FRAGMENT_SHADER_INPUT_ATTACHMENT_READ, input_attachment_tag);
@@ -2191,8 +2470,7 @@ HazardResult ResourceAccessState::DetectBarrierHazard(SyncStageAccessIndex usage
     }
     if (!hazard.hazard) {
         // Look at the reads if any
-        for (uint32_t read_index = 0; read_index < last_read_count; read_index++) {
-            const auto &read_access = last_reads[read_index];
+        for (const auto &read_access : last_reads) {
             // If the read stage is not in the src sync sync
             // *AND* not execution chained with an existing sync barrier (that's the or)
             // then the barrier access is unsafe (R/W after R)
@@ -2218,7 +2496,10 @@ HazardResult ResourceAccessState::DetectBarrierHazard(SyncStageAccessIndex usage
 void ResourceAccessState::Resolve(const ResourceAccessState &other) {
     if (write_tag.IsBefore(other.write_tag)) {
         // If this is a later write, we've reported any exsiting hazard, and we can just overwrite as the more recent operation
+        // The first accesses are merged below, whichever state holds the later ones
+        auto first = std::move(first_accesses);
         *this = other;
+        first_accesses = std::move(first);
     } else if (!other.write_tag.IsBefore(write_tag)) {
         // This is the *equals* case for write operations, we merged the write barriers and the read state (but without the
         // dependency chaining logic or any stage expansion)
@@ -2238,13 +2519,11 @@ void ResourceAccessState::Resolve(const ResourceAccessState &other) {
         }
         // The else clause is that only this has an attachment read and no merge is needed
 
-        for (uint32_t other_read_index = 0; other_read_index < other.last_read_count; other_read_index++) {
-            auto &other_read = other.last_reads[other_read_index];
+        for (const auto &other_read : other.last_reads) {
             if (last_read_stages & other_read.stage) {
                 // Merge in the barriers for read stages that exist in *both* this and other
                 // TODO: This is N^2 with stages... perhaps the ReadStates should be by stage index.
-                for (uint32_t my_read_index = 0; my_read_index < last_read_count; my_read_index++) {
-                    auto &my_read = last_reads[my_read_index];
+                for (auto &my_read : last_reads) {
                     if (other_read.stage == my_read.stage) {
                         if (my_read.tag.IsBefore(other_read.tag)) {
                             my_read.tag = other_read.tag;
@@ -2256,17 +2535,18 @@ void ResourceAccessState::Resolve(const ResourceAccessState &other) {
                 }
             } else {
                 // The other read stage doesn't exist in this, so add it.
-                last_reads[last_read_count] = other_read;
-                last_read_count++;
+                last_reads.push_back(other_read);
                 last_read_stages |= other_read.stage;
             }
         }
     }  // the else clause would be that other write is before this write... in which case we supercede the other state and ignore
        // it.
+    MergeFirstAccesses(other.first_accesses);
 }
 
 void ResourceAccessState::Update(SyncStageAccessIndex usage_index, const ResourceUsageTag &tag) {
     // Move this logic in the ResourceStateTracker as methods, thereof (or we'll repeat it for every flavor of resource...
+    AddFirstAccess(usage_index, tag);
     const auto usage_bit = FlagBit(usage_index);
     if (usage_bit == SYNC_FRAGMENT_SHADER_INPUT_ATTACHMENT_READ_BIT) {
         // Input attachment requires special treatment for raster/load/store ordering guarantees
@@ -2277,8 +2557,7 @@ void ResourceAccessState::Update(SyncStageAccessIndex usage_index, const Resourc
         // However, for purposes of barrier tracking, only one read per pipeline stage matters
         const auto usage_stage = PipelineStageBit(usage_index);
         if (usage_stage & last_read_stages) {
-            for (uint32_t read_index = 0; read_index < last_read_count; read_index++) {
-                ReadState &access = last_reads[read_index];
+            for (auto &access : last_reads) {
                 if (access.stage == usage_stage) {
                     access.access = usage_bit;
                     access.barriers = 0;
@@ -2288,12 +2567,12 @@ void ResourceAccessState::Update(SyncStageAccessIndex usage_index, const Resourc
             }
         } else {
             // We don't have this stage in the list yet...
-            assert(last_read_count < last_reads.size());
-            ReadState &access = last_reads[last_read_count++];
+            ReadState access;
             access.stage = usage_stage;
             access.access = usage_bit;
             access.barriers = 0;
             access.tag = tag;
+            last_reads.push_back(access);
             last_read_stages |= usage_stage;
         }
     } else {
@@ -2302,7 +2581,7 @@ void ResourceAccessState::Update(SyncStageAccessIndex usage_index, const Resourc
         // Clobber last read and all barriers... because all we have is DANGER, DANGER, WILL ROBINSON!!!
         // if the last_reads/last_write were unsafe, we've reported them,
         // in either case the prior access is irrelevant, we can overwrite them as *this* write is now after them
-        last_read_count = 0;
+        last_reads.clear();
         last_read_stages = 0;
 
         input_attachment_barriers = kNoAttachmentRead;  // Denotes no outstanding input attachment read after the last write.
@@ -2317,8 +2596,7 @@ void ResourceAccessState::Update(SyncStageAccessIndex usage_index, const Resourc
 
 void ResourceAccessState::ApplyExecutionBarrier(VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask) {
     // Execution Barriers only protect read operations
-    for (uint32_t read_index = 0; read_index < last_read_count; read_index++) {
-        ReadState &access = last_reads[read_index];
+    for (auto &access : last_reads) {
         // The | implements the "dependency chain" logic for this access, as the barriers field stores the second sync scope
         if (srcStageMask & (access.stage | access.barriers)) {
             access.barriers |= dstStageMask;
@@ -2340,6 +2618,334 @@ void ResourceAccessState::ApplyMemoryAccessBarrier(VkPipelineStageFlags src_exec
     }
 }
 
+void ResourceAccessState::ApplyGlobalBarrier(const SyncGlobalBarrier &barrier) {
+    ApplyExecutionBarrier(barrier.src_exec_scope, barrier.dst_exec_scope);
+    for (const auto &memory_barrier : barrier.memory_barriers) {
+        ApplyMemoryAccessBarrier(memory_barrier.src_exec_scope, memory_barrier.src_access_scope, memory_barrier.dst_exec_scope,
+                                 memory_barrier.dst_access_scope);
+    }
+}
+
+void ResourceAccessState::ApplyPendingGlobalBarriers(const std::vector<SyncGlobalBarrier> &global_barriers) {
+    for (auto index = global_barrier_epoch; index < global_barriers.size(); ++index) {
+        ApplyGlobalBarrier(global_barriers[index]);
+    }
+    global_barrier_epoch = static_cast<uint32_t>(global_barriers.size());
+}
+
+void ResourceAccessState::AddFirstAccess(SyncStageAccessIndex usage_index, const ResourceUsageTag &tag) {
+    // Whatever follows the first write is validated against that write, rather than against earlier submissions
+    if (!first_accesses.empty() && IsWrite(first_accesses[first_accesses.size() - 1].usage_index)) return;
+    if (IsRead(usage_index)) {
+        // Barriers only ever add to the protection of earlier accesses, so a later read of a usage is no more exposed than the
+        // first one
+        for (const auto &first : first_accesses) {
+            if (first.usage_index == usage_index) return;
+        }
+    }
+    first_accesses.push_back(FirstAccess{usage_index, tag});
+}
+
+void ResourceAccessState::MergeFirstAccesses(const FirstAccesses &other) {
+    if (other.empty() || (first_accesses == other)) return;
+    // Both are in tag order, so merging them in order under the rules that built them gives the first accesses of both
+    auto mine = std::move(first_accesses);
+    auto mine_pos = mine.begin();
+    auto other_pos = other.begin();
+    while ((mine_pos != mine.end()) || (other_pos != other.end())) {
+        const bool take_mine = (other_pos == other.end()) || ((mine_pos != mine.end()) && !other_pos->tag.IsBefore(mine_pos->tag));
+        const auto &next = take_mine ? *mine_pos++ : *other_pos++;
+        AddFirstAccess(next.usage_index, next.tag);
+    }
+}
+
+bool ResourceAccessState::HasEquivalentFirstAccesses(const ResourceAccessState &other,
+                                                     const std::vector<SyncRecordedBarrier> &barriers) const {
+    if (first_accesses.size() != other.first_accesses.size()) return false;
+    // The barriers replayed ahead of a first access are those recorded before or with its command, a prefix of barriers
+    const auto barriers_before = [&barriers](const ResourceUsageTag &tag) {
+        return std::upper_bound(barriers.cbegin(), barriers.cend(), tag,
+                                [](const ResourceUsageTag &lhs, const SyncRecordedBarrier &rhs) { return lhs.IsBefore(rhs.tag); });
+    };
+    for (uint32_t i = 0; i < first_accesses.size(); ++i) {
+        const auto &mine = first_accesses[i];
+        const auto &theirs = other.first_accesses[i];
+        if (mine.usage_index != theirs.usage_index) return false;
+        if (mine.tag == theirs.tag) continue;
+        // Layout transitions are validated against the barriers of their own command
+        if (mine.usage_index == SYNC_IMAGE_LAYOUT_TRANSITION) return false;
+        if (barriers_before(mine.tag) != barriers_before(theirs.tag)) return false;
+    }
+    return true;
+}
+
+// Bring this state, left by earlier submissions and with the barriers of the submitted command buffer already applied, up to date
+// with the final state of that command buffer.
+void ResourceAccessState::ApplySubmittedAccesses(const ResourceAccessState &submitted, uint64_t submit_index) {
+    const auto epoch = global_barrier_epoch;
+    if (submitted.last_write) {
+        // As with Update, the last write supersedes every access before it
+        *this = submitted;
+        write_tag.index = submit_index;
+        for (auto &read : last_reads) {
+            read.tag.index = submit_index;
+        }
+        input_attachment_tag.index = submit_index;
+    } else {
+        if (submitted.input_attachment_barriers != kNoAttachmentRead) {
+            input_attachment_barriers = submitted.input_attachment_barriers;
+            input_attachment_tag = ResourceUsageTag(submit_index, submitted.input_attachment_tag.command);
+        }
+        for (auto read : submitted.last_reads) {
+            read.tag.index = submit_index;
+            if (last_read_stages & read.stage) {
+                for (auto &my_read : last_reads) {
+                    if (my_read.stage == read.stage) {
+                        my_read = read;
+                        break;
+                    }
+                }
+            } else {
+                last_reads.push_back(read);
+                last_read_stages |= read.stage;
+            }
+        }
+    }
+    // The first accesses are those of the command buffer, not of the queue
+    first_accesses.clear();
+    global_barrier_epoch = epoch;
+}
+
+void ResourceAccessState::ApplyExecutedAccesses(const ResourceAccessState &executed, uint64_t execute_index) {
+    // Unlike those of a queue, the first accesses of a command buffer include those of the command buffers it executes
+    auto first = std::move(first_accesses);
+    ApplySubmittedAccesses(executed, execute_index);
+    first_accesses = std::move(first);
+    for (const auto &executed_first : executed.first_accesses) {
+        AddFirstAccess(executed_first.usage_index, ResourceUsageTag(execute_index, executed_first.tag.command));
+    }
+}
+
+// Drop the accesses of submissions the queue has completed, which nothing later can be a hazard to
+void ResourceAccessState::RetireAccesses(uint64_t retired_submit_index) {
+    if (last_write && (write_tag.index <= retired_submit_index)) {
+        write_barriers = ~SyncStageAccessFlags(0);
+        write_dependency_chain = 0;
+        write_tag = ResourceUsageTag();
+        last_write = 0;
+    }
+    if ((input_attachment_barriers != kNoAttachmentRead) && (input_attachment_tag.index <= retired_submit_index)) {
+        input_attachment_barriers = kNoAttachmentRead;
+    }
+    bool has_retired_reads = false;
+    for (const auto &read : last_reads) {
+        has_retired_reads |= read.tag.index <= retired_submit_index;
+    }
+    if (!has_retired_reads) return;
+    small_vector<ReadState, kInlineReadCount> pending_reads;
+    for (const auto &read : last_reads) {
+        if (read.tag.index > retired_submit_index) {
+            pending_reads.push_back(read);
+        } else {
+            last_read_stages &= ~read.stage;
+        }
+    }
+    last_reads = std::move(pending_reads);
+}
+
+// Replays the first accesses of a command buffer, with the barriers it records before each, against the access state left by
+// earlier submissions or commands. Leading barriers, those of command buffers executed ahead of this one, apply to all of them.
+class FirstUseHazardDetector {
+  public:
+    FirstUseHazardDetector(const ResourceAccessState &first_use, const std::vector<SyncRecordedBarrier> &barriers,
+                           ResourceUsageTag *first_use_tag, const std::vector<SyncGlobalBarrier> *leading_barriers = nullptr)
+        : first_use_(first_use), barriers_(barriers), first_use_tag_(first_use_tag), leading_barriers_(leading_barriers) {}
+
+    HazardResult Detect(const ResourceAccessState &access) const {
+        const ResourceAccessState *current = &access;
+        ResourceAccessState scratch;
+        if (leading_barriers_ && !leading_barriers_->empty()) {
+            scratch = access;
+            current = &scratch;
+            for (const auto &leading_barrier : *leading_barriers_) {
+                scratch.ApplyGlobalBarrier(leading_barrier);
+            }
+        }
+        auto barrier = barriers_.cbegin();
+        const auto apply_barrier = [&]() {
+            if (current != &scratch) {
+                scratch = access;
+                current = &scratch;
+            }
+            scratch.ApplyGlobalBarrier(barrier->barrier);
+            ++barrier;
+        };
+        for (const auto &first : first_use_.GetFirstAccesses()) {
+            while ((barrier != barriers_.cend()) && barrier->tag.IsBefore(first.tag)) {
+                apply_barrier();
+            }
+            HazardResult hazard;
+            if (first.usage_index == SYNC_IMAGE_LAYOUT_TRANSITION) {
+                // Transitions are validated against the source scopes of the barriers making them. Only pipeline barriers and
+                // the external dependencies of render passes are recorded, so other transitions aren't validated here.
+                VkPipelineStageFlags src_exec_scope = 0;
+                SyncStageAccessFlags src_access_scope = 0;
+                for (auto transition = barrier; (transition != barriers_.cend()) && (transition->tag == first.tag); ++transition) {
+                    src_exec_scope |= transition->barrier.src_exec_scope;
+                    for (const auto &memory_barrier : transition->barrier.memory_barriers) {
+                        src_access_scope |= memory_barrier.src_access_scope;
+                    }
+                }
+                if (src_exec_scope) {
+                    hazard = current->DetectBarrierHazard(first.usage_index, src_exec_scope, src_access_scope);
+                }
+            } else {
+                // The barriers of the accessing command itself, such as a render pass's external dependencies, come first
+                while ((barrier != barriers_.cend()) && (barrier->tag == first.tag)) {
+                    apply_barrier();
+                }
+                hazard = current->DetectHazard(first.usage_index);
+            }
+            if (hazard.hazard) {
+                *first_use_tag_ = first.tag;
+                return hazard;
+            }
+        }
+        return HazardResult();
+    }
+    // No barrier orders the accesses of asynchronous subpasses, so the first accesses are all there is to check
+    HazardResult DetectAsync(const ResourceAccessState &access) const {
+        for (const auto &first : first_use_.GetFirstAccesses()) {
+            const auto hazard = access.DetectAsyncHazard(first.usage_index);
+            if (hazard.hazard) {
+                *first_use_tag_ = first.tag;
+                return hazard;
+            }
+        }
+        return HazardResult();
+    }
+
+  private:
+    const ResourceAccessState &first_use_;
+    const std::vector<SyncRecordedBarrier> &barriers_;
+    ResourceUsageTag *first_use_tag_;
+    const std::vector<SyncGlobalBarrier> *leading_barriers_;
+};
+
+// The first hazard the first accesses of a recorded command buffer have with the accesses of context, if any
+static HazardResult DetectFirstUseHazard(const AccessContext &context, const CommandBufferAccessContext &cb_context,
+                                         const std::vector<SyncGlobalBarrier> *leading_barriers,
+                                         AccessContext::DetectOptions options, ResourceUsageTag *first_use_tag) {
+    HazardResult hazard;
+    for (const auto address_type : AccessContext::kAddressTypes) {
+        for (const auto &entry : cb_context.GetCurrentAccessContext()->GetAccessStateMap(address_type)) {
+            if (entry.second.GetFirstAccesses().empty()) continue;
+            FirstUseHazardDetector detector(entry.second, cb_context.GetRecordedBarriers(), first_use_tag, leading_barriers);
+            hazard = context.DetectHazard(address_type, detector, entry.first, options);
+            if (hazard.hazard) return hazard;
+        }
+    }
+    return hazard;
+}
+
+struct ApplySubmittedAccessesFunctor {
+    using Iterator = ResourceAccessRangeMap::iterator;
+    Iterator Infill(ResourceAccessRangeMap *accesses, Iterator pos, ResourceAccessRange range) const {
+        // Nothing earlier was submitted to the gaps, which start out empty
+        return accesses->insert(pos, std::make_pair(range, ResourceAccessState()));
+    }
+
+    Iterator operator()(ResourceAccessRangeMap *accesses, Iterator pos) const {
+        pos->second.ApplySubmittedAccesses(submitted, submit_index);
+        return pos;
+    }
+
+    ApplySubmittedAccessesFunctor(const ResourceAccessState &submitted_, uint64_t submit_index_)
+        : submitted(submitted_), submit_index(submit_index_) {}
+    const ResourceAccessState &submitted;
+    const uint64_t submit_index;
+};
+
+struct CopyAccessStateFunctor {
+    using Iterator = ResourceAccessRangeMap::iterator;
+    Iterator Infill(ResourceAccessRangeMap *accesses, Iterator pos, ResourceAccessRange range) const {
+        return accesses->insert(pos, std::make_pair(range, access));
+    }
+
+    Iterator operator()(ResourceAccessRangeMap *accesses, Iterator pos) const {
+        pos->second = access;
+        return pos;
+    }
+
+    CopyAccessStateFunctor(const ResourceAccessState &access_) : access(access_) {}
+    const ResourceAccessState &access;
+};
+
+void QueueSubmitAccessContext::ApplyGlobalBarrier(const SyncGlobalBarrier &barrier) {
+    barriers_.emplace_back(barrier);
+    accesses_.ApplyGlobalBarrier(SyncGlobalBarrier(barrier));
+}
+
+// Copy in what the queue holds for the ranges the command buffer touches, as of the barriers applied so far
+void QueueSubmitAccessContext::ImportQueueAccesses(const AccessContext &cb_access_context) {
+    const auto seed_action = [this](ResourceAccessState *access) {
+        access->RetireAccesses(retired_submit_index_);
+        for (const auto &barrier : barriers_) {
+            access->ApplyGlobalBarrier(barrier);
+        }
+    };
+    for (const auto address_type : AccessContext::kAddressTypes) {
+        // Import runs of adjacent entries at once
+        ResourceAccessRange run;
+        for (const auto &entry : cb_access_context.GetAccessStateMap(address_type)) {
+            if (run.non_empty() && (run.end == entry.first.begin)) {
+                run.end = entry.first.end;
+                continue;
+            }
+            if (run.non_empty()) accesses_.ImportAccessRange(queue_context_, address_type, run, seed_action);
+            run = entry.first;
+        }
+        if (run.non_empty()) accesses_.ImportAccessRange(queue_context_, address_type, run, seed_action);
+    }
+}
+
+HazardResult QueueSubmitAccessContext::DetectFirstUseHazard(const CommandBufferAccessContext &cb_context,
+                                                            ResourceUsageTag *first_use_tag) {
+    ImportQueueAccesses(*cb_context.GetCurrentAccessContext());
+    // Everything submitted earlier is in the copied in accesses, so there is nothing previous to look to
+    return ::DetectFirstUseHazard(accesses_, cb_context, nullptr, static_cast<AccessContext::DetectOptions>(0), first_use_tag);
+}
+
+void QueueSubmitAccessContext::RecordCommandBuffer(const CommandBufferAccessContext &cb_context, uint64_t submit_index) {
+    const auto *cb_access_context = cb_context.GetCurrentAccessContext();
+    ImportQueueAccesses(*cb_access_context);
+    // The barriers of the command buffer apply to everything submitted before it, while its own accesses already have them
+    for (const auto &recorded : cb_context.GetRecordedBarriers()) {
+        ApplyGlobalBarrier(recorded.barrier);
+    }
+    for (const auto address_type : AccessContext::kAddressTypes) {
+        for (const auto &entry : cb_access_context->GetAccessStateMap(address_type)) {
+            ApplySubmittedAccessesFunctor action(entry.second, submit_index);
+            accesses_.UpdateMemoryAccessState(address_type, entry.first, action);
+        }
+    }
+}
+
+void QueueSubmitAccessContext::Commit(AccessContext *queue_context) {
+    // Apply the barriers to what the submission didn't touch, then replace what it did
+    for (auto &barrier : barriers_) {
+        queue_context->ApplyGlobalBarrier(std::move(barrier));
+    }
+    barriers_.clear();
+    accesses_.ApplyPendingGlobalBarriers();
+    for (const auto address_type : AccessContext::kAddressTypes) {
+        for (const auto &entry : accesses_.GetAccessStateMap(address_type)) {
+            CopyAccessStateFunctor action(entry.second);
+            queue_context->UpdateMemoryAccessState(address_type, entry.first, action);
+        }
+    }
+}
+
 void SyncValidator::ResetCommandBufferCallback(VkCommandBuffer command_buffer) {
     auto *access_context = GetAccessContextNoInsert(command_buffer);
     if (access_context) {
@@ -2359,10 +2965,21 @@ void SyncValidator::ApplyGlobalBarriers(AccessContext *context, VkPipelineStageF
                                         VkPipelineStageFlags dstStageMask, SyncStageAccessFlags src_access_scope,
                                         SyncStageAccessFlags dst_access_scope, uint32_t memoryBarrierCount,
                                         const VkMemoryBarrier *pMemoryBarriers) {
-    // TODO: Implement this better (maybe some delayed/on-demand integration).
-    ApplyGlobalBarrierFunctor barriers_functor(srcStageMask, dstStageMask, src_access_scope, dst_access_scope, memoryBarrierCount,
-                                               pMemoryBarriers);
-    context->ApplyGlobalBarriers(barriers_functor);
+    SyncGlobalBarrier barrier;
+    barrier.src_exec_scope = srcStageMask;
+    barrier.dst_exec_scope = dstStageMask;
+    barrier.memory_barriers.reserve(memoryBarrierCount);
+    for (uint32_t barrier_index = 0; barrier_index < memoryBarrierCount; barrier_index++) {
+        const auto &memory_barrier = pMemoryBarriers[barrier_index];
+        SyncBarrier sync_barrier;
+        sync_barrier.src_exec_scope = srcStageMask;
+        sync_barrier.src_access_scope = SyncStageAccess::AccessScope(src_access_scope, memory_barrier.srcAccessMask);
+        sync_barrier.dst_exec_scope = dstStageMask;
+        sync_barrier.dst_access_scope = SyncStageAccess::AccessScope(dst_access_scope, memory_barrier.dstAccessMask);
+        barrier.memory_barriers.emplace_back(sync_barrier);
+    }
+    // Applied lazily, as each tracked access is next used
+    context->ApplyGlobalBarrier(std::move(barrier));
 }
 
 void SyncValidator::ApplyBufferBarriers(AccessContext *context, VkPipelineStageFlags src_exec_scope,
@@ -2576,6 +3193,20 @@ bool SyncValidator::PreCallValidateCmdPipelineBarrier(VkCommandBuffer commandBuf
     return skip;
 }
 
+template <typename Barrier>
+static void AppendMemoryBarriers(VkPipelineStageFlags src_exec_scope, SyncStageAccessFlags src_stage_accesses,
+                                 VkPipelineStageFlags dst_exec_scope, SyncStageAccessFlags dst_stage_accesses,
+                                 uint32_t barrier_count, const Barrier *barriers, std::vector<SyncBarrier> *memory_barriers) {
+    for (uint32_t index = 0; index < barrier_count; index++) {
+        SyncBarrier sync_barrier;
+        sync_barrier.src_exec_scope = src_exec_scope;
+        sync_barrier.src_access_scope = SyncStageAccess::AccessScope(src_stage_accesses, barriers[index].srcAccessMask);
+        sync_barrier.dst_exec_scope = dst_exec_scope;
+        sync_barrier.dst_access_scope = SyncStageAccess::AccessScope(dst_stage_accesses, barriers[index].dstAccessMask);
+        memory_barriers->emplace_back(sync_barrier);
+    }
+}
+
 void SyncValidator::PreCallRecordCmdPipelineBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStageMask,
                                                     VkPipelineStageFlags dstStageMask, VkDependencyFlags dependencyFlags,
                                                     uint32_t memoryBarrierCount, const VkMemoryBarrier *pMemoryBarriers,
@@ -2605,6 +3236,17 @@ void SyncValidator::PreCallRecordCmdPipelineBarrier(VkCommandBuffer commandBuffe
     // Apply these last in-case there operation is a superset of the other two and would clean them up...
     ApplyGlobalBarriers(access_context, src_exec_scope, dst_exec_scope, src_stage_accesses, dst_stage_accesses, memoryBarrierCount,
                         pMemoryBarriers);
+
+    // Queue submission replays the barrier against the accesses of earlier submissions, whose resources it doesn't know, so the
+    // buffer and image barriers are kept as memory barriers too
+    SyncGlobalBarrier recorded_barrier{src_exec_scope, dst_exec_scope, {}};
+    AppendMemoryBarriers(src_exec_scope, src_stage_accesses, dst_exec_scope, dst_stage_accesses, memoryBarrierCount,
+                         pMemoryBarriers, &recorded_barrier.memory_barriers);
+    AppendMemoryBarriers(src_exec_scope, src_stage_accesses, dst_exec_scope, dst_stage_accesses, bufferMemoryBarrierCount,
+                         pBufferMemoryBarriers, &recorded_barrier.memory_barriers);
+    AppendMemoryBarriers(src_exec_scope, src_stage_accesses, dst_exec_scope, dst_stage_accesses, imageMemoryBarrierCount,
+                         pImageMemoryBarriers, &recorded_barrier.memory_barriers);
+    cb_access_context->RecordBarrier(tag, recorded_barrier);
 }
 
 void SyncValidator::PostCallRecordCreateDevice(VkPhysicalDevice gpu, const VkDeviceCreateInfo *pCreateInfo,
@@ -2675,6 +3317,173 @@ void SyncValidator::PostCallRecordBeginCommandBuffer(VkCommandBuffer commandBuff
     cb_access_context->Reset();
 }
 
+void SyncValidator::PostCallRecordEndCommandBuffer(VkCommandBuffer commandBuffer, VkResult result) {
+    StateTracker::PostCallRecordEndCommandBuffer(commandBuffer, result);
+    auto *cb_access_context = GetAccessContextNoInsert(commandBuffer);
+    if (!cb_access_context) return;
+    cb_access_context->RecordEndCommandBuffer();
+}
+
+bool SyncValidator::PreCallValidateCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBufferCount,
+                                                      const VkCommandBuffer *pCommandBuffers) const {
+    bool skip = false;
+    const auto *cb_access_context = GetAccessContext(commandBuffer);
+    assert(cb_access_context);
+    if (!cb_access_context) return skip;
+    const auto *context = cb_access_context->GetCurrentAccessContext();
+    assert(context);
+    if (!context) return skip;
+
+    // Each command buffer follows those ahead of it in pCommandBuffers. Rather than a copy of the primary's context, only the
+    // accesses of those ahead are gathered, each tagged with its index, and their barriers replayed against the primary's.
+    AccessContext executed_context;
+    std::vector<SyncGlobalBarrier> executed_barriers;
+    for (uint32_t cb_index = 0; cb_index < commandBufferCount; ++cb_index) {
+        const auto *secondary = GetAccessContext(pCommandBuffers[cb_index]);
+        if (!secondary) continue;
+        ResourceUsageTag first_use_tag;
+        auto hazard = DetectFirstUseHazard(*context, *secondary, &executed_barriers, AccessContext::DetectOptions::kDetectAll,
+                                           &first_use_tag);
+        std::string prior_access;
+        if (hazard.hazard) {
+            prior_access = string_UsageTag(hazard);
+        } else {
+            hazard = DetectFirstUseHazard(executed_context, *secondary, nullptr, static_cast<AccessContext::DetectOptions>(0),
+                                          &first_use_tag);
+            if (hazard.hazard) prior_access = string_ExecutedUsageTag(hazard);
+        }
+        if (hazard.hazard) {
+            skip |= LogError(pCommandBuffers[cb_index], string_SyncHazardVUID(hazard.hazard),
+                             "vkCmdExecuteCommands: Hazard %s for pCommandBuffers[%" PRIu32 "] %s, at command %s (seq #%" PRIu64
+                             "). Prior access %s.",
+                             string_SyncHazard(hazard.hazard), cb_index,
+                             report_data->FormatHandle(pCommandBuffers[cb_index]).c_str(), CommandTypeString(first_use_tag.command),
+                             first_use_tag.index & 0xFFFFFFFF, prior_access.c_str());
+        }
+
+        for (const auto &recorded : secondary->GetRecordedBarriers()) {
+            executed_barriers.emplace_back(recorded.barrier);
+            executed_context.ApplyGlobalBarrier(SyncGlobalBarrier(recorded.barrier));
+        }
+        executed_context.ApplyExecutedAccesses(*secondary->GetCurrentAccessContext(), cb_index);
+    }
+    return skip;
+}
+
+void SyncValidator::PreCallRecordCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBufferCount,
+                                                    const VkCommandBuffer *pCommandBuffers) {
+    StateTracker::PreCallRecordCmdExecuteCommands(commandBuffer, commandBufferCount, pCommandBuffers);
+    auto *cb_access_context = GetAccessContext(commandBuffer);
+    assert(cb_access_context);
+    if (!cb_access_context) return;
+    const auto tag = cb_access_context->NextCommandTag(CMD_EXECUTECOMMANDS);
+    for (uint32_t cb_index = 0; cb_index < commandBufferCount; ++cb_index) {
+        const auto *secondary = GetAccessContextNoInsert(pCommandBuffers[cb_index]);
+        if (secondary) cb_access_context->RecordExecuteCommands(*secondary, tag);
+    }
+}
+
+// A semaphore wait orders everything submitted before it ahead of the wait's destination stages. As the accesses of other queues
+// aren't tracked, the wait is taken to cover all earlier submissions to the waiting queue, whichever queue signaled it.
+static SyncGlobalBarrier SemaphoreWaitBarrier(VkQueueFlags queue_flags, VkPipelineStageFlags wait_dst_stage_mask) {
+    SyncBarrier barrier;
+    barrier.src_exec_scope = WithEarlierPipelineStages(ExpandPipelineStages(queue_flags, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT));
+    barrier.src_access_scope = SyncStageAccess::AccessScopeByStage(barrier.src_exec_scope);
+    const auto dst_stage_mask = ExpandPipelineStages(queue_flags, wait_dst_stage_mask);
+    barrier.dst_exec_scope = WithLaterPipelineStages(dst_stage_mask);
+    barrier.dst_access_scope = SyncStageAccess::AccessScopeByStage(dst_stage_mask);
+    return SyncGlobalBarrier{barrier.src_exec_scope, barrier.dst_exec_scope, {barrier}};
+}
+
+bool SyncValidator::PreCallValidateQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits,
+                                               VkFence fence) const {
+    bool skip = false;
+    const auto *queue_state = GetQueueState(queue);
+    if (!queue_state) return skip;
+    const auto queue_flags = GetPhysicalDeviceState()->queue_family_properties[queue_state->queueFamilyIndex].queueFlags;
+
+    // Outlives the submit context, which is kept for the record step
+    static const AccessContext empty_context;
+    const auto found_it = queue_access_state.find(queue);
+    std::unique_ptr<QueueSubmitAccessContext> submit_context(new QueueSubmitAccessContext(
+        found_it != queue_access_state.end() ? *found_it->second : empty_context, queue_state->seq));
+    // Numbered as the state tracker will record the submissions
+    const uint64_t base_submit_index = queue_state->seq + queue_state->submissions.size();
+    uint64_t submit_index = base_submit_index;
+    for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
+        const auto &submit = pSubmits[submit_idx];
+        submit_index++;
+        for (uint32_t wait_idx = 0; wait_idx < submit.waitSemaphoreCount; wait_idx++) {
+            submit_context->ApplyGlobalBarrier(SemaphoreWaitBarrier(queue_flags, submit.pWaitDstStageMask[wait_idx]));
+        }
+        for (uint32_t cb_idx = 0; cb_idx < submit.commandBufferCount; cb_idx++) {
+            const auto *cb_context = GetAccessContext(submit.pCommandBuffers[cb_idx]);
+            if (!cb_context) continue;
+            ResourceUsageTag first_use_tag;
+            const auto hazard = submit_context->DetectFirstUseHazard(*cb_context, &first_use_tag);
+            if (hazard.hazard) {
+                skip |= LogError(submit.pCommandBuffers[cb_idx], string_SyncHazardVUID(hazard.hazard),
+                                 "vkQueueSubmit: Hazard %s for pSubmits[%" PRIu32 "].pCommandBuffers[%" PRIu32
+                                 "] %s, at command %s (seq #%" PRIu64 "). Prior access %s.",
+                                 string_SyncHazard(hazard.hazard), submit_idx, cb_idx,
+                                 report_data->FormatHandle(submit.pCommandBuffers[cb_idx]).c_str(),
+                                 CommandTypeString(first_use_tag.command), first_use_tag.index & 0xFFFFFFFF,
+                                 string_SubmitUsageTag(hazard).c_str());
+            }
+            // Later command buffers are validated against this one as recorded, hazard or not
+            submit_context->RecordCommandBuffer(*cb_context, submit_index);
+        }
+    }
+    if (!skip) {
+        std::lock_guard<std::mutex> lock(validated_submit_lock);
+        validated_submits[queue] = ValidatedQueueSubmit{base_submit_index, pSubmits, submitCount, std::move(submit_context)};
+    }
+    return skip;
+}
+
+void SyncValidator::PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence,
+                                              VkResult result) {
+    const auto *queue_state = GetQueueState(queue);
+    // Read before the state tracker records the submissions
+    const uint64_t retired_submit_index = queue_state ? queue_state->seq : 0;
+    uint64_t submit_index = queue_state ? queue_state->seq + queue_state->submissions.size() : 0;
+    std::unique_ptr<QueueSubmitAccessContext> submit_context;
+    {
+        std::lock_guard<std::mutex> lock(validated_submit_lock);
+        auto validated = validated_submits.find(queue);
+        if (validated != validated_submits.end()) {
+            // Only the validation of this very call, with nothing submitted to the queue since, left the state to commit
+            const auto &validated_submit = validated->second;
+            if ((validated_submit.base_submit_index == submit_index) && (validated_submit.submits == pSubmits) &&
+                (validated_submit.submit_count == submitCount)) {
+                submit_context = std::move(validated->second.submit_context);
+            }
+            validated_submits.erase(validated);
+        }
+    }
+    StateTracker::PostCallRecordQueueSubmit(queue, submitCount, pSubmits, fence, result);
+    if ((result != VK_SUCCESS) || !queue_state) return;
+    const auto queue_flags = GetPhysicalDeviceState()->queue_family_properties[queue_state->queueFamilyIndex].queueFlags;
+
+    auto &queue_context = queue_access_state[queue];
+    if (!queue_context) queue_context.reset(new AccessContext());
+    if (!submit_context) {
+        submit_context.reset(new QueueSubmitAccessContext(*queue_context, retired_submit_index));
+        for (uint32_t submit_idx = 0; submit_idx < submitCount; submit_idx++) {
+            const auto &submit = pSubmits[submit_idx];
+            submit_index++;
+            for (uint32_t wait_idx = 0; wait_idx < submit.waitSemaphoreCount; wait_idx++) {
+                submit_context->ApplyGlobalBarrier(SemaphoreWaitBarrier(queue_flags, submit.pWaitDstStageMask[wait_idx]));
+            }
+            for (uint32_t cb_idx = 0; cb_idx < submit.commandBufferCount; cb_idx++) {
+                const auto *cb_context = GetAccessContextNoInsert(submit.pCommandBuffers[cb_idx]);
+                if (cb_context) submit_context->RecordCommandBuffer(*cb_context, submit_index);
+            }
+        }
+    }
+    submit_context->Commit(queue_context.get());
+}
+
 void SyncValidator::RecordCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo *pRenderPassBegin,
                                              const VkSubpassBeginInfo *pSubpassBeginInfo, CMD_TYPE command) {
     auto cb_context = GetAccessContext(commandBuffer);
@@ -22,11 +22,13 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vulkan/vulkan.h>
 
 #include "synchronization_validation_types.h"
 #include "state_tracker.h"
+#include "vk_layer_data.h"
 
 class SyncValidator;
 
@@ -110,6 +112,19 @@ struct SyncOrderingBarrier {
     SyncOrderingBarrier &operator=(const SyncOrderingBarrier &) = default;
 };
 
+// A pipeline barrier's execution dependency and memory barriers, as applied to every access in an AccessContext
+struct SyncGlobalBarrier {
+    VkPipelineStageFlags src_exec_scope;
+    VkPipelineStageFlags dst_exec_scope;
+    std::vector<SyncBarrier> memory_barriers;  // One per VkMemoryBarrier, with the execution scopes above
+};
+
+// A barrier as recorded in a command buffer, kept to be replayed against the accesses of earlier queue submissions
+struct SyncRecordedBarrier {
+    ResourceUsageTag tag;
+    SyncGlobalBarrier barrier;
+};
+
 class ResourceAccessState : public SyncStageAccess {
   protected:
     // Mutliple read operations can be simlutaneously (and independently) synchronized,
@@ -129,6 +144,15 @@ class ResourceAccessState : public SyncStageAccess {
     };
 
   public:
+    struct FirstAccess {
+        SyncStageAccessIndex usage_index;
+        ResourceUsageTag tag;
+        bool operator==(const FirstAccess &rhs) const { return (usage_index == rhs.usage_index) && (tag == rhs.tag); }
+        bool operator!=(const FirstAccess &rhs) const { return !(*this == rhs); }
+    };
+    static constexpr uint32_t kInlineFirstAccessCount = 1;
+    using FirstAccesses = small_vector<FirstAccess, kInlineFirstAccessCount>;
+
     HazardResult DetectHazard(SyncStageAccessIndex usage_index) const;
     HazardResult DetectHazard(SyncStageAccessIndex usage_index, const SyncOrderingBarrier &ordering) const;
 
@@ -142,6 +166,27 @@ class ResourceAccessState : public SyncStageAccess {
     void ApplyExecutionBarrier(VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask);
     void ApplyMemoryAccessBarrier(VkPipelineStageFlags src_stage_mask, SyncStageAccessFlags src_scope,
                                   VkPipelineStageFlags dst_stage_mask, SyncStageAccessFlags dst_scope);
+    void ApplyGlobalBarrier(const SyncGlobalBarrier &barrier);
+
+    // Global barriers are logged by the AccessContext holding this state and applied when the state is next used. The epoch is
+    // the number of entries of that log which have already been applied.
+    bool HasPendingGlobalBarriers(const std::vector<SyncGlobalBarrier> &global_barriers) const {
+        return global_barrier_epoch < global_barriers.size();
+    }
+    void ApplyPendingGlobalBarriers(const std::vector<SyncGlobalBarrier> &global_barriers);
+    void SetGlobalBarrierEpoch(uint32_t epoch) { global_barrier_epoch = epoch; }
+
+    // The accesses up to and including the first write, in order and with only the first read of each usage. These are the
+    // accesses of a command buffer that the accesses of earlier queue submissions can be a hazard to.
+    const FirstAccesses &GetFirstAccesses() const { return first_accesses; }
+    // Whether the first accesses of other are the same as these as far as validation against earlier submissions can tell, given
+    // the barriers recorded ahead of them. Neighbouring entries with such first accesses can merge, keeping either.
+    bool HasEquivalentFirstAccesses(const ResourceAccessState &other, const std::vector<SyncRecordedBarrier> &barriers) const;
+    // For the access states of a queue, whose tags are submission indices rather than command buffer ones
+    void ApplySubmittedAccesses(const ResourceAccessState &submitted, uint64_t submit_index);
+    // For those of a command buffer executing a secondary, whose accesses all take the tag index of vkCmdExecuteCommands
+    void ApplyExecutedAccesses(const ResourceAccessState &executed, uint64_t execute_index);
+    void RetireAccesses(uint64_t retired_submit_index);
 
     ResourceAccessState()
         : write_barriers(~SyncStageAccessFlags(0)),
@@ -150,18 +195,18 @@ class ResourceAccessState : public SyncStageAccess {
           last_write(0),
           input_attachment_barriers(kNoAttachmentRead),
           input_attachment_tag(),
-          last_read_count(0),
-          last_read_stages(0) {}
+          last_read_stages(0),
+          global_barrier_epoch(0) {}
 
     bool HasWriteOp() const { return last_write != 0; }
+    // The first accesses aren't compared, as neighbours that differ only in the tags of long superseded accesses would never
+    // merge. Whatever merges entries must reconcile them itself.
     bool operator==(const ResourceAccessState &rhs) const {
         bool same = (write_barriers == rhs.write_barriers) && (write_dependency_chain == rhs.write_dependency_chain) &&
-                    (last_read_count == rhs.last_read_count) && (last_read_stages == rhs.last_read_stages) &&
-                    (write_tag == rhs.write_tag) && (input_attachment_barriers == rhs.input_attachment_barriers) &&
-                    ((input_attachment_barriers == kNoAttachmentRead) || input_attachment_tag == rhs.input_attachment_tag);
-        for (uint32_t i = 0; same && i < last_read_count; i++) {
-            same |= last_reads[i] == rhs.last_reads[i];
-        }
+                    (last_read_stages == rhs.last_read_stages) && (write_tag == rhs.write_tag) &&
+                    (input_attachment_barriers == rhs.input_attachment_barriers) &&
+                    ((input_attachment_barriers == kNoAttachmentRead) || input_attachment_tag == rhs.input_attachment_tag) &&
+                    (last_reads == rhs.last_reads);
         return same;
     }
     bool operator!=(const ResourceAccessState &rhs) const { return !(*this == rhs); }
@@ -169,6 +214,8 @@ class ResourceAccessState : public SyncStageAccess {
   private:
     static constexpr VkPipelineStageFlags kNoAttachmentRead = ~VkPipelineStageFlags(0);
     bool IsWriteHazard(SyncStageAccessFlagBits usage) const { return 0 != (usage & ~write_barriers); }
+    void AddFirstAccess(SyncStageAccessIndex usage_index, const ResourceUsageTag &tag);
+    void MergeFirstAccesses(const FirstAccesses &other);
 
     static bool IsReadHazard(VkPipelineStageFlagBits stage, const VkPipelineStageFlags barriers) {
         return 0 != (stage & ~barriers);
@@ -201,10 +248,16 @@ class ResourceAccessState : public SyncStageAccess {
     VkPipelineStageFlags input_attachment_barriers;
     ResourceUsageTag input_attachment_tag;
 
-    uint32_t last_read_count;
     VkPipelineStageFlags last_read_stages;
-    static constexpr size_t kStageCount = 32;  // TODO: The manual count was 28 real stages. Add stage count to codegen
-    std::array<ReadState, kStageCount> last_reads;
+    // At most one read per stage, though rarely more than a couple are outstanding. Room for every stage would make each
+    // entry of a ResourceAccessRangeMap over a kilobyte, all of which is copied whenever an entry is split.
+    static constexpr uint32_t kInlineReadCount = 2;
+    small_vector<ReadState, kInlineReadCount> last_reads;
+
+    FirstAccesses first_accesses;
+
+    // Bookkeeping for the owning context's global barrier log, not part of the access state proper (and thus not compared)
+    uint32_t global_barrier_epoch;
 };
 
 using ResourceAccessRangeMap = sparse_container::range_map<VkDeviceSize, ResourceAccessState>;
@@ -214,6 +267,8 @@ using ResourceRangeMergeIterator = sparse_container::parallel_iterator<ResourceA
 class AccessContext {
   public:
     enum AddressType : int { kLinearAddress = 0, kIdealizedAddress = 1, kMaxAddressType = 1 };
+    constexpr static int kAddressTypeCount = AddressType::kMaxAddressType + 1;
+    static const std::array<AddressType, kAddressTypeCount> kAddressTypes;
     enum DetectOptions : uint32_t {
         kDetectPrevious = 1U << 0,
         kDetectAsync = 1U << 1,
@@ -260,6 +315,8 @@ class AccessContext {
         for (auto &map : access_state_maps_) {
             map.clear();
         }
+        global_barriers_.clear();
+        base_ = nullptr;
     }
     // TODO: See if returning the lower_bound would be useful from a performance POV -- look at the lower_bound overhead
     // Would need to add a "hint" overload to parallel_iterator::invalidate_[AB] call, if so.
@@ -300,13 +357,33 @@ class AccessContext {
     void ApplyImageBarrier(const IMAGE_STATE &image, const SyncBarrier &barrier, const VkImageSubresourceRange &subresource_range,
                            bool layout_transition, const ResourceUsageTag &tag);
 
+    template <typename Detector>
+    HazardResult DetectHazard(AddressType type, const Detector &detector, const ResourceAccessRange &range,
+                              DetectOptions options) const;
+    template <typename Action>
+    void UpdateMemoryAccessState(AddressType type, const ResourceAccessRange &range, const Action &action);
     template <typename Action>
     void UpdateMemoryAccess(const BUFFER_STATE &buffer, const ResourceAccessRange &range, const Action action);
     template <typename Action>
     void UpdateMemoryAccess(const IMAGE_STATE &image, const VkImageSubresourceRange &subresource_range, const Action action);
 
+    // Global barriers are appended to a log rather than applied to every tracked access at once. Each access state catches up
+    // on the log when next detected against (on a copy) or updated, so the maps returned by GetAccessStateMap may hold states
+    // with barriers still pending.
+    void ApplyGlobalBarrier(SyncGlobalBarrier &&barrier);
+    void ApplyPendingGlobalBarriers();
+
+    // Apply the final access states of an executed command buffer, retagged with execute_index, in a single pass
+    void ApplyExecutedAccesses(const AccessContext &executed, uint64_t execute_index);
+    // Merge neighbouring entries with equal access states and equivalent first accesses, for a context nothing more is recorded
+    // into. The barriers are those the first accesses are validated with at submission.
+    void Coalesce(const std::vector<SyncRecordedBarrier> &recorded_barriers);
+
+    // Copy the accesses from holds within range into the gaps this context has there, applying seed_action to each copy. For
+    // contexts holding the part of another that is in use, filled in as they go.
     template <typename Action>
-    void ApplyGlobalBarriers(const Action &barrier_action);
+    void ImportAccessRange(const AccessContext &from, AddressType type, const ResourceAccessRange &range,
+                           const Action &seed_action);
 
     static AddressType ImageAddressType(const IMAGE_STATE &image);
     static VkDeviceSize ResourceBaseAddress(const BINDABLE &bindable);
@@ -316,6 +393,10 @@ class AccessContext {
 
     AccessContext() { Reset(); }
     AccessContext(const AccessContext &copy_from) = default;
+    // A copy of base that shares base's accesses rather than copying them, only copying in those within the ranges it updates.
+    // For short lived proxies such as those validating store and resolve operations, as base must outlive the copy.
+    struct CopyOnWrite {};
+    AccessContext(const AccessContext &base, CopyOnWrite);
 
     ResourceAccessRangeMap &GetAccessStateMap(AddressType type) { return access_state_maps_[type]; }
     const ResourceAccessRangeMap &GetAccessStateMap(AddressType type) const { return access_state_maps_[type]; }
@@ -357,22 +438,31 @@ class AccessContext {
                                      DetectOptions options) const;
 
     template <typename Detector>
-    HazardResult DetectHazard(AddressType type, const Detector &detector, const ResourceAccessRange &range,
-                              DetectOptions options) const;
-    template <typename Detector>
     HazardResult DetectAsyncHazard(AddressType type, const Detector &detector, const ResourceAccessRange &range) const;
     template <typename Detector>
     HazardResult DetectPreviousHazard(AddressType type, const Detector &detector, const ResourceAccessRange &range) const;
     void UpdateAccessState(AddressType type, SyncStageAccessIndex current_usage, const ResourceAccessRange &range,
                            const ResourceUsageTag &tag);
-    constexpr static int kAddressTypeCount = AddressType::kMaxAddressType + 1;
-    static const std::array<AddressType, kAddressTypeCount> kAddressTypes;
+    bool OverwriteAccessState(AddressType type, SyncStageAccessIndex current_usage, const ResourceAccessRange &range,
+                              const ResourceUsageTag &tag);
+    void ApplyPendingGlobalBarriers(AddressType type, const ResourceAccessRange &range);
+    const ResourceAccessState &GetCurrentAccessState(const ResourceAccessState &access, ResourceAccessState *scratch) const;
+    void SetGlobalBarrierEpoch(AddressType type, const ResourceAccessRange &range);
+    void ResolveBaseAccesses(AddressType type, const ResourceAccessRange &range, ResourceAccessRangeMap *accesses) const;
+    void DetachFromBase();
+
+    // Bounds the log, and with it the work a long untouched access state has to catch up on
+    static constexpr size_t kMaxPendingGlobalBarriers = 256;
+
     std::array<ResourceAccessRangeMap, kAddressTypeCount> access_state_maps_;
     std::vector<TrackBack> prev_;
     std::vector<TrackBack *> prev_by_subpass_;
     std::vector<AccessContext *> async_;
     TrackBack src_external_;
     TrackBack dst_external_;
+    std::vector<SyncGlobalBarrier> global_barriers_;
+    // For copy-on-write contexts, the context holding the accesses in the gaps between those of access_state_maps_
+    const AccessContext *base_;
 };
 
 class RenderPassAccessContext {
@@ -433,6 +523,7 @@ class CommandBufferAccessContext {
         render_pass_contexts_.clear();
         current_context_ = &cb_access_context_;
         current_renderpass_context_ = nullptr;
+        recorded_barriers_.clear();
     }
 
     AccessContext *GetCurrentAccessContext() { return current_context_; }
@@ -455,6 +546,14 @@ class CommandBufferAccessContext {
     CMD_BUFFER_STATE *GetCommandBufferState() { return cb_state_.get(); }
     const CMD_BUFFER_STATE *GetCommandBufferState() const { return cb_state_.get(); }
     VkQueueFlags GetQueueFlags() const { return queue_flags_; }
+    void RecordBarrier(const ResourceUsageTag &tag, const SyncGlobalBarrier &barrier) {
+        recorded_barriers_.emplace_back(SyncRecordedBarrier{tag, barrier});
+    }
+    const std::vector<SyncRecordedBarrier> &GetRecordedBarriers() const { return recorded_barriers_; }
+    // Once recorded, the top-level access context with its barriers is the summary of what executing or submitting the command
+    // buffer does, and is reused as is for every execution
+    void RecordEndCommandBuffer();
+    void RecordExecuteCommands(const CommandBufferAccessContext &secondary, const ResourceUsageTag &tag);
     inline ResourceUsageTag NextCommandTag(CMD_TYPE command) {
         // TODO: add command encoding to ResourceUsageTag.
         // What else we what to include.  Do we want some sort of "parent" or global sequence number
@@ -475,6 +574,36 @@ class CommandBufferAccessContext {
     SyncValidator *sync_state_;
 
     VkQueueFlags queue_flags_;
+    // In tag order, with those of buffers and images included as global ones
+    std::vector<SyncRecordedBarrier> recorded_barriers_;
+};
+
+// The accesses of a queue as a vkQueueSubmit updates them, holding only the ranges its command buffers touch and copying them in
+// from the queue's own AccessContext as they are first touched, so that the cost of a submission follows the footprint of its
+// command buffers rather than the history of the queue. Validation builds one, which record then writes back.
+//
+// Each command buffer is summarized by its final access context: the first accesses held by its access states are validated
+// against the state left by earlier submissions, replaying the barriers it recorded before them, and the states themselves are
+// then applied on top.
+class QueueSubmitAccessContext {
+  public:
+    // Accesses of submissions up to retired_submit_index have completed, and are dropped as they are copied in
+    QueueSubmitAccessContext(const AccessContext &queue_context, uint64_t retired_submit_index)
+        : queue_context_(queue_context), retired_submit_index_(retired_submit_index) {}
+
+    void ApplyGlobalBarrier(const SyncGlobalBarrier &barrier);
+    HazardResult DetectFirstUseHazard(const CommandBufferAccessContext &cb_context, ResourceUsageTag *first_use_tag);
+    void RecordCommandBuffer(const CommandBufferAccessContext &cb_context, uint64_t submit_index);
+    void Commit(AccessContext *queue_context);
+
+  private:
+    void ImportQueueAccesses(const AccessContext &cb_access_context);
+
+    const AccessContext &queue_context_;
+    const uint64_t retired_submit_index_;
+    AccessContext accesses_;
+    // Every barrier applied to accesses_, for those copied in later on
+    std::vector<SyncGlobalBarrier> barriers_;
 };
 
 class SyncValidator : public ValidationStateTracker, public SyncStageAccess {
@@ -513,6 +642,19 @@ class SyncValidator : public ValidationStateTracker, public SyncStageAccess {
         return found_it->second.get();
     }
 
+    // The accesses submitted to each queue, tagged with the QUEUE_STATE::seq index of the submission making them
+    std::unordered_map<VkQueue, std::unique_ptr<AccessContext>> queue_access_state;
+    // The submission last validated on each queue, for PostCallRecordQueueSubmit to commit rather than simulate it again.
+    // Validation may run under a shared lock, so these have a lock of their own.
+    struct ValidatedQueueSubmit {
+        uint64_t base_submit_index;  // QUEUE_STATE::seq + submissions.size(), as validated
+        const VkSubmitInfo *submits;
+        uint32_t submit_count;
+        std::unique_ptr<QueueSubmitAccessContext> submit_context;
+    };
+    mutable std::mutex validated_submit_lock;
+    mutable std::unordered_map<VkQueue, ValidatedQueueSubmit> validated_submits;
+
     void ApplyGlobalBarriers(AccessContext *context, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask,
                              SyncStageAccessFlags src_stage_scope, SyncStageAccessFlags dst_stage_scope,
                              uint32_t memoryBarrierCount, const VkMemoryBarrier *pMemoryBarriers);
@@ -576,6 +718,16 @@ class SyncValidator : public ValidationStateTracker, public SyncStageAccess {
 
     void PostCallRecordBeginCommandBuffer(VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo *pBeginInfo,
                                           VkResult result);
+    void PostCallRecordEndCommandBuffer(VkCommandBuffer commandBuffer, VkResult result);
+
+    bool PreCallValidateCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBufferCount,
+                                           const VkCommandBuffer *pCommandBuffers) const;
+    void PreCallRecordCmdExecuteCommands(VkCommandBuffer commandBuffer, uint32_t commandBufferCount,
+                                         const VkCommandBuffer *pCommandBuffers);
+
+    bool PreCallValidateQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence) const;
+    void PostCallRecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo *pSubmits, VkFence fence,
+                                   VkResult result);
 
     void PostCallRecordCmdBeginRenderPass(VkCommandBuffer commandBuffer, const VkRenderPassBeginInfo *pRenderPassBegin,
                                           VkSubpassContents contents);
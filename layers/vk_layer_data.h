@@ -20,7 +20,10 @@
 #ifndef LAYER_DATA_H
 #define LAYER_DATA_H
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -341,6 +344,89 @@ class small_unordered_map
 template <typename Key, int N = 1>
 class small_unordered_set : public small_container<Key, Key, std::unordered_set<Key>, value_type_helper_set<Key>, N> {};
 
+// A vector for element counts that are nearly always small. The first N elements are stored inline in the object, and only
+// growing past that allocates. Elements must be default constructible and copy assignable.
+template <typename T, uint32_t N>
+class small_vector {
+  public:
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef uint32_t size_type;
+
+    small_vector() : size_(0), capacity_(N) {}
+    small_vector(const small_vector &other) : size_(0), capacity_(N) { *this = other; }
+    small_vector(small_vector &&other) : size_(0), capacity_(N) { *this = std::move(other); }
+
+    small_vector &operator=(const small_vector &other) {
+        if (this != &other) {
+            reserve(other.size_);
+            std::copy(other.begin(), other.end(), data());
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    small_vector &operator=(small_vector &&other) {
+        if (this != &other) {
+            if (other.large_store_) {
+                large_store_ = std::move(other.large_store_);
+                capacity_ = other.capacity_;
+                size_ = other.size_;
+            } else {
+                *this = static_cast<const small_vector &>(other);
+            }
+            other.capacity_ = N;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    bool operator==(const small_vector &rhs) const { return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin()); }
+    bool operator!=(const small_vector &rhs) const { return !(*this == rhs); }
+
+    void reserve(size_type new_capacity) {
+        if (new_capacity <= capacity_) return;
+        std::unique_ptr<T[]> new_store(new T[new_capacity]);
+        std::copy(begin(), end(), new_store.get());
+        large_store_ = std::move(new_store);
+        capacity_ = new_capacity;
+    }
+
+    void push_back(const T &value) {
+        if (size_ == capacity_) reserve(2 * capacity_);
+        data()[size_++] = value;
+    }
+
+    // Keeps the capacity, as the container is likely to be refilled
+    void clear() { size_ = 0; }
+
+    T *data() { return large_store_ ? large_store_.get() : small_store_; }
+    const T *data() const { return large_store_ ? large_store_.get() : small_store_; }
+    size_type size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T &operator[](size_type index) {
+        assert(index < size_);
+        return data()[index];
+    }
+    const T &operator[](size_type index) const {
+        assert(index < size_);
+        return data()[index];
+    }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size_; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+
+  private:
+    size_type size_;
+    size_type capacity_;
+    std::unique_ptr<T[]> large_store_;
+    T small_store_[N];
+};
+
 // For the given data key, look up the layer_data instance from given layer_data_map
 template <typename DATA_T>
 DATA_T *GetLayerDataPtr(void *data_key, small_unordered_map<void *, DATA_T *, 2> &layer_data_map) {
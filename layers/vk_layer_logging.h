@@ -131,6 +131,14 @@ static inline uint64_t HandleToUint64(HANDLE_T h) {
 
 static inline uint64_t HandleToUint64(uint64_t h) { return h; }
 
+// Number of messages the calling thread has attempted to log, counted whether or not anything is listening. Memoized checks
+// compare it before and after to tell a clean pass from one that only produced warnings. Not static, so that every
+// translation unit shares the same counter.
+inline uint64_t &ThreadLogMessageCount() {
+    thread_local uint64_t count = 0;
+    return count;
+}
+
 // Data we store per label for logging
 struct LoggingLabel {
     std::string name;
@@ -647,8 +655,48 @@ static inline int vasprintf(char **strp, char const *fmt, va_list ap) {
 }
 #endif
 
+// A message logged while its thread was capturing, see ThreadLogMessageCapture
+struct CapturedLogMessage {
+    VkFlags msg_flags;
+    LogObjectList objects;
+    std::string vuid_text;
+    std::string message;
+};
+
+// When set, messages logged by the calling thread are appended here instead of being reported, so that validation run on
+// worker threads can be reported in a deterministic order by the thread that issued it. A captured message reads as not
+// skipped, which is what callbacks returning VK_FALSE, as applications' callbacks should, would give.
+inline std::vector<CapturedLogMessage> *&ThreadLogMessageCapture() {
+    thread_local std::vector<CapturedLogMessage> *capture = nullptr;
+    return capture;
+}
+
+// When set, the calling thread is validating again something whose first messages were already reported by
+// ReplayCapturedLogMessages: those messages are dropped, returning the results their callbacks gave, and the ones after them
+// are reported as usual.
+struct ReportedLogMessages {
+    std::vector<bool> results;
+    size_t next = 0;
+};
+inline ReportedLogMessages *&ThreadReportedLogMessages() {
+    thread_local ReportedLogMessages *reported = nullptr;
+    return reported;
+}
+
 static inline bool LogMsgLocked(const debug_report_data *debug_data, VkFlags msg_flags, const LogObjectList &objects,
                                 const std::string &vuid_text, char *err_msg) {
+    auto capture = ThreadLogMessageCapture();
+    if (capture) {
+        capture->push_back({msg_flags, objects, vuid_text, err_msg ? err_msg : "Allocation failure"});
+        free(err_msg);
+        return false;
+    }
+    auto reported = ThreadReportedLogMessages();
+    if (reported && reported->next < reported->results.size()) {
+        free(err_msg);
+        return reported->results[reported->next++];
+    }
+
     std::string str_plus_spec_text(err_msg ? err_msg : "Allocation failure");
 
     // If message is in filter list, bail out very early
@@ -715,6 +763,22 @@ static inline bool LogMsgLocked(const debug_report_data *debug_data, VkFlags msg
     return result;
 }
 
+// Report messages gathered through ThreadLogMessageCapture, in the order they were captured, up to and including the first
+// one a callback asks to skip the call for. Returns what the callbacks returned for each message reported.
+static inline std::vector<bool> ReplayCapturedLogMessages(const debug_report_data *debug_data,
+                                                          const std::vector<CapturedLogMessage> &messages) {
+    std::vector<bool> results;
+    if (messages.empty()) return results;
+    std::unique_lock<std::mutex> lock(debug_data->debug_output_mutex);
+    for (const auto &captured : messages) {
+        char *err_msg = static_cast<char *>(malloc(captured.message.size() + 1));
+        if (err_msg) memcpy(err_msg, captured.message.c_str(), captured.message.size() + 1);
+        results.push_back(LogMsgLocked(debug_data, captured.msg_flags, captured.objects, captured.vuid_text, err_msg));
+        if (results.back()) break;
+    }
+    return results;
+}
+
 static inline VKAPI_ATTR VkBool32 VKAPI_CALL report_log_callback(VkFlags msg_flags, VkDebugReportObjectTypeEXT obj_type,
                                                                  uint64_t src_object, size_t location, int32_t msg_code,
                                                                  const char *layer_prefix, const char *message, void *user_data) {
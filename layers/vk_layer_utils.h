@@ -21,11 +21,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <stdbool.h>
 #include <string>
+#include <thread>
 #include <vector>
 #include <set>
 #include "cast_utils.h"
@@ -277,6 +283,8 @@ typedef std::unique_lock<ReadWriteLock> write_lock_guard_t;
 // contains: Returns true if the key is in the map.
 // find: Returns != end() if found, value is in ret->second.
 // pop: Erases and returns the erased value if found.
+// size/empty: Element count across all buckets. Only a snapshot while other threads are writing.
+// clear: Remove all elements.
 //
 // find/end: find returns a vaguely iterator-like type that can be compared to
 // end and can use iter->second to retrieve the reference. This is to ease porting
@@ -293,16 +301,18 @@ typedef std::unique_lock<ReadWriteLock> write_lock_guard_t;
 template <typename Key, typename T, int BUCKETSLOG2 = 2, typename Hash = std::hash<Key>>
 class vl_concurrent_unordered_map {
   public:
-    void insert_or_assign(const Key &key, const T &value) {
+    template <typename... Args>
+    void insert_or_assign(const Key &key, Args &&... args) {
         uint32_t h = ConcurrentMapHashObject(key);
         write_lock_guard_t lock(locks[h].lock);
-        maps[h][key] = value;
+        maps[h][key] = T(std::forward<Args>(args)...);
     }
 
-    bool insert(const Key &key, const T &value) {
+    template <typename... Args>
+    bool insert(const Key &key, Args &&... args) {
         uint32_t h = ConcurrentMapHashObject(key);
         write_lock_guard_t lock(locks[h].lock);
-        auto ret = maps[h].insert(typename std::unordered_map<Key, T>::value_type(key, value));
+        auto ret = maps[h].emplace(key, T(std::forward<Args>(args)...));
         return ret.second;
     }
 
@@ -376,6 +386,24 @@ class vl_concurrent_unordered_map {
         }
     }
 
+    size_t size() const {
+        size_t count = 0;
+        for (int h = 0; h < BUCKETS; ++h) {
+            read_lock_guard_t lock(locks[h].lock);
+            count += maps[h].size();
+        }
+        return count;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void clear() {
+        for (int h = 0; h < BUCKETS; ++h) {
+            write_lock_guard_t lock(locks[h].lock);
+            maps[h].clear();
+        }
+    }
+
     std::vector<std::pair<const Key, T>> snapshot(std::function<bool(T)> f = nullptr) const {
         std::vector<std::pair<const Key, T>> ret;
         for (int h = 0; h < BUCKETS; ++h) {
@@ -407,3 +435,299 @@ class vl_concurrent_unordered_map {
         return hash;
     }
 };
+
+// vl_concurrent_flat_map:
+// Concurrent map for keys and values of at most 64 bits (handles, ids and pointers), with the same interface as
+// vl_concurrent_unordered_map. Entries live in a single open addressing (linear probing) table of 16 byte key/value
+// slots. find/contains never take a lock: they load the current table and probe it. Writers are serialized on one
+// mutex, publish a value before its key, and erase by overwriting the key with a tombstone. A slot is never reused
+// within a table, so a reader that matched a key can't read the value of a different key stored there later. When the
+// table gets half full (tombstones included), or on clear(), it is replaced by a new one.
+//
+// Readers register in a striped per-epoch counter for the duration of a lookup. A writer replacing the table advances
+// the epoch and waits for the counters of the previous epoch to drain before freeing the retired table, so no reader
+// can still be probing it.
+//
+// find() can be given a FindHint, which remembers the slot the key was found in. The next lookup with it checks that
+// the slot still holds the key before probing, so it stays good while other keys are inserted and erased, and only
+// goes stale when its own key is erased or the table is replaced.
+//
+// Key value 0 (VK_NULL_HANDLE) and ~0 are reserved. A lookup that races with the erase of the same key may still
+// return the erased value, which is no worse than the application using a handle while destroying it.
+template <typename Key, typename T, typename Hash = std::hash<Key>>
+class vl_concurrent_flat_map {
+    static_assert(sizeof(Key) <= sizeof(uint64_t) && sizeof(T) <= sizeof(uint64_t),
+                  "vl_concurrent_flat_map keys and values must fit in 64 bits");
+
+  public:
+    vl_concurrent_flat_map() : table_(nullptr), count_(0), next_table_id_(0), epoch_(0) {
+        // silence -Wunused-private-field warning
+        padding_[0] = 0;
+        for (auto &stripe : readers_) {
+            stripe.count[0].store(0, std::memory_order_relaxed);
+            stripe.count[1].store(0, std::memory_order_relaxed);
+        }
+        table_.store(NewTable(kInitialCapacity));
+    }
+
+    template <typename... Args>
+    void insert_or_assign(const Key &key, Args &&... args) {
+        std::lock_guard<std::mutex> lock(write_lock_);
+        Insert(ToBits(key), ToBits(T(std::forward<Args>(args)...)), true);
+    }
+
+    template <typename... Args>
+    bool insert(const Key &key, Args &&... args) {
+        std::lock_guard<std::mutex> lock(write_lock_);
+        return Insert(ToBits(key), ToBits(T(std::forward<Args>(args)...)), false);
+    }
+
+    size_t erase(const Key &key) { return pop(key) != end() ? 1 : 0; }
+
+    bool contains(const Key &key) const {
+        ReadGuard guard(*this);
+        return Find(ToBits(key)) != nullptr;
+    }
+
+    // Same vaguely iterator-like result type as vl_concurrent_unordered_map::find
+    class FindResult {
+      public:
+        FindResult(bool a, T b) : result(a, std::move(b)) {}
+
+        // == and != only support comparing against end()
+        bool operator==(const FindResult &other) const { return result.first == false && other.result.first == false; }
+        bool operator!=(const FindResult &other) const { return !(*this == other); }
+
+        std::pair<bool, T> *operator->() { return &result; }
+        const std::pair<bool, T> *operator->() const { return &result; }
+
+      private:
+        std::pair<bool, T> result;
+    };
+
+    FindResult end() const { return FindResult(false, T()); }
+
+    FindResult find(const Key &key) const {
+        ReadGuard guard(*this);
+        const Slot *slot = Find(ToBits(key));
+        if (!slot) return end();
+        return FindResult(true, FromBits<T>(slot->value.load(std::memory_order_acquire)));
+    }
+
+    // Where find(key, hint) last found the key, or didn't. Default constructed hints never match.
+    struct FindHint {
+        uint64_t table_id = 0;
+        const void *slot = nullptr;
+    };
+
+    FindResult find(const Key &key, FindHint *hint) const {
+        ReadGuard guard(*this);
+        const uint64_t bits = ToBits(key);
+        const Table *table = table_.load(std::memory_order_acquire);
+        const Slot *slot = static_cast<const Slot *>(hint->slot);
+        // Slots aren't reused within a table, so the key still being in its slot means it hasn't been erased
+        if (hint->table_id != table->id || !slot || slot->key.load(std::memory_order_acquire) != bits) {
+            slot = Find(bits, table);
+            hint->table_id = table->id;
+            hint->slot = slot;
+        }
+        if (!slot) return end();
+        return FindResult(true, FromBits<T>(slot->value.load(std::memory_order_acquire)));
+    }
+
+    FindResult pop(const Key &key) {
+        std::lock_guard<std::mutex> lock(write_lock_);
+        Slot *slot = const_cast<Slot *>(Find(ToBits(key)));
+        if (!slot) return end();
+        FindResult ret(true, FromBits<T>(slot->value.load(std::memory_order_relaxed)));
+        slot->key.store(kTombstoneKey, std::memory_order_release);
+        count_.fetch_sub(1, std::memory_order_relaxed);
+        return ret;
+    }
+
+    size_t size() const { return count_.load(std::memory_order_relaxed); }
+
+    bool empty() const { return size() == 0; }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(write_lock_);
+        // Emptying the slots in place would let them be reused under a reader still probing them
+        table_.store(NewTable(kInitialCapacity), std::memory_order_release);
+        count_.store(0, std::memory_order_relaxed);
+        RetireTables();
+    }
+
+    std::vector<std::pair<const Key, T>> snapshot(std::function<bool(T)> f = nullptr) const {
+        std::vector<std::pair<const Key, T>> ret;
+        std::lock_guard<std::mutex> lock(write_lock_);
+        const Table *table = table_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i <= table->mask; ++i) {
+            const uint64_t key = table->slots[i].key.load(std::memory_order_relaxed);
+            if (key == kEmptyKey || key == kTombstoneKey) continue;
+            T value = FromBits<T>(table->slots[i].value.load(std::memory_order_relaxed));
+            if (!f || f(value)) {
+                ret.emplace_back(FromBits<Key>(key), value);
+            }
+        }
+        return ret;
+    }
+
+  private:
+    static const uint64_t kEmptyKey = 0;
+    static const uint64_t kTombstoneKey = ~0ULL;
+    static const size_t kInitialCapacity = 64;
+    static const size_t kReaderStripes = 16;
+
+    struct Slot {
+        std::atomic<uint64_t> key;
+        std::atomic<uint64_t> value;
+    };
+    struct Table {
+        uint64_t id;  // Unique for the life of the map, unlike the address
+        size_t mask;
+        size_t used;  // Live entries plus tombstones, only accessed by writers
+        std::unique_ptr<Slot[]> slots;
+    };
+    struct ReaderCount {
+        std::atomic<uint32_t> count[2];  // Indexed by epoch parity
+        // Put each stripe on its own cache line, so that lookups from different threads don't contend.
+        char padding[(-int(2 * sizeof(std::atomic<uint32_t>))) & 63];
+    };
+
+    // Keeps the tables visible at construction from being freed until destruction
+    class ReadGuard {
+      public:
+        explicit ReadGuard(const vl_concurrent_flat_map &map) {
+            ReaderCount &stripe = map.readers_[ThreadStripe()];
+            for (;;) {
+                const uint32_t epoch = map.epoch_.load(std::memory_order_seq_cst);
+                count_ = &stripe.count[epoch & 1];
+                count_->fetch_add(1, std::memory_order_seq_cst);
+                // If the epoch moved on, the writer may have missed this reader, so register again
+                if (map.epoch_.load(std::memory_order_seq_cst) == epoch) break;
+                count_->fetch_sub(1, std::memory_order_release);
+            }
+        }
+        ~ReadGuard() { count_->fetch_sub(1, std::memory_order_release); }
+
+      private:
+        std::atomic<uint32_t> *count_;
+    };
+
+    static size_t ThreadStripe() {
+        static thread_local const size_t stripe = std::hash<std::thread::id>()(std::this_thread::get_id()) % kReaderStripes;
+        return stripe;
+    }
+
+    template <typename U>
+    static uint64_t ToBits(const U &u) {
+        uint64_t bits = 0;
+        memcpy(&bits, &u, sizeof(U));
+        return bits;
+    }
+    template <typename U>
+    static U FromBits(uint64_t bits) {
+        U u;
+        memcpy(&u, &bits, sizeof(U));
+        return u;
+    }
+
+    static size_t Index(uint64_t key, size_t mask) {
+        // Fibonacci hashing spreads aligned pointers and sequential ids across the table
+        const uint64_t h = static_cast<uint64_t>(Hash()(FromBits<Key>(key))) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(h >> 32) & mask;
+    }
+
+    Table *NewTable(size_t capacity) {
+        std::unique_ptr<Table> table(new Table);
+        table->id = ++next_table_id_;
+        table->mask = capacity - 1;
+        table->used = 0;
+        table->slots.reset(new Slot[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            table->slots[i].key.store(kEmptyKey, std::memory_order_relaxed);
+            table->slots[i].value.store(0, std::memory_order_relaxed);
+        }
+        tables_.emplace_back(std::move(table));
+        return tables_.back().get();
+    }
+
+    // Caller holds write_lock_ or a ReadGuard
+    const Slot *Find(uint64_t key) const { return Find(key, table_.load(std::memory_order_acquire)); }
+
+    const Slot *Find(uint64_t key, const Table *table) const {
+        if (key == kEmptyKey || key == kTombstoneKey) return nullptr;
+        for (size_t i = Index(key, table->mask);; i = (i + 1) & table->mask) {
+            const uint64_t slot_key = table->slots[i].key.load(std::memory_order_acquire);
+            if (slot_key == key) return &table->slots[i];
+            if (slot_key == kEmptyKey) return nullptr;
+        }
+    }
+
+    // Caller holds write_lock_
+    bool Insert(uint64_t key, uint64_t value, bool assign) {
+        assert(key != kEmptyKey && key != kTombstoneKey);
+        if (key == kEmptyKey || key == kTombstoneKey) return false;
+        Slot *existing = const_cast<Slot *>(Find(key));
+        if (existing) {
+            if (assign) existing->value.store(value, std::memory_order_release);
+            return false;
+        }
+        Table *table = table_.load(std::memory_order_relaxed);
+        if ((table->used + 1) * 2 > table->mask + 1) {
+            table = Rehash(table);
+        }
+        for (size_t i = Index(key, table->mask);; i = (i + 1) & table->mask) {
+            Slot &slot = table->slots[i];
+            const uint64_t slot_key = slot.key.load(std::memory_order_relaxed);
+            if (slot_key == kEmptyKey) {
+                ++table->used;
+                slot.value.store(value, std::memory_order_relaxed);
+                slot.key.store(key, std::memory_order_release);
+                count_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    // Caller holds write_lock_. Tombstones are dropped, and the table only grows if live entries need the space.
+    Table *Rehash(const Table *old_table) {
+        size_t capacity = old_table->mask + 1;
+        while (count_.load(std::memory_order_relaxed) * 4 >= capacity) capacity *= 2;
+        Table *table = NewTable(capacity);
+        for (size_t i = 0; i <= old_table->mask; ++i) {
+            const uint64_t key = old_table->slots[i].key.load(std::memory_order_relaxed);
+            if (key == kEmptyKey || key == kTombstoneKey) continue;
+            size_t j = Index(key, table->mask);
+            while (table->slots[j].key.load(std::memory_order_relaxed) != kEmptyKey) j = (j + 1) & table->mask;
+            table->slots[j].value.store(old_table->slots[i].value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            table->slots[j].key.store(key, std::memory_order_relaxed);
+            ++table->used;
+        }
+        table_.store(table, std::memory_order_release);
+        RetireTables();
+        return table;
+    }
+
+    // Caller holds write_lock_ and has published the newest table. Frees all older tables once no reader can see them.
+    void RetireTables() {
+        // Readers registering after this see the new epoch, and with it the new table
+        const uint32_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        for (size_t i = 0; i < kReaderStripes; ++i) {
+            while (readers_[i].count[epoch & 1].load(std::memory_order_seq_cst) != 0) {
+                std::this_thread::yield();
+            }
+        }
+        tables_.erase(tables_.begin(), tables_.end() - 1);
+    }
+
+    // Read by every lookup, so keep it off the cache line written by every insert
+    std::atomic<Table *> table_;
+    char padding_[64];
+    std::atomic<size_t> count_;
+    mutable std::mutex write_lock_;
+    std::deque<std::unique_ptr<Table>> tables_;
+    uint64_t next_table_id_;  // Only accessed by writers
+    std::atomic<uint32_t> epoch_;
+    mutable ReaderCount readers_[kReaderStripes];
+};
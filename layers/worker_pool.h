@@ -0,0 +1,119 @@
+/* Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads running queued tasks. The threads are only started by the first Submit, so a pool that
+// is created but never used costs nothing.
+class WorkerPool {
+  public:
+    explicit WorkerPool(uint32_t thread_count = DefaultThreadCount()) : thread_count_(std::max(thread_count, 1u)) {}
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            stopping_ = true;
+        }
+        work_available_.notify_all();
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            if (threads_.empty()) {
+                for (uint32_t i = 0; i < thread_count_; ++i) {
+                    threads_.emplace_back(&WorkerPool::Run, this);
+                }
+            }
+            tasks_.emplace_back(std::move(task));
+            ++pending_;
+        }
+        work_available_.notify_one();
+    }
+
+    // Block until every task submitted so far has finished. Must not be called from a task.
+    void WaitIdle() {
+        std::unique_lock<std::mutex> lock(lock_);
+        idle_.wait(lock, [this]() { return pending_ == 0; });
+    }
+
+    // Run task(0) .. task(count - 1) on the pool and block until all of them have finished. Only waits for its own tasks,
+    // so it may be used while other work is queued. Must not be called from a task.
+    void ParallelFor(uint32_t count, const std::function<void(uint32_t)> &task) {
+        std::mutex done_lock;
+        std::condition_variable done;
+        uint32_t remaining = count;
+        for (uint32_t i = 0; i < count; ++i) {
+            Submit([&, i]() {
+                task(i);
+                std::lock_guard<std::mutex> lock(done_lock);
+                if (--remaining == 0) {
+                    done.notify_all();
+                }
+            });
+        }
+        std::unique_lock<std::mutex> lock(done_lock);
+        done.wait(lock, [&remaining]() { return remaining == 0; });
+    }
+
+    // Leave one hardware thread for the application thread that submits the work
+    static uint32_t DefaultThreadCount() {
+        const uint32_t hardware_threads = std::thread::hardware_concurrency();
+        return hardware_threads > 1 ? hardware_threads - 1 : 1;
+    }
+
+  private:
+    void Run() {
+        std::unique_lock<std::mutex> lock(lock_);
+        while (true) {
+            work_available_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;  // stopping_ and nothing left to do
+            std::function<void()> task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            if (--pending_ == 0) {
+                idle_.notify_all();
+            }
+        }
+    }
+
+    const uint32_t thread_count_;
+    std::mutex lock_;
+    std::condition_variable work_available_;
+    std::condition_variable idle_;
+    std::deque<std::function<void()>> tasks_;
+    std::vector<std::thread> threads_;
+    size_t pending_ = 0;  // Queued plus running tasks
+    bool stopping_ = false;
+};
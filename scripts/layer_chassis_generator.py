@@ -255,7 +255,25 @@ struct HashedUint64 {
     }
 };
 
-extern vl_concurrent_unordered_map<uint64_t, uint64_t, 4, HashedUint64> unique_id_mapping;
+extern vl_concurrent_flat_map<uint64_t, uint64_t, HashedUint64> unique_id_mapping;
+
+// Per-thread, direct mapped cache of where unique_id_mapping keeps wrapped handles. A hint only checks that its own map
+// slot still holds the handle, so repeated unwraps of long lived handles skip the probe, destroying other handles leaves
+// them alone, and a destroyed handle is never unwrapped from a stale hint.
+struct UnwrapCache {
+    static const uint32_t kSize = 256;
+    vl_concurrent_flat_map<uint64_t, uint64_t, HashedUint64>::FindHint hints[kSize];
+
+    static UnwrapCache &Get() {
+        static thread_local UnwrapCache cache;
+        return cache;
+    }
+
+    uint64_t Unwrap(uint64_t wrapped_id) {
+        auto iter = unique_id_mapping.find(wrapped_id, &hints[HashedUint64()(wrapped_id) & (kSize - 1)]);
+        return (iter == unique_id_mapping.end()) ? 0 : iter->second;
+    }
+};
 
 
 VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetPhysicalDeviceProcAddr(
@@ -308,6 +326,11 @@ typedef enum ValidationCheckDisables {
 typedef enum ValidationCheckEnables {
     VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ARM,
     VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ALL,
+    VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING,
+    VALIDATION_CHECK_ENABLE_DEFERRED_DRAW_VALIDATION,
+    VALIDATION_CHECK_ENABLE_GPU_ASSISTED_ASYNC_READBACK,
+    VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION,
+    VALIDATION_CHECK_ENABLE_BACKGROUND_SHADER_VALIDATION,
 } ValidationCheckEnables;
 
 typedef enum VkValidationFeatureEnable {
@@ -342,6 +365,11 @@ typedef enum EnableFlags {
     vendor_specific_arm,
     debug_printf,
     sync_validation,
+    fine_grained_locking,
+    deferred_draw_validation,
+    gpu_validation_async_readback,
+    parallel_pipeline_validation,
+    background_shader_validation,
     // Insert new enables above this line
     kMaxEnableFlags,
 } EnableFlags;
@@ -385,6 +413,15 @@ class ValidationObject {
         virtual write_lock_guard_t write_lock() {
             return write_lock_guard_t(validation_object_mutex);
         }
+        // Command buffer (vkCmd*) entry points lock through these. The application must externally synchronize the command
+        // buffer, so a validation object whose command buffer state is only touched by the recording thread, and which
+        // protects any device level state itself, may elide the object-wide lock when fine_grained_locking is enabled.
+        virtual read_lock_guard_t cb_read_lock(VkCommandBuffer command_buffer) {
+            return read_lock();
+        }
+        virtual write_lock_guard_t cb_write_lock(VkCommandBuffer command_buffer) {
+            return write_lock();
+        }
 
         void RegisterValidationObject(bool vo_enabled, uint32_t instance_api_version,
             debug_report_data* instance_report_data, std::vector<ValidationObject*> &dispatch_list) {
@@ -430,6 +467,7 @@ class ValidationObject {
         // Debug Logging Helpers
         bool LogError(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -448,6 +486,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogError(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -467,6 +506,7 @@ class ValidationObject {
 
         bool LogWarning(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -485,6 +525,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogWarning(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -503,6 +544,7 @@ class ValidationObject {
 
         bool LogPerformanceWarning(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT)) {
@@ -521,6 +563,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogPerformanceWarning(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT)) {
@@ -539,6 +582,7 @@ class ValidationObject {
 
         bool LogInfo(const LogObjectList &objects, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -557,6 +601,7 @@ class ValidationObject {
         template <typename HANDLE_T>
         bool LogInfo(HANDLE_T src_object, const std::string &vuid_text, const char *format, ...) const {
             std::unique_lock<std::mutex> lock(report_data->debug_output_mutex);
+            ++ThreadLogMessageCount();
             // Avoid logging cost if msg is to be ignored
             if (!(report_data->active_severities & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) ||
                 !(report_data->active_types & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT)) {
@@ -594,10 +639,7 @@ class ValidationObject {
         // Unwrap a handle.
         template <typename HandleType>
         HandleType Unwrap(HandleType wrappedHandle) {
-            auto iter = unique_id_mapping.find(reinterpret_cast<uint64_t const &>(wrappedHandle));
-            if (iter == unique_id_mapping.end())
-                return (HandleType)0;
-            return (HandleType)iter->second;
+            return (HandleType)UnwrapCache::Get().Unwrap(reinterpret_cast<uint64_t const &>(wrappedHandle));
         }
 
         // Wrap a newly created handle with a new unique ID, and return the new ID.
@@ -671,7 +713,7 @@ small_unordered_map<void*, ValidationObject*, 2> layer_data_map;
 std::atomic<uint64_t> global_unique_id(1ULL);
 // Map uniqueID to actual object handle. Accesses to the map itself are
 // internally synchronized.
-vl_concurrent_unordered_map<uint64_t, uint64_t, 4, HashedUint64> unique_id_mapping;
+vl_concurrent_flat_map<uint64_t, uint64_t, HashedUint64> unique_id_mapping;
 
 bool wrap_handles = true;
 
@@ -784,6 +826,11 @@ static const std::unordered_map<std::string, ValidationCheckDisables> Validation
 static const std::unordered_map<std::string, ValidationCheckEnables> ValidationEnableLookup = {
     {"VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ARM", VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ARM},
     {"VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ALL", VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ALL},
+    {"VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING", VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING},
+    {"VALIDATION_CHECK_ENABLE_DEFERRED_DRAW_VALIDATION", VALIDATION_CHECK_ENABLE_DEFERRED_DRAW_VALIDATION},
+    {"VALIDATION_CHECK_ENABLE_GPU_ASSISTED_ASYNC_READBACK", VALIDATION_CHECK_ENABLE_GPU_ASSISTED_ASYNC_READBACK},
+    {"VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION", VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION},
+    {"VALIDATION_CHECK_ENABLE_BACKGROUND_SHADER_VALIDATION", VALIDATION_CHECK_ENABLE_BACKGROUND_SHADER_VALIDATION},
 };
 
 // This should mirror the 'DisableFlags' enumerated type
@@ -809,7 +856,12 @@ static const std::vector<std::string> EnableFlagNameHelper = {
     "VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT",                     // best_practices,
     "VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ARM",                         // vendor_specific_arm,
     "VK_VALIDATION_FEATURE_ENABLE_DEBUG_PRINTF_EXT",                       // debug_printf,
-    "VK_VALIDATION_FEATURE_ENABLE_SYNCHRONIZATION_VALIDATION"              // sync_validation,
+    "VK_VALIDATION_FEATURE_ENABLE_SYNCHRONIZATION_VALIDATION",             // sync_validation,
+    "VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING",                        // fine_grained_locking,
+    "VALIDATION_CHECK_ENABLE_DEFERRED_DRAW_VALIDATION",                    // deferred_draw_validation,
+    "VALIDATION_CHECK_ENABLE_GPU_ASSISTED_ASYNC_READBACK",                 // gpu_validation_async_readback,
+    "VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION",                // parallel_pipeline_validation,
+    "VALIDATION_CHECK_ENABLE_BACKGROUND_SHADER_VALIDATION"                 // background_shader_validation,
 };
 
 // Set the local disable flag for the appropriate VALIDATION_CHECK_DISABLE enum
@@ -877,6 +929,21 @@ void SetValidationEnable(CHECK_ENABLED &enable_data, const ValidationCheckEnable
         case VALIDATION_CHECK_ENABLE_VENDOR_SPECIFIC_ALL:
             enable_data[vendor_specific_arm] = true;
             break;
+        case VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING:
+            enable_data[fine_grained_locking] = true;
+            break;
+        case VALIDATION_CHECK_ENABLE_DEFERRED_DRAW_VALIDATION:
+            enable_data[deferred_draw_validation] = true;
+            break;
+        case VALIDATION_CHECK_ENABLE_GPU_ASSISTED_ASYNC_READBACK:
+            enable_data[gpu_validation_async_readback] = true;
+            break;
+        case VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION:
+            enable_data[parallel_pipeline_validation] = true;
+            break;
+        case VALIDATION_CHECK_ENABLE_BACKGROUND_SHADER_VALIDATION:
+            enable_data[background_shader_validation] = true;
+            break;
         default:
             assert(true);
     }
@@ -2349,19 +2416,25 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkNegotiateLoaderLayerInterfaceVe
         if (resulttype.text != 'void'):
             assignresult = resulttype.text + ' result = '
 
-        # Set up skip and locking
+        # Set up skip and locking. Command buffer level entry points let the validation objects choose their own lock.
         self.appendSection('command', '    bool skip = false;')
+        if name.startswith('vkCmd') and dispatchable_name == 'commandBuffer':
+            read_lock = 'cb_read_lock(commandBuffer)'
+            write_lock = 'cb_write_lock(commandBuffer)'
+        else:
+            read_lock = 'read_lock()'
+            write_lock = 'write_lock()'
 
         # Generate pre-call validation source code
         self.appendSection('command', '    %s' % self.precallvalidate_loop)
-        self.appendSection('command', '        auto lock = intercept->read_lock();')
+        self.appendSection('command', '        auto lock = intercept->%s;' % read_lock)
         self.appendSection('command', '        skip |= (const_cast<const ValidationObject*>(intercept))->PreCallValidate%s(%s);' % (api_function_name[2:], paramstext))
         self.appendSection('command', '        if (skip) %s' % return_map[resulttype.text])
         self.appendSection('command', '    }')
 
         # Generate pre-call state recording source code
         self.appendSection('command', '    %s' % self.precallrecord_loop)
-        self.appendSection('command', '        auto lock = intercept->write_lock();')
+        self.appendSection('command', '        auto lock = intercept->%s;' % write_lock)
         self.appendSection('command', '        intercept->PreCallRecord%s(%s);' % (api_function_name[2:], paramstext))
         self.appendSection('command', '    }')
 
@@ -2381,7 +2454,7 @@ VK_LAYER_EXPORT VKAPI_ATTR VkResult VKAPI_CALL vkNegotiateLoaderLayerInterfaceVe
         returnparam = ''
         if (resulttype.text == 'VkResult' or resulttype.text == 'VkDeviceAddress'):
             returnparam = ', result'
-        self.appendSection('command', '        auto lock = intercept->write_lock();')
+        self.appendSection('command', '        auto lock = intercept->%s;' % write_lock)
         self.appendSection('command', '        intercept->PostCallRecord%s(%s%s);' % (api_function_name[2:], paramstext, returnparam))
         self.appendSection('command', '    }')
         # Return result variable, if any.
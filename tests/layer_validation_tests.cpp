@@ -3141,6 +3141,29 @@ void VkSyncValTest::InitSyncValFramework() {
     InitFramework(m_errorMonitor, &features_);
 }
 
+static void SetEnvironmentVariable(const char *name, const char *value) {
+#if defined(_WIN32)
+    _putenv_s(name, value ? value : "");
+#else
+    if (value) {
+        setenv(name, value, 1);
+    } else {
+        unsetenv(name);
+    }
+#endif
+}
+
+ScopedEnvironmentVariable::ScopedEnvironmentVariable(const char *name, const std::string &value) : name_(name) {
+    const char *old_value = getenv(name);
+    had_value_ = old_value != nullptr;
+    if (had_value_) old_value_ = old_value;
+    SetEnvironmentVariable(name, value.c_str());
+}
+
+ScopedEnvironmentVariable::~ScopedEnvironmentVariable() {
+    SetEnvironmentVariable(name_.c_str(), had_value_ ? old_value_.c_str() : nullptr);
+}
+
 void print_android(const char *c) {
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
     __android_log_print(ANDROID_LOG_INFO, "VulkanLayerValidationTests", "%s", c);
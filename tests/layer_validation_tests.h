@@ -784,5 +784,17 @@ bool InitFrameworkForRayTracingTest(VkRenderFramework *renderFramework, bool isK
 void GetSimpleGeometryForAccelerationStructureTests(const VkDeviceObj &device, VkBufferObj *vbo, VkBufferObj *ibo,
                                                     VkGeometryNV *geometry);
 
+// Sets an environment variable read by the layers at instance or device creation, restoring the old value when destroyed
+class ScopedEnvironmentVariable {
+  public:
+    ScopedEnvironmentVariable(const char *name, const std::string &value);
+    ~ScopedEnvironmentVariable();
+
+  private:
+    std::string name_;
+    std::string old_value_;
+    bool had_value_;
+};
+
 void print_android(const char *c);
 #endif  // VKLAYERTEST_H
@@ -13869,3 +13869,120 @@ TEST_F(VkSyncValTest, SyncLayoutTransition) {
                            &full_subresource_range);
     m_errorMonitor->VerifyFound();
 }
+
+TEST_F(VkSyncValTest, SyncQueueSubmitHazards) {
+    ASSERT_NO_FATAL_FAILURE(InitSyncValFramework());
+    ASSERT_NO_FATAL_FAILURE(InitState());
+
+    VkBufferObj buffer_a;
+    VkBufferObj buffer_b;
+    VkMemoryPropertyFlags mem_prop = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    buffer_a.init_as_src_and_dst(*m_device, 256, mem_prop);
+    buffer_b.init_as_src_and_dst(*m_device, 256, mem_prop);
+    VkBufferCopy region = {0, 0, 256};
+
+    // Each command buffer is hazard free on its own
+    m_errorMonitor->ExpectSuccess();
+    VkCommandBufferObj cb_write(m_device, m_commandPool);
+    cb_write.begin();
+    vk::CmdCopyBuffer(cb_write.handle(), buffer_a.handle(), buffer_b.handle(), 1, &region);
+    cb_write.end();
+
+    VkCommandBufferObj cb_write_again(m_device, m_commandPool);
+    cb_write_again.begin();
+    vk::CmdCopyBuffer(cb_write_again.handle(), buffer_a.handle(), buffer_b.handle(), 1, &region);
+    cb_write_again.end();
+
+    VkCommandBufferObj cb_barrier_write(m_device, m_commandPool);
+    cb_barrier_write.begin();
+    auto buffer_barrier = lvl_init_struct<VkBufferMemoryBarrier>();
+    buffer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    buffer_barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    buffer_barrier.buffer = buffer_b.handle();
+    buffer_barrier.offset = 0;
+    buffer_barrier.size = 256;
+    vk::CmdPipelineBarrier(cb_barrier_write.handle(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
+                           nullptr, 1, &buffer_barrier, 0, nullptr);
+    vk::CmdCopyBuffer(cb_barrier_write.handle(), buffer_a.handle(), buffer_b.handle(), 1, &region);
+    cb_barrier_write.end();
+    m_errorMonitor->VerifyNotFound();
+
+    // The second write to buffer_b isn't ordered after the first one
+    VkCommandBuffer write_twice[] = {cb_write.handle(), cb_write_again.handle()};
+    VkSubmitInfo submit_info = lvl_init_struct<VkSubmitInfo>();
+    submit_info.commandBufferCount = 2;
+    submit_info.pCommandBuffers = write_twice;
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "SYNC-HAZARD-WRITE_AFTER_WRITE");
+    vk::QueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+    m_errorMonitor->VerifyFound();
+    vk::QueueWaitIdle(m_device->m_queue);
+
+    // A barrier recorded ahead of the write orders it after the earlier submission
+    m_errorMonitor->ExpectSuccess();
+    VkCommandBuffer write_then_barrier_write[] = {cb_write.handle(), cb_barrier_write.handle()};
+    submit_info.pCommandBuffers = write_then_barrier_write;
+    vk::QueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+    vk::QueueWaitIdle(m_device->m_queue);
+
+    // As does waiting for the earlier submission to complete
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &write_twice[0];
+    vk::QueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+    vk::QueueWaitIdle(m_device->m_queue);
+    submit_info.pCommandBuffers = &write_twice[1];
+    vk::QueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+    vk::QueueWaitIdle(m_device->m_queue);
+    m_errorMonitor->VerifyNotFound();
+}
+
+TEST_F(VkSyncValTest, SyncCmdExecuteCommandsHazards) {
+    ASSERT_NO_FATAL_FAILURE(InitSyncValFramework());
+    ASSERT_NO_FATAL_FAILURE(InitState());
+
+    VkBufferObj buffer_a;
+    VkBufferObj buffer_b;
+    VkMemoryPropertyFlags mem_prop = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    buffer_a.init_as_src_and_dst(*m_device, 256, mem_prop);
+    buffer_b.init_as_src_and_dst(*m_device, 256, mem_prop);
+    VkBufferCopy region = {0, 0, 256};
+
+    m_errorMonitor->ExpectSuccess();
+    VkCommandBufferObj secondary_write(m_device, m_commandPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    secondary_write.begin();
+    vk::CmdCopyBuffer(secondary_write.handle(), buffer_a.handle(), buffer_b.handle(), 1, &region);
+    secondary_write.end();
+
+    VkCommandBufferObj secondary_write_again(m_device, m_commandPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    secondary_write_again.begin();
+    vk::CmdCopyBuffer(secondary_write_again.handle(), buffer_a.handle(), buffer_b.handle(), 1, &region);
+    secondary_write_again.end();
+    m_errorMonitor->VerifyNotFound();
+
+    // Against the accesses of the primary
+    m_commandBuffer->begin();
+    vk::CmdCopyBuffer(m_commandBuffer->handle(), buffer_b.handle(), buffer_a.handle(), 1, &region);
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "SYNC-HAZARD-WRITE_AFTER_READ");
+    vk::CmdExecuteCommands(m_commandBuffer->handle(), 1, &secondary_write.handle());
+    m_errorMonitor->VerifyFound();
+    m_commandBuffer->end();
+
+    // Against those of the command buffers ahead in the same call
+    m_commandBuffer->reset();
+    m_commandBuffer->begin();
+    VkCommandBuffer write_twice[] = {secondary_write.handle(), secondary_write_again.handle()};
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "SYNC-HAZARD-WRITE_AFTER_WRITE");
+    vk::CmdExecuteCommands(m_commandBuffer->handle(), 2, write_twice);
+    m_errorMonitor->VerifyFound();
+    m_commandBuffer->end();
+
+    // And the accesses of the secondaries against the commands recorded after them
+    m_commandBuffer->reset();
+    m_commandBuffer->begin();
+    m_errorMonitor->ExpectSuccess();
+    vk::CmdExecuteCommands(m_commandBuffer->handle(), 1, &secondary_write.handle());
+    m_errorMonitor->VerifyNotFound();
+    m_errorMonitor->SetDesiredFailureMsg(VK_DEBUG_REPORT_ERROR_BIT_EXT, "SYNC-HAZARD-READ_AFTER_WRITE");
+    vk::CmdCopyBuffer(m_commandBuffer->handle(), buffer_b.handle(), buffer_a.handle(), 1, &region);
+    m_errorMonitor->VerifyFound();
+    m_commandBuffer->end();
+}
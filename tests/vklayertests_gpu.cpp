@@ -1,3 +1,6 @@
+#include <fstream>
+#include <iterator>
+
 #include "layer_validation_tests.h"
 
 bool VkGpuAssistedLayerTest::InitGpuAssistedFramework(bool request_descriptor_indexing) {
@@ -1457,6 +1460,220 @@ TEST_F(VkGpuAssistedLayerTest, GpuValidationInlineUniformBlockAndMiscGpu) {
     delete[] layouts;
 }
 
+TEST_F(VkGpuAssistedLayerTest, GpuValidationAsyncReadback) {
+    TEST_DESCRIPTION("GPU validation: Verify errors are reported when results are read back asynchronously.");
+    SetTargetApiVersion(VK_API_VERSION_1_1);
+
+    VkLayerSettingValueDataEXT setting_string_value{};
+    setting_string_value.arrayString.pCharArray = "VALIDATION_CHECK_ENABLE_GPU_ASSISTED_ASYNC_READBACK";
+    setting_string_value.arrayString.count = sizeof(setting_string_value.arrayString.pCharArray);
+    VkLayerSettingValueEXT setting_val = {"enables", VK_LAYER_SETTING_VALUE_TYPE_STRING_ARRAY_EXT, setting_string_value};
+    VkLayerSettingsEXT layer_settings{static_cast<VkStructureType>(VK_STRUCTURE_TYPE_INSTANCE_LAYER_SETTINGS_EXT), nullptr, 1,
+                                      &setting_val};
+    VkValidationFeatureEnableEXT enables[] = {VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_EXT};
+    VkValidationFeaturesEXT features = {};
+    features.sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+    features.pNext = &layer_settings;
+    features.enabledValidationFeatureCount = 1;
+    features.pEnabledValidationFeatures = enables;
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &features));
+    if (IsPlatform(kMockICD) || DeviceSimulation()) {
+        printf("%s GPU-Assisted validation test requires a driver that can draw.\n", kSkipPrefix);
+        return;
+    }
+    ASSERT_NO_FATAL_FAILURE(InitState());
+    if (DeviceValidationVersion() < VK_API_VERSION_1_1) {
+        printf("%s GPU-Assisted validation test requires Vulkan 1.1+.\n", kSkipPrefix);
+        return;
+    }
+
+    uint32_t qfi = 0;
+    VkBufferCreateInfo bci = {};
+    bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bci.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bci.size = 1024;
+    bci.queueFamilyIndexCount = 1;
+    bci.pQueueFamilyIndices = &qfi;
+    VkBufferObj index_buffer;
+    VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    index_buffer.init(*m_device, bci, mem_props);
+    bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    VkBufferObj storage_buffer;
+    storage_buffer.init(*m_device, bci, mem_props);
+
+    OneOffDescriptorSet descriptor_set(m_device, {
+                                                     {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr},
+                                                     {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6, VK_SHADER_STAGE_ALL, nullptr},
+                                                 });
+    const VkPipelineLayoutObj pipeline_layout(m_device, {&descriptor_set.layout_});
+
+    VkDescriptorBufferInfo buffer_info[7] = {};
+    buffer_info[0].buffer = index_buffer.handle();
+    buffer_info[0].offset = 0;
+    buffer_info[0].range = sizeof(uint32_t);
+    for (int i = 1; i < 7; i++) {
+        buffer_info[i].buffer = storage_buffer.handle();
+        buffer_info[i].offset = 0;
+        buffer_info[i].range = 4 * sizeof(float);
+    }
+    VkWriteDescriptorSet descriptor_writes[2] = {};
+    descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptor_writes[0].dstSet = descriptor_set.set_;
+    descriptor_writes[0].dstBinding = 0;
+    descriptor_writes[0].descriptorCount = 1;
+    descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptor_writes[0].pBufferInfo = buffer_info;
+    descriptor_writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptor_writes[1].dstSet = descriptor_set.set_;
+    descriptor_writes[1].dstBinding = 1;
+    descriptor_writes[1].descriptorCount = 6;
+    descriptor_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptor_writes[1].pBufferInfo = &buffer_info[1];
+    vk::UpdateDescriptorSets(m_device->device(), 2, descriptor_writes, 0, NULL);
+
+    char const *csSource =
+        "#version 450\n"
+        "layout(set = 0, binding = 0) uniform ufoo { uint index; } u_index;\n"
+        "layout(set = 0, binding = 1) buffer StorageBuffer { uint data; } Data[6];\n"
+        "void main() {\n"
+        "    Data[u_index.index].data = 0xdeadca71;\n"
+        "}\n";
+    CreateComputePipelineHelper pipe(*this);
+    pipe.InitInfo();
+    pipe.cs_.reset(new VkShaderObj(m_device, csSource, VK_SHADER_STAGE_COMPUTE_BIT, this));
+    pipe.InitState();
+    pipe.pipeline_layout_ = VkPipelineLayoutObj(m_device, {&descriptor_set.layout_});
+    pipe.CreateComputePipeline();
+
+    m_commandBuffer->begin();
+    vk::CmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_);
+    vk::CmdBindDescriptorSets(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_layout_.handle(), 0, 1,
+                              &descriptor_set.set_, 0, nullptr);
+    vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+    m_commandBuffer->end();
+
+    uint32_t *data = (uint32_t *)index_buffer.memory().map();
+    data[0] = 25;
+    index_buffer.memory().unmap();
+
+    VkSubmitInfo submit_info = {};
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &m_commandBuffer->handle();
+
+    // Nothing is read back while the submission may still be running
+    m_errorMonitor->ExpectSuccess();
+    vk::QueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE);
+    m_errorMonitor->VerifyNotFound();
+
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Index of 25 used to index descriptor array of length 6.");
+    vk::QueueWaitIdle(m_device->m_queue);
+    m_errorMonitor->VerifyFound();
+}
+
+TEST_F(VkGpuAssistedLayerTest, GpuValidationDynamicStorageBufferLimit) {
+    TEST_DESCRIPTION("GPU validation: Verify errors are reported for pipeline layouts that use every dynamic storage buffer.");
+    SetTargetApiVersion(VK_API_VERSION_1_1);
+    InitGpuAssistedFramework(false);
+    if (IsPlatform(kMockICD) || DeviceSimulation()) {
+        printf("%s GPU-Assisted validation test requires a driver that can draw.\n", kSkipPrefix);
+        return;
+    }
+    ASSERT_NO_FATAL_FAILURE(InitState());
+    if (DeviceValidationVersion() < VK_API_VERSION_1_1) {
+        printf("%s GPU-Assisted validation test requires Vulkan 1.1+.\n", kSkipPrefix);
+        return;
+    }
+
+    // Use up every dynamic storage buffer, so the layer has to bind its output buffer without a dynamic offset.
+    // GPU-AV adds three storage buffers of its own to every stage.
+    const auto &limits = m_device->props.limits;
+    const uint32_t dynamic_count = limits.maxDescriptorSetStorageBuffersDynamic;
+    if (dynamic_count == 0 || limits.maxPerStageDescriptorStorageBuffers < 6 + dynamic_count + 3 ||
+        limits.maxDescriptorSetStorageBuffers < 6 + dynamic_count + 3) {
+        printf("%s Storage buffer limits too small for this test.\n", kSkipPrefix);
+        return;
+    }
+
+    VkBufferCreateInfo bci = {};
+    bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bci.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bci.size = 1024;
+    VkBufferObj index_buffer;
+    VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    index_buffer.init(*m_device, bci, mem_props);
+    bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    VkBufferObj storage_buffer;
+    storage_buffer.init(*m_device, bci, mem_props);
+
+    OneOffDescriptorSet descriptor_set(
+        m_device, {
+                      {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr},
+                      {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6, VK_SHADER_STAGE_ALL, nullptr},
+                      {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, dynamic_count, VK_SHADER_STAGE_ALL, nullptr},
+                  });
+
+    std::vector<VkDescriptorBufferInfo> buffer_info(7 + dynamic_count);
+    buffer_info[0].buffer = index_buffer.handle();
+    buffer_info[0].offset = 0;
+    buffer_info[0].range = sizeof(uint32_t);
+    for (size_t i = 1; i < buffer_info.size(); i++) {
+        buffer_info[i].buffer = storage_buffer.handle();
+        buffer_info[i].offset = 0;
+        buffer_info[i].range = 4 * sizeof(float);
+    }
+    VkWriteDescriptorSet descriptor_writes[3] = {};
+    for (uint32_t i = 0; i < 3; i++) {
+        descriptor_writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[i].dstSet = descriptor_set.set_;
+        descriptor_writes[i].dstBinding = i;
+    }
+    descriptor_writes[0].descriptorCount = 1;
+    descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    descriptor_writes[0].pBufferInfo = &buffer_info[0];
+    descriptor_writes[1].descriptorCount = 6;
+    descriptor_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptor_writes[1].pBufferInfo = &buffer_info[1];
+    descriptor_writes[2].descriptorCount = dynamic_count;
+    descriptor_writes[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    descriptor_writes[2].pBufferInfo = &buffer_info[7];
+    vk::UpdateDescriptorSets(m_device->device(), 3, descriptor_writes, 0, NULL);
+
+    char const *csSource =
+        "#version 450\n"
+        "layout(set = 0, binding = 0) uniform ufoo { uint index; } u_index;\n"
+        "layout(set = 0, binding = 1) buffer StorageBuffer { uint data; } Data[6];\n"
+        "void main() {\n"
+        "    Data[u_index.index].data = 0xdeadca71;\n"
+        "}\n";
+    CreateComputePipelineHelper pipe(*this);
+    pipe.InitInfo();
+    pipe.cs_.reset(new VkShaderObj(m_device, csSource, VK_SHADER_STAGE_COMPUTE_BIT, this));
+    pipe.InitState();
+    pipe.pipeline_layout_ = VkPipelineLayoutObj(m_device, {&descriptor_set.layout_});
+    pipe.CreateComputePipeline();
+
+    const std::vector<uint32_t> dynamic_offsets(dynamic_count, 0);
+    m_commandBuffer->begin();
+    vk::CmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_);
+    vk::CmdBindDescriptorSets(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_layout_.handle(), 0, 1,
+                              &descriptor_set.set_, dynamic_count, dynamic_offsets.data());
+    vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+    vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+    m_commandBuffer->end();
+
+    uint32_t *data = (uint32_t *)index_buffer.memory().map();
+    data[0] = 25;
+    index_buffer.memory().unmap();
+
+    // Each dispatch writes to its own output region
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Index of 25 used to index descriptor array of length 6.");
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Index of 25 used to index descriptor array of length 6.");
+    m_commandBuffer->QueueCommandBuffer();
+    vk::QueueWaitIdle(m_device->m_queue);
+    m_errorMonitor->VerifyFound();
+}
+
 TEST_F(VkGpuAssistedLayerTest, GpuValidationAbort) {
     TEST_DESCRIPTION("GPU validation: Verify that aborting GPU-AV is safe.");
 
@@ -1760,3 +1977,150 @@ TEST_F(VkDebugPrintfTest, GpuDebugPrintf) {
         m_errorMonitor->VerifyFound();
     }
 }
+
+TEST_F(VkGpuAssistedLayerTest, GpuValidationShaderCache) {
+    TEST_DESCRIPTION(
+        "GPU validation: Verify errors are reported with shaders from the shader cache, and that the cache is dropped for another "
+        "SPIRV-Tools and kept within its size.");
+    SetTargetApiVersion(VK_API_VERSION_1_1);
+
+    const char *cache_path = "vk_gpu_validation_shader_cache_test.bin";
+    remove(cache_path);
+    ScopedEnvironmentVariable cache_path_env("VK_LAYER_GPU_VALIDATION_SHADER_CACHE_PATH", cache_path);
+
+    // The file starts with a magic number and version, the SPIRV-Tools commit hash and the entry count
+    const size_t tools_hash_offset = 2 * sizeof(uint32_t);
+    const size_t entry_count_offset = tools_hash_offset + sizeof(uint64_t);
+    const size_t header_size = entry_count_offset + sizeof(uint32_t);
+    // Anything following the entries is ignored by the layer, and only goes away when it writes the file again
+    const std::string marker = "not rewritten";
+    uint64_t expected_tools_hash = 0;
+    uint32_t expected_entry_count = 0;
+
+    char const *csSource =
+        "#version 450\n"
+        "layout(set = 0, binding = 0) uniform ufoo { uint index; } u_index;\n"
+        "layout(set = 0, binding = 1) buffer StorageBuffer { uint data; } Data[6];\n"
+        "void main() {\n"
+        "    Data[u_index.index].data = 0xdeadca71;\n"
+        "}\n";
+
+    // Cold, warm, warm with the entries of another SPIRV-Tools, and warm with a cache capped at 0 MB
+    for (uint32_t run = 0; run < 4; ++run) {
+        ScopedEnvironmentVariable cache_size_env("VK_LAYER_GPU_VALIDATION_SHADER_CACHE_SIZE", run == 3 ? "0" : "256");
+        InitGpuAssistedFramework(false);
+        if (IsPlatform(kMockICD) || DeviceSimulation()) {
+            printf("%s GPU-Assisted validation test requires a driver that can draw.\n", kSkipPrefix);
+            return;
+        }
+        ASSERT_NO_FATAL_FAILURE(InitState());
+        if (DeviceValidationVersion() < VK_API_VERSION_1_1) {
+            printf("%s GPU-Assisted validation test requires Vulkan 1.1+.\n", kSkipPrefix);
+            return;
+        }
+
+        VkBufferCreateInfo bci = {};
+        bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bci.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+        bci.size = 1024;
+        VkBufferObj index_buffer;
+        VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        index_buffer.init(*m_device, bci, mem_props);
+        bci.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        VkBufferObj storage_buffer;
+        storage_buffer.init(*m_device, bci, mem_props);
+
+        OneOffDescriptorSet descriptor_set(m_device, {
+                                                         {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_ALL, nullptr},
+                                                         {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6, VK_SHADER_STAGE_ALL, nullptr},
+                                                     });
+        VkDescriptorBufferInfo buffer_info[7] = {};
+        buffer_info[0].buffer = index_buffer.handle();
+        buffer_info[0].range = sizeof(uint32_t);
+        for (int i = 1; i < 7; i++) {
+            buffer_info[i].buffer = storage_buffer.handle();
+            buffer_info[i].range = 4 * sizeof(float);
+        }
+        VkWriteDescriptorSet descriptor_writes[2] = {};
+        descriptor_writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[0].dstSet = descriptor_set.set_;
+        descriptor_writes[0].dstBinding = 0;
+        descriptor_writes[0].descriptorCount = 1;
+        descriptor_writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptor_writes[0].pBufferInfo = buffer_info;
+        descriptor_writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptor_writes[1].dstSet = descriptor_set.set_;
+        descriptor_writes[1].dstBinding = 1;
+        descriptor_writes[1].descriptorCount = 6;
+        descriptor_writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        descriptor_writes[1].pBufferInfo = &buffer_info[1];
+        vk::UpdateDescriptorSets(m_device->device(), 2, descriptor_writes, 0, NULL);
+
+        CreateComputePipelineHelper pipe(*this);
+        pipe.InitInfo();
+        pipe.cs_.reset(new VkShaderObj(m_device, csSource, VK_SHADER_STAGE_COMPUTE_BIT, this));
+        pipe.InitState();
+        pipe.pipeline_layout_ = VkPipelineLayoutObj(m_device, {&descriptor_set.layout_});
+        pipe.CreateComputePipeline();
+
+        m_commandBuffer->begin();
+        vk::CmdBindPipeline(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_);
+        vk::CmdBindDescriptorSets(m_commandBuffer->handle(), VK_PIPELINE_BIND_POINT_COMPUTE, pipe.pipeline_layout_.handle(), 0, 1,
+                                  &descriptor_set.set_, 0, nullptr);
+        vk::CmdDispatch(m_commandBuffer->handle(), 1, 1, 1);
+        m_commandBuffer->end();
+
+        uint32_t *data = (uint32_t *)index_buffer.memory().map();
+        data[0] = 25;
+        index_buffer.memory().unmap();
+
+        m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Index of 25 used to index descriptor array of length 6.");
+        m_commandBuffer->QueueCommandBuffer();
+        m_errorMonitor->VerifyFound();
+
+        // The cache is written when the device is destroyed
+        ShutdownFramework();
+        std::vector<char> cache;
+        {
+            std::ifstream file(cache_path, std::ios::binary);
+            cache.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        ASSERT_GE(cache.size(), header_size);
+        uint64_t tools_hash = 0;
+        uint32_t entry_count = 0;
+        memcpy(&tools_hash, &cache[tools_hash_offset], sizeof(tools_hash));
+        memcpy(&entry_count, &cache[entry_count_offset], sizeof(entry_count));
+        const bool has_marker =
+            cache.size() >= header_size + marker.size() && std::equal(marker.begin(), marker.end(), cache.end() - marker.size());
+
+        switch (run) {
+            case 0:
+                ASSERT_GT(entry_count, 0u);
+                expected_tools_hash = tools_hash;
+                expected_entry_count = entry_count;
+                cache.insert(cache.end(), marker.begin(), marker.end());
+                break;
+            case 1:
+                // Every shader was found in the cache, so there was nothing to write back
+                ASSERT_TRUE(has_marker);
+                // Make the entries look like they were made by another SPIRV-Tools
+                tools_hash = ~tools_hash;
+                memcpy(&cache[tools_hash_offset], &tools_hash, sizeof(tools_hash));
+                break;
+            case 2:
+                // The entries were dropped, and the shaders instrumented and written again
+                ASSERT_FALSE(has_marker);
+                ASSERT_EQ(expected_tools_hash, tools_hash);
+                ASSERT_EQ(expected_entry_count, entry_count);
+                break;
+            default:
+                // No entry fits in 0 MB
+                ASSERT_EQ(0u, entry_count);
+                ASSERT_EQ(header_size, cache.size());
+                break;
+        }
+        std::ofstream file(cache_path, std::ios::binary | std::ios::trunc);
+        file.write(cache.data(), cache.size());
+    }
+    remove(cache_path);
+}
@@ -27,6 +27,10 @@
 #include "cast_utils.h"
 #include "layer_validation_tests.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 class MessageIdFilter {
   public:
     MessageIdFilter(const char *filter_string) {
@@ -3883,6 +3887,66 @@ TEST_F(VkLayerTest, ThreadUpdateDescriptorUpdateAfterBindNoCollision) {
 
     m_errorMonitor->VerifyNotFound();
 }
+
+static VKAPI_ATTR VkBool32 VKAPI_CALL CountThreadingErrors(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+                                                          VkDebugUtilsMessageTypeFlagsEXT messageTypes,
+                                                          const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData,
+                                                          void *pUserData) {
+    if (strstr(pCallbackData->pMessage, "THREADING ERROR") == nullptr) return VK_FALSE;
+    reinterpret_cast<std::atomic<uint32_t> *>(pUserData)->fetch_add(1);
+    // Skip the call, so that the thread safety layer waits for the queue to become idle
+    return VK_TRUE;
+}
+
+TEST_F(VkLayerTest, ThreadQueueCollision) {
+    TEST_DESCRIPTION("Use one queue from several threads until they collide, the colliding threads wait for the queue");
+
+    if (InstanceExtensionSupported(VK_EXT_DEBUG_UTILS_EXTENSION_NAME)) {
+        m_instance_extension_names.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    } else {
+        printf("%s Debug Utils Extension not supported, skipping test\n", kSkipPrefix);
+        return;
+    }
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor));
+    ASSERT_NO_FATAL_FAILURE(InitState());
+
+    PFN_vkCreateDebugUtilsMessengerEXT fpvkCreateDebugUtilsMessengerEXT =
+        (PFN_vkCreateDebugUtilsMessengerEXT)vk::GetInstanceProcAddr(instance(), "vkCreateDebugUtilsMessengerEXT");
+    ASSERT_TRUE(fpvkCreateDebugUtilsMessengerEXT);  // Must be extant if extension is enabled
+    PFN_vkDestroyDebugUtilsMessengerEXT fpvkDestroyDebugUtilsMessengerEXT =
+        (PFN_vkDestroyDebugUtilsMessengerEXT)vk::GetInstanceProcAddr(instance(), "vkDestroyDebugUtilsMessengerEXT");
+    ASSERT_TRUE(fpvkDestroyDebugUtilsMessengerEXT);  // Must be extant if extension is enabled
+
+    std::atomic<uint32_t> collisions(0);
+    auto callback_create_info = lvl_init_struct<VkDebugUtilsMessengerCreateInfoEXT>();
+    callback_create_info.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    callback_create_info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT;
+    callback_create_info.pfnUserCallback = CountThreadingErrors;
+    callback_create_info.pUserData = &collisions;
+    VkDebugUtilsMessengerEXT my_messenger = VK_NULL_HANDLE;
+    fpvkCreateDebugUtilsMessengerEXT(instance(), &callback_create_info, nullptr, &my_messenger);
+
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "THREADING ERROR");
+    m_errorMonitor->SetAllowedFailureMsg("THREADING ERROR");  // Ignore any extra threading errors found beyond the first one
+
+    // Stop once every thread could have collided. Several waiters at once must not block each other, or the joins hang.
+    constexpr uint32_t thread_count = 4;
+    constexpr uint32_t max_calls_per_thread = 100000;
+    const VkQueue queue = m_device->m_queue;
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([queue, &collisions]() {
+            for (uint32_t call = 0; call < max_calls_per_thread && collisions < thread_count; ++call) {
+                vk::QueueWaitIdle(queue);
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+
+    m_errorMonitor->VerifyFound();
+    fpvkDestroyDebugUtilsMessengerEXT(instance(), my_messenger, nullptr);
+    ASSERT_GT(collisions.load(), 0u);
+}
 #endif  // GTEST_IS_THREADSAFE
 
 TEST_F(VkLayerTest, ExecuteUnrecordedPrimaryCB) {
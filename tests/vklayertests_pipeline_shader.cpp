@@ -3415,6 +3415,153 @@ TEST_F(VkLayerTest, CreatePipelineCheckShaderSpecializationApplied) {
     CreatePipelineHelper::OneshotTest(*this, set_info, kErrorBit, "does not contain valid spirv");
 }
 
+// The size of the array is a specialization constant, 0 makes the specialized module invalid
+static const char kSpecializationSizedArrayFs[] = R"(
+               OpCapability Shader
+          %1 = OpExtInstImport "GLSL.std.450"
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint Fragment %main "main"
+               OpExecutionMode %main OriginUpperLeft
+               OpSource GLSL 450
+               OpName %main "main"
+               OpName %size "size"
+               OpName %array "array"
+               OpDecorate %size SpecId 0
+       %void = OpTypeVoid
+          %3 = OpTypeFunction %void
+      %float = OpTypeFloat 32
+        %int = OpTypeInt 32 1
+       %size = OpSpecConstant %int 1
+%_arr_float_size = OpTypeArray %float %size
+%_ptr_Function__arr_float_size = OpTypePointer Function %_arr_float_size
+      %int_0 = OpConstant %int 0
+    %float_0 = OpConstant %float 0
+%_ptr_Function_float = OpTypePointer Function %float
+       %main = OpFunction %void None %3
+          %5 = OpLabel
+      %array = OpVariable %_ptr_Function__arr_float_size Function
+         %15 = OpAccessChain %_ptr_Function_float %array %int_0
+               OpStore %15 %float_0
+               OpReturn
+               OpFunctionEnd)";
+
+static void CreateSpecializedPipeline(VkLayerTest &test, const VkShaderObj &fs, uint32_t size) {
+    const VkSpecializationMapEntry entry = {0, 0, sizeof(uint32_t)};
+    const VkSpecializationInfo specialization_info = {1, &entry, sizeof(uint32_t), &size};
+    CreatePipelineHelper pipe(test);
+    pipe.InitInfo();
+    pipe.shader_stages_ = {pipe.vs_->GetStageCreateInfo(), fs.GetStageCreateInfo()};
+    pipe.shader_stages_[1].pSpecializationInfo = &specialization_info;
+    pipe.InitState();
+    pipe.CreateGraphicsPipeline();
+}
+
+TEST_F(VkLayerTest, LayerValidationCacheRevalidatesChangedPipelines) {
+    TEST_DESCRIPTION(
+        "Create pipelines that pass with the layer validation cache enabled, then on a device loading that cache change their "
+        "layout and specialization data so that they are invalid.");
+
+    const char *cache_path = "vk_layer_validation_cache_test.bin";
+    remove(cache_path);
+    ScopedEnvironmentVariable cache_path_env("VK_LAYER_VALIDATION_CACHE_PATH", cache_path);
+
+    char const *vsSource =
+        "#version 450\n"
+        "\n"
+        "layout (std140, set = 0, binding = 0) uniform buf {\n"
+        "    mat4 mvp;\n"
+        "} ubuf;\n"
+        "void main(){\n"
+        "   gl_Position = ubuf.mvp * vec4(1);\n"
+        "}\n";
+
+    // The first device writes the cache when destroyed, the second one starts from it
+    for (uint32_t run = 0; run < 2; ++run) {
+        ASSERT_NO_FATAL_FAILURE(Init());
+        ASSERT_NO_FATAL_FAILURE(InitRenderTarget());
+
+        VkShaderObj vs(m_device, vsSource, VK_SHADER_STAGE_VERTEX_BIT, this);
+        VkShaderObj fs(m_device, kSpecializationSizedArrayFs, VK_SHADER_STAGE_FRAGMENT_BIT, this);
+        const auto create_ubo_pipeline = [&](VkShaderStageFlags binding_stages) {
+            OneOffDescriptorSet ds(m_device, {
+                                                 {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, binding_stages, nullptr},
+                                             });
+            CreatePipelineHelper pipe(*this);
+            pipe.InitInfo();
+            pipe.shader_stages_ = {vs.GetStageCreateInfo(), pipe.fs_->GetStageCreateInfo()};
+            pipe.InitState();
+            pipe.pipeline_layout_ = VkPipelineLayoutObj(m_device, {&ds.layout_});
+            pipe.CreateGraphicsPipeline();
+        };
+
+        // Unchanged pipelines pass both times, the second time from the cache
+        m_errorMonitor->ExpectSuccess();
+        create_ubo_pipeline(VK_SHADER_STAGE_VERTEX_BIT);
+        CreateSpecializedPipeline(*this, fs, 1);
+        m_errorMonitor->VerifyNotFound();
+
+        if (run == 1) {
+            m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Shader uses descriptor slot 0.0 ");
+            create_ubo_pipeline(VK_SHADER_STAGE_FRAGMENT_BIT);
+            m_errorMonitor->VerifyFound();
+
+            m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "does not contain valid spirv");
+            CreateSpecializedPipeline(*this, fs, 0);
+            m_errorMonitor->VerifyFound();
+        }
+
+        ShutdownFramework();
+        if (run == 0) {
+            FILE *cache_file = fopen(cache_path, "rb");
+            ASSERT_TRUE(cache_file != nullptr) << "The validation cache was not written to " << cache_path;
+            fclose(cache_file);
+        }
+    }
+    remove(cache_path);
+}
+
+TEST_F(VkLayerTest, LayerValidationCacheSkipsOnlyCleanStages) {
+    TEST_DESCRIPTION(
+        "Create pipelines whose stages produce a warning or a specialization error twice with the layer validation cache "
+        "enabled, on one device and again on a device loading its cache, and make sure they are reported every time.");
+
+    const char *cache_path = "vk_layer_validation_cache_test.bin";
+    remove(cache_path);
+    ScopedEnvironmentVariable cache_path_env("VK_LAYER_VALIDATION_CACHE_PATH", cache_path);
+
+    char const *vsSource =
+        "#version 450\n"
+        "layout(location=0) out float x;\n"
+        "void main(){\n"
+        "   gl_Position = vec4(1);\n"
+        "   x = 0;\n"
+        "}\n";
+
+    for (uint32_t run = 0; run < 2; ++run) {
+        ASSERT_NO_FATAL_FAILURE(Init());
+        ASSERT_NO_FATAL_FAILURE(InitRenderTarget());
+
+        VkShaderObj vs(m_device, vsSource, VK_SHADER_STAGE_VERTEX_BIT, this);
+        VkShaderObj fs(m_device, kSpecializationSizedArrayFs, VK_SHADER_STAGE_FRAGMENT_BIT, this);
+        const auto set_info = [&](CreatePipelineHelper &helper) {
+            helper.shader_stages_ = {vs.GetStageCreateInfo(), helper.fs_->GetStageCreateInfo()};
+        };
+
+        for (uint32_t i = 0; i < 2; ++i) {
+            // A warning only, but the stage interface is still not clean
+            CreatePipelineHelper::OneshotTest(*this, set_info, kPerformanceWarningBit, "not consumed by fragment shader");
+
+            // The second one comes from the specialization memo
+            m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "does not contain valid spirv");
+            CreateSpecializedPipeline(*this, fs, 0);
+            m_errorMonitor->VerifyFound();
+        }
+
+        ShutdownFramework();
+    }
+    remove(cache_path);
+}
+
 TEST_F(VkLayerTest, CreatePipelineCheckShaderBadSpecializationOffsetOutOfBounds) {
     TEST_DESCRIPTION("Challenge core_validation with shader validation issues related to vkCreateGraphicsPipelines.");
 
@@ -3656,6 +3803,47 @@ TEST_F(VkLayerTest, CreateShaderModuleCheckBadCapability) {
     }
 }
 
+TEST_F(VkLayerTest, CreateShaderModuleBackgroundValidation) {
+    TEST_DESCRIPTION("Create an invalid shader module with background shader validation enabled, and destroy it unused");
+
+    VkLayerSettingValueDataEXT setting_string_value{};
+    setting_string_value.arrayString.pCharArray = "VALIDATION_CHECK_ENABLE_BACKGROUND_SHADER_VALIDATION";
+    setting_string_value.arrayString.count = sizeof(setting_string_value.arrayString.pCharArray);
+    VkLayerSettingValueEXT setting_val = {"enables", VK_LAYER_SETTING_VALUE_TYPE_STRING_ARRAY_EXT, setting_string_value};
+    VkLayerSettingsEXT layer_settings{static_cast<VkStructureType>(VK_STRUCTURE_TYPE_INSTANCE_LAYER_SETTINGS_EXT), nullptr, 1,
+                                      &setting_val};
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &layer_settings));
+    ASSERT_NO_FATAL_FAILURE(InitState());
+
+    const std::string spv_source = R"(
+                  OpCapability ImageRect
+                  OpEntryPoint Vertex %main "main"
+          %main = OpFunction %void None %3
+                  OpReturn
+                  OpFunctionEnd
+        )";
+
+    std::vector<unsigned int> spv;
+    ASMtoSPV(SPV_ENV_VULKAN_1_0, 0, spv_source.data(), spv);
+    VkShaderModuleCreateInfo module_create_info = {};
+    module_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    module_create_info.pCode = spv.data();
+    module_create_info.codeSize = spv.size() * sizeof(unsigned int);
+
+    // spirv-val runs on a worker thread, so creation itself reports nothing
+    VkShaderModule shader_module = VK_NULL_HANDLE;
+    m_errorMonitor->ExpectSuccess();
+    VkResult err = vk::CreateShaderModule(m_device->handle(), &module_create_info, NULL, &shader_module);
+    m_errorMonitor->VerifyNotFound();
+
+    // The result is reported against the module when it is first used, here when it is destroyed without ever being used
+    if (err == VK_SUCCESS) {
+        m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Capability ImageRect is not allowed by Vulkan");
+        vk::DestroyShaderModule(m_device->handle(), shader_module, NULL);
+        m_errorMonitor->VerifyFound();
+    }
+}
+
 TEST_F(VkLayerTest, CreatePipelineFragmentInputNotProvided) {
     TEST_DESCRIPTION(
         "Test that an error is produced for a fragment shader input which is not present in the outputs of the previous stage");
@@ -5184,6 +5372,160 @@ TEST_F(VkLayerTest, CreateComputePipelineMissingDescriptor) {
     m_errorMonitor->VerifyFound();
 }
 
+TEST_F(VkLayerTest, CreateComputePipelineMissingGroupDecoratedDescriptor) {
+    TEST_DESCRIPTION(
+        "Test that an error is produced for a compute pipeline consuming a descriptor whose set and binding come from a decoration "
+        "group, and which is not provided in the pipeline layout");
+
+    ASSERT_NO_FATAL_FAILURE(Init());
+
+    const std::string csSource = R"(
+               OpCapability Shader
+               OpMemoryModel Logical GLSL450
+               OpEntryPoint GLCompute %main "main"
+               OpExecutionMode %main LocalSize 1 1 1
+               OpDecorate %block BufferBlock
+               OpMemberDecorate %block 0 Offset 0
+               OpDecorate %group DescriptorSet 0
+               OpDecorate %group Binding 3
+      %group = OpDecorationGroup
+               OpGroupDecorate %group %var
+       %void = OpTypeVoid
+       %func = OpTypeFunction %void
+      %float = OpTypeFloat 32
+      %block = OpTypeStruct %float
+%_ptr_Uniform_block = OpTypePointer Uniform %block
+        %var = OpVariable %_ptr_Uniform_block Uniform
+        %int = OpTypeInt 32 1
+      %int_0 = OpConstant %int 0
+    %float_1 = OpConstant %float 1
+%_ptr_Uniform_float = OpTypePointer Uniform %float
+       %main = OpFunction %void None %func
+      %label = OpLabel
+     %member = OpAccessChain %_ptr_Uniform_float %var %int_0
+               OpStore %member %float_1
+               OpReturn
+               OpFunctionEnd
+        )";
+
+    CreateComputePipelineHelper pipe(*this);
+    pipe.InitInfo();
+    pipe.cs_.reset(new VkShaderObj(m_device, csSource, VK_SHADER_STAGE_COMPUTE_BIT, this));
+    pipe.InitState();
+    pipe.pipeline_layout_ = VkPipelineLayoutObj(m_device, {});
+    // The slot comes from the group, an undecorated variable would be reported at 0.0
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Shader uses descriptor slot 0.3");
+    pipe.CreateComputePipeline();
+    m_errorMonitor->VerifyFound();
+}
+
+TEST_F(VkLayerTest, CreateComputePipelinesParallelValidation) {
+    TEST_DESCRIPTION("Create a batch of compute pipelines, one of which is invalid, with parallel pipeline validation enabled");
+
+    VkLayerSettingValueDataEXT setting_string_value{};
+    setting_string_value.arrayString.pCharArray = "VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION";
+    setting_string_value.arrayString.count = sizeof(setting_string_value.arrayString.pCharArray);
+    VkLayerSettingValueEXT setting_val = {"enables", VK_LAYER_SETTING_VALUE_TYPE_STRING_ARRAY_EXT, setting_string_value};
+    VkLayerSettingsEXT layer_settings{static_cast<VkStructureType>(VK_STRUCTURE_TYPE_INSTANCE_LAYER_SETTINGS_EXT), nullptr, 1,
+                                      &setting_val};
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &layer_settings));
+    ASSERT_NO_FATAL_FAILURE(InitState());
+
+    char const *goodSource =
+        "#version 450\n"
+        "\n"
+        "layout(local_size_x=1) in;\n"
+        "void main(){\n"
+        "}\n";
+    char const *badSource =
+        "#version 450\n"
+        "\n"
+        "layout(local_size_x=1) in;\n"
+        "layout(set=0, binding=0) buffer block { vec4 x; };\n"
+        "void main(){\n"
+        "   x = vec4(1);\n"
+        "}\n";
+    VkShaderObj good_cs(m_device, goodSource, VK_SHADER_STAGE_COMPUTE_BIT, this);
+    VkShaderObj bad_cs(m_device, badSource, VK_SHADER_STAGE_COMPUTE_BIT, this);
+    VkPipelineLayoutObj pipeline_layout(m_device, {});
+
+    const uint32_t pipeline_count = 4;
+    VkComputePipelineCreateInfo pipeline_infos[pipeline_count] = {};
+    for (uint32_t i = 0; i < pipeline_count; i++) {
+        pipeline_infos[i].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipeline_infos[i].layout = pipeline_layout.handle();
+        pipeline_infos[i].basePipelineIndex = -1;
+        pipeline_infos[i].stage = good_cs.GetStageCreateInfo();
+    }
+    pipeline_infos[2].stage = bad_cs.GetStageCreateInfo();
+
+    VkPipeline pipelines[pipeline_count] = {};
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Shader uses descriptor slot 0.0");
+    vk::CreateComputePipelines(device(), VK_NULL_HANDLE, pipeline_count, pipeline_infos, nullptr, pipelines);
+    m_errorMonitor->VerifyFound();
+
+    // Without errors the batch is validated and created as usual
+    pipeline_infos[2].stage = good_cs.GetStageCreateInfo();
+    m_errorMonitor->ExpectSuccess();
+    VkResult err = vk::CreateComputePipelines(device(), VK_NULL_HANDLE, pipeline_count, pipeline_infos, nullptr, pipelines);
+    m_errorMonitor->VerifyNotFound();
+    ASSERT_VK_SUCCESS(err);
+    for (uint32_t i = 0; i < pipeline_count; i++) {
+        vk::DestroyPipeline(device(), pipelines[i], nullptr);
+    }
+}
+
+TEST_F(VkLayerTest, CreateComputePipelinesParallelValidationMultipleErrors) {
+    TEST_DESCRIPTION("Report every error of a pipeline validated on a worker thread, when the callback asks to skip the first");
+
+    VkLayerSettingValueDataEXT setting_string_value{};
+    setting_string_value.arrayString.pCharArray = "VALIDATION_CHECK_ENABLE_PARALLEL_PIPELINE_VALIDATION";
+    setting_string_value.arrayString.count = sizeof(setting_string_value.arrayString.pCharArray);
+    VkLayerSettingValueEXT setting_val = {"enables", VK_LAYER_SETTING_VALUE_TYPE_STRING_ARRAY_EXT, setting_string_value};
+    VkLayerSettingsEXT layer_settings{static_cast<VkStructureType>(VK_STRUCTURE_TYPE_INSTANCE_LAYER_SETTINGS_EXT), nullptr, 1,
+                                      &setting_val};
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &layer_settings));
+    ASSERT_NO_FATAL_FAILURE(InitState());
+
+    char const *goodSource =
+        "#version 450\n"
+        "\n"
+        "layout(local_size_x=1) in;\n"
+        "void main(){\n"
+        "}\n";
+    char const *badSource =
+        "#version 450\n"
+        "\n"
+        "layout(local_size_x=1) in;\n"
+        "layout(set=0, binding=0) buffer block0 { vec4 x; };\n"
+        "layout(set=0, binding=1) buffer block1 { vec4 y; };\n"
+        "void main(){\n"
+        "   x = vec4(1);\n"
+        "   y = vec4(1);\n"
+        "}\n";
+    VkShaderObj good_cs(m_device, goodSource, VK_SHADER_STAGE_COMPUTE_BIT, this);
+    VkShaderObj bad_cs(m_device, badSource, VK_SHADER_STAGE_COMPUTE_BIT, this);
+    VkPipelineLayoutObj pipeline_layout(m_device, {});
+
+    const uint32_t pipeline_count = 4;
+    VkComputePipelineCreateInfo pipeline_infos[pipeline_count] = {};
+    for (uint32_t i = 0; i < pipeline_count; i++) {
+        pipeline_infos[i].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipeline_infos[i].layout = pipeline_layout.handle();
+        pipeline_infos[i].basePipelineIndex = -1;
+        pipeline_infos[i].stage = good_cs.GetStageCreateInfo();
+    }
+    pipeline_infos[1].stage = bad_cs.GetStageCreateInfo();
+
+    // The test callback returns VK_TRUE for the first error, so the second comes from validating the pipeline again on the
+    // calling thread
+    VkPipeline pipelines[pipeline_count] = {};
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Shader uses descriptor slot 0.0");
+    m_errorMonitor->SetDesiredFailureMsg(kErrorBit, "Shader uses descriptor slot 0.1");
+    vk::CreateComputePipelines(device(), VK_NULL_HANDLE, pipeline_count, pipeline_infos, nullptr, pipelines);
+    m_errorMonitor->VerifyFound();
+}
+
 TEST_F(VkLayerTest, CreateComputePipelineDescriptorTypeMismatch) {
     TEST_DESCRIPTION("Test that an error is produced for a pipeline consuming a descriptor-backed resource of a mismatched type");
 
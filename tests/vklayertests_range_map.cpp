@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2020 The Khronos Group Inc.
+ * Copyright (c) 2020 Valve Corporation
+ * Copyright (c) 2020 LunarG, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// The flat_btree_map backend of range_map is checked against the std::map one, which it has to behave exactly like. These
+// don't use a device.
+
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "range_vector.h"
+
+namespace {
+using Range = sparse_container::range<uint64_t>;
+using StdRangeMap = sparse_container::range_map<uint64_t, uint32_t>;
+// Small leaves, so that a few dozen entries already take leaf splits and merges
+using FlatRangeMap = sparse_container::range_map<uint64_t, uint32_t, Range, sparse_container::flat_btree_map<Range, uint32_t, 4>>;
+using DefaultFlatRangeMap = sparse_container::flat_range_map<uint64_t, uint32_t>;
+
+using Entries = std::vector<std::tuple<uint64_t, uint64_t, uint32_t>>;
+
+template <typename Map>
+Entries GetEntries(const Map &map) {
+    Entries entries;
+    for (const auto &entry : map) {
+        entries.emplace_back(entry.first.begin, entry.first.end, entry.second);
+    }
+    return entries;
+}
+
+template <typename Map>
+Entries GetEntriesReversed(const Map &map) {
+    Entries entries;
+    auto pos = map.end();
+    while (pos != map.begin()) {
+        --pos;
+        entries.emplace_back(pos->first.begin, pos->first.end, pos->second);
+    }
+    return Entries(entries.rbegin(), entries.rend());
+}
+
+// The entry an iterator refers to, or a sentinel for end()
+template <typename Map>
+std::tuple<uint64_t, uint64_t, uint32_t> GetEntry(Map &map, const typename Map::iterator &pos) {
+    if (pos == map.end()) return std::make_tuple(~uint64_t(0), ~uint64_t(0), ~uint32_t(0));
+    return std::make_tuple(pos->first.begin, pos->first.end, pos->second);
+}
+
+Range RandomRange(std::mt19937 &rng, uint64_t limit) {
+    const uint64_t begin = rng() % limit;
+    const uint64_t end = begin + 1 + rng() % 16;
+    return Range(begin, end);
+}
+
+template <typename Flat, typename SplitOp>
+void CompareSplit(StdRangeMap &std_map, const StdRangeMap::iterator &std_pos, Flat &flat_map,
+                  const typename Flat::iterator &flat_pos, uint64_t index, const SplitOp &split_op) {
+    const auto std_split = std_map.split(std_pos, index, split_op);
+    const auto flat_split = flat_map.split(flat_pos, index, split_op);
+    ASSERT_EQ(GetEntry(std_map, std_split), GetEntry(flat_map, flat_split));
+}
+
+// Applies the same random operations to both maps, comparing what each returns, and every so many operations what they hold
+template <typename Flat>
+void RunDifferentialOperations(uint32_t seed, uint32_t op_count, uint64_t limit, uint32_t compare_interval) {
+    std::mt19937 rng(seed);
+    StdRangeMap std_map;
+    Flat flat_map;
+    for (uint32_t op = 0; op < op_count; ++op) {
+        const Range range = RandomRange(rng, limit);
+        const uint32_t value = rng() % 4;
+        switch (rng() % 6) {
+            case 0: {
+                const auto std_insert = std_map.insert(std::make_pair(range, value));
+                const auto flat_insert = flat_map.insert(std::make_pair(range, value));
+                ASSERT_EQ(std_insert.second, flat_insert.second) << "insert, op " << op;
+                ASSERT_EQ(GetEntry(std_map, std_insert.first), GetEntry(flat_map, flat_insert.first)) << "insert, op " << op;
+                break;
+            }
+            case 1: {
+                const auto std_insert = std_map.insert(std_map.lower_bound(range), std::make_pair(range, value));
+                const auto flat_insert = flat_map.insert(flat_map.lower_bound(range), std::make_pair(range, value));
+                ASSERT_EQ(GetEntry(std_map, std_insert), GetEntry(flat_map, flat_insert)) << "hinted insert, op " << op;
+                break;
+            }
+            case 2:
+            case 3: {
+                const auto std_pos = std_map.overwrite_range(std::make_pair(range, value));
+                const auto flat_pos = flat_map.overwrite_range(std::make_pair(range, value));
+                ASSERT_EQ(GetEntry(std_map, std_pos), GetEntry(flat_map, flat_pos)) << "overwrite_range, op " << op;
+                break;
+            }
+            case 4: {
+                const auto std_pos = std_map.erase_range(range);
+                const auto flat_pos = flat_map.erase_range(range);
+                ASSERT_EQ(GetEntry(std_map, std_pos), GetEntry(flat_map, flat_pos)) << "erase_range, op " << op;
+                break;
+            }
+            case 5: {
+                const auto std_pos = std_map.find(range.begin);
+                const auto flat_pos = flat_map.find(range.begin);
+                ASSERT_EQ(GetEntry(std_map, std_pos), GetEntry(flat_map, flat_pos)) << "find, op " << op;
+                if (std_pos == std_map.end()) break;
+                const uint64_t index = std_pos->first.begin + rng() % (std_pos->first.end - std_pos->first.begin);
+                switch (rng() % 3) {
+                    case 0:
+                        CompareSplit(std_map, std_pos, flat_map, flat_pos, index, sparse_container::split_op_keep_both());
+                        break;
+                    case 1:
+                        CompareSplit(std_map, std_pos, flat_map, flat_pos, index, sparse_container::split_op_keep_lower());
+                        break;
+                    default:
+                        CompareSplit(std_map, std_pos, flat_map, flat_pos, index, sparse_container::split_op_keep_upper());
+                        break;
+                }
+                ASSERT_FALSE(::testing::Test::HasFatalFailure()) << "split, op " << op;
+                break;
+            }
+        }
+        ASSERT_EQ(std_map.size(), flat_map.size()) << "op " << op;
+        if (op % compare_interval == 0) {
+            ASSERT_EQ(GetEntries(std_map), GetEntries(flat_map)) << "op " << op;
+        }
+
+        const Range query = RandomRange(rng, limit);
+        ASSERT_EQ(GetEntry(std_map, std_map.lower_bound(query)), GetEntry(flat_map, flat_map.lower_bound(query))) << "op " << op;
+        ASSERT_EQ(GetEntry(std_map, std_map.upper_bound(query)), GetEntry(flat_map, flat_map.upper_bound(query))) << "op " << op;
+    }
+    ASSERT_EQ(GetEntries(std_map), GetEntries(flat_map));
+    ASSERT_EQ(GetEntries(std_map), GetEntriesReversed(flat_map));
+    const Flat flat_copy(flat_map);
+    ASSERT_EQ(GetEntries(std_map), GetEntries(flat_copy));
+}
+}  // namespace
+
+TEST(RangeMapTest, FlatBackendMatchesStdMap) {
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+        RunDifferentialOperations<FlatRangeMap>(seed, 2000, 512, 1);
+        if (::testing::Test::HasFatalFailure()) return;
+    }
+    // Mostly inserts and overwrites into a wide space, for maps of many default sized leaves
+    RunDifferentialOperations<DefaultFlatRangeMap>(9, 20000, 1 << 16, 1000);
+}
+
+TEST(RangeMapTest, FlatBackendIteratorsSurviveOtherChanges) {
+    FlatRangeMap map;
+    for (uint64_t i = 0; i < 64; i += 2) {
+        map.insert(std::make_pair(Range(i * 10, i * 10 + 5), static_cast<uint32_t>(i)));
+    }
+    auto held = map.find(Range(300, 305));
+    ASSERT_TRUE(held != map.end());
+
+    // Inserting before the held entry splits its leaf and moves it
+    for (uint64_t i = 1; i < 30; i += 2) {
+        map.insert(std::make_pair(Range(i * 10, i * 10 + 5), static_cast<uint32_t>(i)));
+    }
+    EXPECT_EQ(300u, held->first.begin);
+    EXPECT_EQ(30u, held->second);
+
+    // As does erasing the entries before it
+    map.erase_range(Range(0, 200));
+    EXPECT_EQ(300u, held->first.begin);
+    auto prev = held;
+    --prev;
+    EXPECT_EQ(290u, prev->first.begin);
+    ++prev;
+    EXPECT_TRUE(prev == held);
+
+    // end() stays decrementable to the last entry
+    auto last = map.end();
+    map.insert(std::make_pair(Range(1000, 1005), 100u));
+    --last;
+    EXPECT_EQ(1000u, last->first.begin);
+}
@@ -27,12 +27,14 @@
 #include "layer_validation_tests.h"
 
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
 #include <thread>
 
 #include "cast_utils.h"
+#include "vk_layer_utils.h"
 
 //
 // POSITIVE VALIDATION TESTS
@@ -9505,6 +9507,134 @@ TEST_F(VkPositiveLayerTest, QueueThreading) {
     vk::QueueWaitIdle(queue_h);
 }
 
+TEST_F(VkPositiveLayerTest, MultithreadedCommandBufferRecording) {
+    TEST_DESCRIPTION(
+        "Record draws into separate command buffers from several threads with fine grained locking enabled, each executing "
+        "the same simultaneous use secondary, and submit them");
+
+    using std::thread;
+
+    VkLayerSettingValueDataEXT fg_setting_string_value{};
+    fg_setting_string_value.arrayString.pCharArray = "VALIDATION_CHECK_ENABLE_FINE_GRAINED_LOCKING";
+    fg_setting_string_value.arrayString.count = sizeof(fg_setting_string_value.arrayString.pCharArray);
+    VkLayerSettingValueEXT fg_setting_val = {"enables", VK_LAYER_SETTING_VALUE_TYPE_STRING_ARRAY_EXT, fg_setting_string_value};
+    VkLayerSettingsEXT fg_settings{static_cast<VkStructureType>(VK_STRUCTURE_TYPE_INSTANCE_LAYER_SETTINGS_EXT), nullptr, 1,
+                                   &fg_setting_val};
+    ASSERT_NO_FATAL_FAILURE(InitFramework(m_errorMonitor, &fg_settings));
+    ASSERT_NO_FATAL_FAILURE(InitState());
+    ASSERT_NO_FATAL_FAILURE(InitRenderTarget());
+
+    CreatePipelineHelper pipe(*this);
+    pipe.InitInfo();
+    pipe.InitState();
+    pipe.CreateGraphicsPipeline();
+
+    constexpr uint32_t thread_count = 4;
+    constexpr uint32_t draws_per_thread = 500;
+    const auto queue_family = m_device->graphics_queue_node_index_;
+
+    m_errorMonitor->ExpectSuccess();
+
+    // Every primary links itself to this secondary, so the recording threads all update its state
+    VkCommandPoolObj secondary_pool(m_device, queue_family);
+    VkCommandBufferObj secondary(m_device, &secondary_pool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    VkCommandBufferInheritanceInfo cbii = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+    VkCommandBufferBeginInfo secondary_begin = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr,
+                                                VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT, &cbii};
+    secondary.begin(&secondary_begin);
+    secondary.end();
+
+    // Command pools are externally synchronized, so each thread records from its own
+    std::vector<std::unique_ptr<VkCommandPoolObj>> pools;
+    std::vector<std::unique_ptr<VkCommandBufferObj>> command_buffers;
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        pools.emplace_back(new VkCommandPoolObj(m_device, queue_family));
+        command_buffers.emplace_back(new VkCommandBufferObj(m_device, pools.back().get()));
+    }
+
+    const auto &record = [&](VkCommandBufferObj *command_buffer) {
+        command_buffer->begin();
+        vk::CmdExecuteCommands(command_buffer->handle(), 1, &secondary.handle());
+        command_buffer->BeginRenderPass(m_renderPassBeginInfo);
+        vk::CmdBindPipeline(command_buffer->handle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipe.pipeline_);
+        for (uint32_t i = 0; i < draws_per_thread; ++i) {
+            command_buffer->Draw(3, 1, 0, 0);
+        }
+        command_buffer->EndRenderPass();
+        command_buffer->end();
+    };
+
+    std::vector<thread> threads;
+    for (auto &command_buffer : command_buffers) {
+        threads.emplace_back(record, command_buffer.get());
+    }
+    for (auto &t : threads) t.join();
+
+    std::vector<VkCommandBuffer> handles;
+    for (const auto &command_buffer : command_buffers) {
+        handles.push_back(command_buffer->handle());
+    }
+    VkSubmitInfo submit_info = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submit_info.commandBufferCount = static_cast<uint32_t>(handles.size());
+    submit_info.pCommandBuffers = handles.data();
+    ASSERT_VK_SUCCESS(vk::QueueSubmit(m_device->m_queue, 1, &submit_info, VK_NULL_HANDLE));
+    ASSERT_VK_SUCCESS(vk::QueueWaitIdle(m_device->m_queue));
+    m_errorMonitor->VerifyNotFound();
+}
+
+TEST_F(VkPositiveLayerTest, ConcurrentFlatMapChurn) {
+    TEST_DESCRIPTION("Look up vl_concurrent_flat_map entries while other threads insert and erase enough keys to force rehashes");
+
+    constexpr uint64_t shared_count = 1000;
+    constexpr uint64_t churn_base = uint64_t(1) << 32;
+    constexpr uint64_t churn_keys = 5000;
+    vl_concurrent_flat_map<uint64_t, uint64_t> map;
+    for (uint64_t key = 1; key <= shared_count; ++key) {
+        map.insert(key, key * 3);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> wrong(0);
+    std::vector<std::thread> readers;
+    for (uint64_t r = 0; r < 4; ++r) {
+        readers.emplace_back([&, r]() {
+            // Hints are shared between keys and go stale with the erases and rehashes, which must only cost a probe
+            vl_concurrent_flat_map<uint64_t, uint64_t>::FindHint hints[16];
+            for (uint64_t i = r; !done.load(); ++i) {
+                // Shared keys are never erased, and a churned key must never return another key's value
+                const auto shared = map.find(i % shared_count + 1);
+                if (shared == map.end() || shared->second != (i % shared_count + 1) * 3) wrong.fetch_add(1);
+                const auto hinted_shared = map.find(i % shared_count + 1, &hints[i % 16]);
+                if (hinted_shared == map.end() || hinted_shared->second != (i % shared_count + 1) * 3) wrong.fetch_add(1);
+                const uint64_t churned_key = churn_base + i % churn_keys;
+                const auto churned = map.find(churned_key);
+                if (churned != map.end() && churned->second != churned_key) wrong.fetch_add(1);
+                const auto hinted_churned = map.find(churned_key, &hints[(i + 8) % 16]);
+                if (hinted_churned != map.end() && hinted_churned->second != churned_key) wrong.fetch_add(1);
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (uint64_t w = 0; w < 2; ++w) {
+        writers.emplace_back([&, w]() {
+            for (uint64_t i = 0; i < 50000; ++i) {
+                const uint64_t key = churn_base + (2 * i + w) % churn_keys;
+                map.insert(key, key);
+                map.erase(key);
+            }
+        });
+    }
+    for (auto &t : writers) t.join();
+    done.store(true);
+    for (auto &t : readers) t.join();
+
+    EXPECT_EQ(wrong.load(), 0u);
+    EXPECT_EQ(map.size(), shared_count);
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.find(1) == map.end());
+}
+
 TEST_F(VkPositiveLayerTest, SwapchainImageFormatProps) {
     TEST_DESCRIPTION("Try using special format props on a swapchain image");
 